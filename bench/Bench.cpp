@@ -0,0 +1,544 @@
+/*
+ * Copyright (C) 2025. Nyabsi <nyabsi@sovellus.cc>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cmath>
+#include <cstring>
+#include <iterator>
+#include <new>
+#include <vector>
+
+#include <imgui.h>
+#include <backends/imgui_impl_vulkan.h>
+
+#include <openvr.h>
+
+#include "VulkanRenderer.h"
+#include "VulkanUtils.h"
+#include "ImGuiOverlayWindow.h"
+
+#include "VrOverlay.h"
+#include "VrUtils.h"
+#include "VrPoseService.h"
+
+#include "Profiler.h"
+#include "FramePacer.h"
+#include "ImDrawDataCapture.h"
+#include "MockOpenVR.h"
+
+#include "backends/imgui_impl_openvr.h"
+
+#define BENCH_KEY       "github.VulkanOverlayExample.bench"
+#define BENCH_NAME      "Vulkan Overlay Benchmark"
+
+#define BENCH_WIDTH     1280
+#define BENCH_HEIGHT    720
+
+// Frames rendered before measuring so pipeline creation and the font upload are not counted
+#define BENCH_WARMUP_FRAMES 60
+
+// Refresh rate the pacing scenes tell the pacer, the simulated compositor may run at another one
+#define BENCH_REFRESH_RATE  90.0f
+
+// Every heap allocation the renderer and ImGui make on the measured frames lands in here, Vulkan
+// driver allocations are not visible to us.
+static std::atomic<uint64_t> g_allocations = 0;
+
+void* operator new(size_t size)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* pointer = malloc(size > 0 ? size : 1))
+        return pointer;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept
+{
+    free(pointer);
+}
+
+void operator delete(void* pointer, [[maybe_unused]] size_t size) noexcept
+{
+    free(pointer);
+}
+
+static auto CountingAlloc(size_t size, [[maybe_unused]] void* user_data) -> void*
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    return malloc(size);
+}
+
+static auto CountingFree(void* pointer, [[maybe_unused]] void* user_data) -> void
+{
+    free(pointer);
+}
+
+struct BenchScene
+{
+    const char* name;
+    // Queues this frame's scripted input on the mock runtime
+    void (*input)(vr::VROverlayHandle_t handle, uint32_t frame);
+    // Builds the ImGui frame and returns its draw data
+    ImDrawData* (*draw)(ImGuiOverlayWindow* window, uint32_t frame);
+    // Feeds the overlay from mock event streams at --event-rate on top of the scripted input
+    bool event_streams;
+};
+
+struct BenchResult
+{
+    uint32_t frames;
+    double seconds;
+    double cpu_mean_ms;
+    double cpu_p99_ms;
+    double gpu_ms;      // overlay pass of a submitted frame, negative without GPU timings
+    double allocations_per_frame;
+    MockOpenVRStats openvr_stats;
+    ImGui_ImplOpenVR_InputStats input_stats;    // over the measured frames only
+    Vulkan_RenderStats render_stats;
+};
+
+static auto NoInput([[maybe_unused]] vr::VROverlayHandle_t handle, [[maybe_unused]] uint32_t frame) -> void
+{
+}
+
+// Sweeps the laser over the overlay like a hand would, with a click every 45 frames and a scroll every 15
+static auto SweepInput(vr::VROverlayHandle_t handle, uint32_t frame) -> void
+{
+    const float angle = static_cast<float>(frame) * 0.05f;
+    const float x = BENCH_WIDTH * (0.5f + 0.35f * std::cos(angle));
+    const float y = BENCH_HEIGHT * (0.5f + 0.35f * std::sin(angle * 1.3f));
+
+    MockOpenVR::QueueMouseMove(handle, x, y);
+
+    if (frame % 45 == 0)
+        MockOpenVR::QueueMouseButton(handle, vr::VRMouseButton_Left, true);
+    if (frame % 45 == 1)
+        MockOpenVR::QueueMouseButton(handle, vr::VRMouseButton_Left, false);
+    if (frame % 15 == 0)
+        MockOpenVR::QueueScroll(handle, 0.0f, (frame / 15) % 2 == 0 ? 1.0f : -1.0f);
+}
+
+static auto DrawApplication(ImGuiOverlayWindow* window, [[maybe_unused]] uint32_t frame) -> ImDrawData*
+{
+    window->Draw();
+    return ImGui::GetDrawData();
+}
+
+// A dense table and a plot that change every frame, the worst case for the overlay's damage tracking
+static auto DrawStress([[maybe_unused]] ImGuiOverlayWindow* window, uint32_t frame) -> ImDrawData*
+{
+    ImGui_ImplVulkan_NewFrame();
+    ImGui_ImplOpenVR_NewFrame();
+    ImGui::NewFrame();
+
+    ImGuiIO& io = ImGui::GetIO();
+
+    ImGui::SetNextWindowPos(ImVec2(0.0f, 0.0f));
+    ImGui::SetNextWindowSize(io.DisplaySize);
+    ImGui::Begin("Stress", nullptr, ImGuiWindowFlags_NoDecoration);
+
+    float wave[256] = {};
+    for (int i = 0; i < IM_ARRAYSIZE(wave); i++)
+        wave[i] = std::sin(static_cast<float>(frame + i) * 0.1f);
+
+    ImGui::PlotLines("##wave", wave, IM_ARRAYSIZE(wave), 0, nullptr, -1.0f, 1.0f, ImVec2(-1.0f, 120.0f));
+
+    if (ImGui::BeginTable("##rows", 4, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_ScrollY)) {
+        for (int row = 0; row < 200; row++) {
+            ImGui::PushID(row);
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::Text("Row %d", row);
+            ImGui::TableNextColumn();
+            ImGui::ProgressBar(std::fmod(static_cast<float>(frame + row) * 0.01f, 1.0f), ImVec2(-1.0f, 0.0f));
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", wave[(frame + row) % IM_ARRAYSIZE(wave)]);
+            ImGui::TableNextColumn();
+            ImGui::SmallButton("Select");
+            ImGui::PopID();
+        }
+        ImGui::EndTable();
+    }
+
+    ImGui::End();
+    ImGui::Render();
+
+    return ImGui::GetDrawData();
+}
+
+// Frames recorded with the capture button of the example, no ImGui code runs at all
+static ImDrawDataCaptureReader g_replay = {};
+
+static auto DrawReplay([[maybe_unused]] ImGuiOverlayWindow* window, [[maybe_unused]] uint32_t frame) -> ImDrawData*
+{
+    return g_replay.NextFrame();
+}
+
+static constexpr BenchScene BENCH_SCENES[] =
+{
+    { .name = "idle", .input = NoInput, .draw = DrawApplication, .event_streams = false },
+    { .name = "interactive", .input = SweepInput, .draw = DrawApplication, .event_streams = false },
+    { .name = "stress", .input = SweepInput, .draw = DrawStress, .event_streams = false },
+    { .name = "event_flood", .input = NoInput, .draw = DrawApplication, .event_streams = true },
+};
+
+static constexpr BenchScene BENCH_REPLAY_SCENE = { .name = "replay", .input = NoInput, .draw = DrawReplay, .event_streams = false };
+
+// Pacing runs against SimulatedFrameClock, simulated time only moves through the pacer's sleeps and the
+// frame work, so these scenes take no wall clock time and always give the same numbers.
+struct PacingScene
+{
+    const char* name;
+    bool frame_sync;        // the simulated compositor answers WaitFrameSync
+    bool vsync_timing;      // and GetTimeSinceLastVsync
+    double compositor_hz;
+    double work_ms;         // time each frame takes to build and submit
+    uint32_t spike_interval;// every spike_interval-th frame takes spike_ms instead, 0 for never
+    double spike_ms;
+};
+
+struct PacingResult
+{
+    uint32_t frames;
+    FramePacerMode mode;
+    uint64_t missed_frames; // compositor frames without a frame of ours, seen from the compositor
+    uint64_t early_frames;  // frames that landed in the same compositor frame as the previous one
+    double phase_error_ms;  // mean distance from the requested phase the pacer measured
+    FramePacerStats pacer_stats;
+};
+
+static constexpr PacingScene PACING_SCENES[] =
+{
+    { .name = "pace_sync", .frame_sync = true, .vsync_timing = true, .compositor_hz = 90.0, .work_ms = 4.0, .spike_interval = 0, .spike_ms = 0.0 },
+    { .name = "pace_vsync", .frame_sync = false, .vsync_timing = true, .compositor_hz = 90.0, .work_ms = 4.0, .spike_interval = 0, .spike_ms = 0.0 },
+    { .name = "pace_spikes", .frame_sync = false, .vsync_timing = true, .compositor_hz = 90.0, .work_ms = 4.0, .spike_interval = 45, .spike_ms = 15.0 },
+    { .name = "pace_pll", .frame_sync = false, .vsync_timing = false, .compositor_hz = 90.0, .work_ms = 4.0, .spike_interval = 0, .spike_ms = 0.0 },
+    // The compositor runs slower than the refresh rate the pacer was given, a PLL without vsync can't notice
+    { .name = "pace_drift", .frame_sync = false, .vsync_timing = false, .compositor_hz = 89.0, .work_ms = 4.0, .spike_interval = 0, .spike_ms = 0.0 },
+};
+
+static auto FramePacerModeName(FramePacerMode mode) -> const char*
+{
+    switch (mode) {
+    case FramePacerMode_FrameSync:
+        return "frame sync";
+    case FramePacerMode_VsyncTiming:
+        return "vsync";
+    case FramePacerMode_PLL:
+        return "pll";
+    }
+
+    return "?";
+}
+
+static auto RunPacing(const PacingScene& scene, uint32_t frame_count) -> PacingResult
+{
+    SimulatedFrameClock clock(static_cast<uint64_t>(1e9 / scene.compositor_hz), scene.frame_sync, scene.vsync_timing);
+    FramePacer pacer(clock);
+    pacer.SetRefreshRate(BENCH_REFRESH_RATE);
+
+    PacingResult result = {
+        .frames = frame_count,
+        .mode = FramePacerMode_PLL,
+        .missed_frames = 0,
+        .early_frames = 0,
+        .phase_error_ms = 0.0,
+        .pacer_stats = {},
+    };
+
+    uint64_t last_compositor_frame = {};
+    double phase_error_total = {};
+
+    for (uint32_t frame = 0; frame < frame_count; frame++) {
+        pacer.Wait();
+
+        // The compositor frame this one is shown in, counted the same way for every mode
+        const uint64_t compositor_frame = clock.FrameCounter();
+        if (frame > 0) {
+            if (compositor_frame == last_compositor_frame)
+                result.early_frames++;
+            else if (compositor_frame > last_compositor_frame + 1)
+                result.missed_frames += compositor_frame - last_compositor_frame - 1;
+        }
+        last_compositor_frame = compositor_frame;
+        phase_error_total += std::abs(pacer.Stats().phase_error_ms);
+
+        const bool spike = scene.spike_interval > 0 && frame % scene.spike_interval == scene.spike_interval - 1;
+        clock.Advance(static_cast<uint64_t>((spike ? scene.spike_ms : scene.work_ms) * 1e6));
+    }
+
+    result.mode = pacer.Stats().mode;
+    result.phase_error_ms = phase_error_total / frame_count;
+    result.pacer_stats = pacer.Stats();
+
+    return result;
+}
+
+static auto RunFrame(const BenchScene& scene, uint32_t frame, VulkanRenderer* renderer, ImGuiOverlayWindow* window, VrOverlay*& overlay) -> void
+{
+    scene.input(overlay->Handle(), frame);
+
+    vr::VREvent_t vr_event = {};
+    while (vr::VROverlay()->PollNextOverlayEvent(overlay->Handle(), &vr_event, sizeof(vr_event))) {
+        overlay->ProcessEvent(vr_event);
+        ImGui_ImplOpenVR_ProcessOverlayEvent(vr_event);
+    }
+
+    VrPoseService::BeginFrame();
+
+    ImDrawData* draw_data = scene.draw(window, frame);
+    renderer->RenderOverlay(draw_data, overlay);
+}
+
+// Mostly mouse moves like a laser pointer produces them, with scrolling, typing and property changes mixed in
+static auto AddEventStreams(vr::VROverlayHandle_t handle, double event_rate) -> void
+{
+    MockOpenVR::AddEventStream(handle, { .type = MockEventStream_MouseMove, .rate_hz = event_rate * 0.85, .width = BENCH_WIDTH, .height = BENCH_HEIGHT });
+    MockOpenVR::AddEventStream(handle, { .type = MockEventStream_Scroll, .rate_hz = event_rate * 0.1, .width = 0.0f, .height = 0.0f });
+    MockOpenVR::AddEventStream(handle, { .type = MockEventStream_Keyboard, .rate_hz = event_rate * 0.04, .width = 0.0f, .height = 0.0f });
+    MockOpenVR::AddEventStream(handle, { .type = MockEventStream_PropertyChanged, .rate_hz = event_rate * 0.01, .width = 0.0f, .height = 0.0f });
+}
+
+static auto RunScene(const BenchScene& scene, uint32_t frame_count, double event_rate, VulkanRenderer* renderer, ImGuiOverlayWindow* window, VrOverlay*& overlay) -> BenchResult
+{
+    if (scene.event_streams)
+        AddEventStreams(overlay->Handle(), event_rate);
+
+    for (uint32_t frame = 0; frame < BENCH_WARMUP_FRAMES; frame++)
+        RunFrame(scene, frame, renderer, window, overlay);
+
+    std::vector<double> frame_ms(frame_count);
+
+    renderer->ResetStats();
+    MockOpenVR::ResetStats();
+    const ImGui_ImplOpenVR_InputStats input_begin = ImGui_ImplOpenVR_GetInputStats();
+
+    const uint64_t allocations_begin = g_allocations.load(std::memory_order_relaxed);
+    const uint64_t scene_begin = Profiler::Now();
+
+    for (uint32_t frame = 0; frame < frame_count; frame++) {
+        const uint64_t frame_begin = Profiler::Now();
+        RunFrame(scene, BENCH_WARMUP_FRAMES + frame, renderer, window, overlay);
+        frame_ms[frame] = static_cast<double>(Profiler::Now() - frame_begin) / 1e6;
+    }
+
+    const uint64_t scene_end = Profiler::Now();
+
+    MockOpenVR::ClearEventStreams(overlay->Handle());
+    const uint64_t allocations = g_allocations.load(std::memory_order_relaxed) - allocations_begin;
+
+    BenchResult result = {
+        .frames = frame_count,
+        .seconds = static_cast<double>(scene_end - scene_begin) / 1e9,
+        .cpu_mean_ms = 0.0,
+        .cpu_p99_ms = 0.0,
+        .gpu_ms = -1.0,
+        .allocations_per_frame = static_cast<double>(allocations) / frame_count,
+        .openvr_stats = MockOpenVR::Stats(),
+        .input_stats = ImGui_ImplOpenVR_GetInputStats(),
+        .render_stats = renderer->Stats(),
+    };
+
+    result.input_stats.events_received -= input_begin.events_received;
+    result.input_stats.events_forwarded -= input_begin.events_forwarded;
+
+    double sum = {};
+    for (double ms : frame_ms)
+        sum += ms;
+
+    std::sort(frame_ms.begin(), frame_ms.end());
+    result.cpu_mean_ms = sum / frame_count;
+    result.cpu_p99_ms = frame_ms[std::min<size_t>(static_cast<size_t>(std::ceil(frame_count * 0.99)), frame_count) - 1];
+
+    const auto gpu_timings = renderer->GpuTimings();
+    if (gpu_timings[Vulkan_GpuSection_OverlayPass].samples > 0)
+        result.gpu_ms = gpu_timings[Vulkan_GpuSection_OverlayPass].mean_ms;
+
+    return result;
+}
+
+static auto PrintUsage(const char* executable) -> void
+{
+    printf("Usage: %s [--frames N] [--scene NAME] [--vr-latency-us N] [--event-rate N] [--vr-calls] [--replay FILE]\n\n", executable);
+    printf("  --vr-latency-us N   every OpenVR call takes N microseconds like the IPC round trip to vrserver would\n");
+    printf("  --event-rate N      events per second the event_flood scene generates, 5000 by default\n");
+    printf("  --vr-calls          list the OpenVR methods called during each scene\n");
+    printf("  --replay FILE       only run the replay scene, which renders the frames of a draw capture in a loop\n\nScenes:");
+    for (const BenchScene& scene : BENCH_SCENES)
+        printf(" %s", scene.name);
+    for (const PacingScene& scene : PACING_SCENES)
+        printf(" %s", scene.name);
+    printf("\n\nRun with VK_DRIVER_FILES pointing at lavapipe's ICD (lvp_icd.*.json) for numbers that do not depend on the GPU.\n");
+}
+
+int main(int argc, char** argv)
+{
+    uint32_t frame_count = 600;
+    const char* scene_filter = nullptr;
+    uint64_t vr_latency_ns = 0;
+    double event_rate = 5000.0;
+    bool print_vr_calls = false;
+    const char* replay_path = nullptr;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            frame_count = static_cast<uint32_t>(std::max(atoi(argv[++i]), 1));
+        }
+        else if (strcmp(argv[i], "--scene") == 0 && i + 1 < argc) {
+            scene_filter = argv[++i];
+        }
+        else if (strcmp(argv[i], "--vr-latency-us") == 0 && i + 1 < argc) {
+            vr_latency_ns = static_cast<uint64_t>(std::max(atoi(argv[++i]), 0)) * 1000;
+        }
+        else if (strcmp(argv[i], "--event-rate") == 0 && i + 1 < argc) {
+            event_rate = std::max(atof(argv[++i]), 0.0);
+        }
+        else if (strcmp(argv[i], "--vr-calls") == 0) {
+            print_vr_calls = true;
+        }
+        else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            replay_path = argv[++i];
+        }
+        else {
+            PrintUsage(argv[0]);
+            return strcmp(argv[i], "--help") == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+
+    if (replay_path != nullptr && (!g_replay.Open(replay_path) || g_replay.FrameCount() == 0)) {
+        printf("Could not replay %s\n", replay_path);
+        return EXIT_FAILURE;
+    }
+
+    PROFILE_THREAD("Main");
+
+    // Must happen before ImGuiOverlayWindow creates the context
+    ImGui::SetAllocatorFunctions(CountingAlloc, CountingFree);
+
+    VulkanRenderer* renderer = new VulkanRenderer();
+    ImGuiOverlayWindow* window = new ImGuiOverlayWindow();
+    VrOverlay* overlay = new VrOverlay();
+
+    try {
+        OpenVRInit(vr::VRApplication_Background);
+
+        overlay->Create(vr::VROverlayType_Dashboard, BENCH_KEY, BENCH_NAME);
+        overlay->SetInputMethod(vr::VROverlayInputMethod_Mouse);
+
+        // The dashboard is open on our tab, RenderOverlay skips invisible overlays
+        MockOpenVR::SetDashboardVisible(true);
+        overlay->Show();
+    }
+    catch (std::exception& ex) {
+        printf("%s\n\n", ex.what());
+        return EXIT_FAILURE;
+    }
+
+    renderer->Initialize();
+    window->Initialize(renderer, overlay, BENCH_WIDTH, BENCH_HEIGHT);
+    renderer->SetupOverlay(BENCH_WIDTH, BENCH_HEIGHT, window->SurfaceFormat());
+
+    // Set after startup so only the measured frames pay for it
+    MockOpenVR::SetCallLatency(vr_latency_ns);
+
+    printf("\n%-12s %8s %10s %10s %10s %10s %13s %13s %10s %10s %12s\n", "scene", "frames", "fps", "cpu ms", "cpu p99", "gpu ms", "allocs/frame", "vr calls/f", "submits", "skipped", "rx/fwd /f");
+
+    std::vector<BenchScene> scenes(std::begin(BENCH_SCENES), std::end(BENCH_SCENES));
+    if (replay_path != nullptr)
+        scenes.assign(1, BENCH_REPLAY_SCENE);
+
+    for (const BenchScene& scene : scenes) {
+        if (scene_filter != nullptr && strcmp(scene_filter, scene.name) != 0)
+            continue;
+
+        const BenchResult result = RunScene(scene, frame_count, event_rate, renderer, window, overlay);
+
+        char gpu_ms[32] = "n/a";
+        if (result.gpu_ms >= 0.0)
+            snprintf(gpu_ms, sizeof(gpu_ms), "%.3f", result.gpu_ms);
+
+        char input[32] = {};
+        snprintf(input, sizeof(input), "%.1f/%.1f",
+            static_cast<double>(result.input_stats.events_received) / result.frames,
+            static_cast<double>(result.input_stats.events_forwarded) / result.frames);
+
+        printf("%-12s %8u %10.1f %10.3f %10.3f %10s %13.1f %13.1f %10llu %10llu %12s\n",
+            scene.name,
+            result.frames,
+            result.frames / result.seconds,
+            result.cpu_mean_ms,
+            result.cpu_p99_ms,
+            gpu_ms,
+            result.allocations_per_frame,
+            static_cast<double>(result.openvr_stats.calls) / result.frames,
+            static_cast<unsigned long long>(result.openvr_stats.texture_submits),
+            static_cast<unsigned long long>(result.render_stats.overlay_frames_skipped),
+            input);
+
+        if (print_vr_calls) {
+            for (const MockOpenVRMethodStats& method : MockOpenVR::MethodStats()) {
+                printf("    %-48s %10.2f calls/f %10llu bytes %10.3f ms\n",
+                    method.method,
+                    static_cast<double>(method.calls) / result.frames,
+                    static_cast<unsigned long long>(method.argument_bytes),
+                    static_cast<double>(method.duration_ns) / 1e6);
+            }
+        }
+    }
+
+    if (replay_path == nullptr) {
+        printf("\n%-12s %8s %12s %10s %10s %12s %12s %14s\n", "scene", "frames", "mode", "missed", "early", "pacer missed", "pacer dup", "phase err ms");
+
+        for (const PacingScene& scene : PACING_SCENES) {
+            if (scene_filter != nullptr && strcmp(scene_filter, scene.name) != 0)
+                continue;
+
+            const PacingResult result = RunPacing(scene, frame_count);
+
+            printf("%-12s %8u %12s %10llu %10llu %12llu %12llu %14.3f\n",
+                scene.name,
+                result.frames,
+                FramePacerModeName(result.mode),
+                static_cast<unsigned long long>(result.missed_frames),
+                static_cast<unsigned long long>(result.early_frames),
+                static_cast<unsigned long long>(result.pacer_stats.missed_frames),
+                static_cast<unsigned long long>(result.pacer_stats.duplicated_frames),
+                result.phase_error_ms);
+        }
+    }
+
+    VkResult vk_result = vkDeviceWaitIdle(renderer->Device());
+    VK_VALIDATE_RESULT(vk_result);
+
+    // The replayed textures are not owned by the ImGui context, Shutdown would not release them
+    for (ImTextureData* texture : g_replay.Textures()) {
+        if (texture->TexID == ImTextureID_Invalid)
+            continue;
+
+        texture->SetStatus(ImTextureStatus_WantDestroy);
+        texture->UnusedFrames = INT_MAX;
+        ImGui_ImplVulkan_UpdateTexture(texture);
+    }
+    g_replay.Close();
+
+    window->Destroy();
+    ImGui_ImplVulkan_Shutdown();
+    renderer->Destroy();
+    overlay->Destroy();
+
+    ImGui::DestroyContext();
+
+    vr::VR_Shutdown();
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,1186 @@
+/*
+ * Copyright (C) 2025. Nyabsi <nyabsi@sovellus.cc>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "MockOpenVR.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <numbers>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+struct MockOverlayState
+{
+    std::string key;
+    bool visible;
+    uint64_t flags;
+    std::deque<vr::VREvent_t> events;
+    std::vector<MockEventStream> streams;
+    std::vector<uint64_t> streams_generated;    // events produced by each stream so far
+    std::vector<uint64_t> streams_start_ns;
+};
+
+struct MockRuntime
+{
+    std::mutex mutex;
+    uint32_t init_token;
+    float refresh_rate;
+    bool dashboard_visible;
+    std::chrono::steady_clock::time_point start_time;
+    bool manual_time;
+    uint64_t time_ns;
+    vr::VROverlayHandle_t next_handle;
+    std::unordered_map<vr::VROverlayHandle_t, MockOverlayState> overlays;
+    MockOpenVRStats stats;
+    uint64_t call_latency_ns;
+    std::map<std::string, uint64_t, std::less<>> method_latency_ns;
+    std::unordered_map<std::string_view, MockOpenVRMethodStats> method_stats;
+    bool call_log_enabled;
+    std::vector<MockOpenVRCall> call_log;
+};
+
+static auto Runtime() -> MockRuntime&
+{
+    static MockRuntime runtime = {
+        .init_token = 1,
+        .refresh_rate = 90.0f,
+        .dashboard_visible = false,
+        .start_time = std::chrono::steady_clock::now(),
+        .manual_time = false,
+        .time_ns = 0,
+        .next_handle = 1,
+        .overlays = {},
+        .stats = {},
+        .call_latency_ns = 0,
+        .method_latency_ns = {},
+        .method_stats = {},
+        .call_log_enabled = false,
+        .call_log = {},
+    };
+    return runtime;
+}
+
+// Must be called with the runtime mutex held
+static auto NowLocked() -> uint64_t
+{
+    MockRuntime& runtime = Runtime();
+    if (runtime.manual_time)
+        return runtime.time_ns;
+
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - runtime.start_time).count());
+}
+
+// Measures one call into a mock interface and makes it take as long as the configured IPC latency
+class MockCallScope {
+public:
+    MockCallScope(const char* method, uint32_t argument_bytes)
+        : method_(method),
+        argument_bytes_(argument_bytes)
+    {
+        uint64_t latency_ns = {};
+        bool manual_time = {};
+        {
+            std::lock_guard<std::mutex> lock(Runtime().mutex);
+            MockRuntime& runtime = Runtime();
+
+            begin_ns_ = NowLocked();
+            manual_time = runtime.manual_time;
+
+            auto method_latency = runtime.method_latency_ns.find(std::string_view(method));
+            latency_ns = method_latency != runtime.method_latency_ns.end() ? method_latency->second : runtime.call_latency_ns;
+
+            // The manual clock stays deterministic, the call simply moves it forward
+            if (manual_time)
+                runtime.time_ns += latency_ns;
+        }
+
+        if (!manual_time && latency_ns > 0) {
+            // Round trips are tens of microseconds, far below what sleeping can hit, so spin
+            const auto deadline = std::chrono::steady_clock::now() + std::chrono::nanoseconds(latency_ns);
+            while (std::chrono::steady_clock::now() < deadline)
+                std::this_thread::yield();
+        }
+    }
+
+    ~MockCallScope()
+    {
+        std::lock_guard<std::mutex> lock(Runtime().mutex);
+        MockRuntime& runtime = Runtime();
+
+        const uint64_t duration_ns = NowLocked() - begin_ns_;
+
+        runtime.stats.calls++;
+
+        MockOpenVRMethodStats& method_stats = runtime.method_stats[std::string_view(method_)];
+        method_stats.method = method_;
+        method_stats.calls++;
+        method_stats.argument_bytes += argument_bytes_;
+        method_stats.duration_ns += duration_ns;
+
+        if (runtime.call_log_enabled)
+            runtime.call_log.push_back({ .timestamp_ns = begin_ns_, .method = method_, .argument_bytes = argument_bytes_, .duration_ns = duration_ns });
+    }
+
+    MockCallScope(const MockCallScope&) = delete;
+    MockCallScope& operator=(const MockCallScope&) = delete;
+
+private:
+    const char* method_;
+    uint32_t argument_bytes_;
+    uint64_t begin_ns_;
+};
+
+// What a call would copy across the process boundary. Strings and structures passed by pointer are
+// sent by value, output buffers and handles only cost their own size.
+template <typename T>
+static auto MockArgumentSize(const T& value) -> uint32_t
+{
+    using Pointee = std::remove_pointer_t<T>;
+
+    if constexpr (std::is_same_v<T, const char*>)
+        return value != nullptr ? static_cast<uint32_t>(strlen(value)) + 1 : sizeof(value);
+    else if constexpr (std::is_pointer_v<T> && std::is_const_v<Pointee> && !std::is_void_v<Pointee> && requires { sizeof(Pointee); })
+        return value != nullptr ? sizeof(Pointee) : sizeof(value);
+    else
+        return sizeof(value);
+}
+
+template <typename... Args>
+static auto MockArgumentBytes(const Args&... args) -> uint32_t
+{
+    return (MockArgumentSize(args) + ... + 0u);
+}
+
+// Methods the project never calls
+[[noreturn]] static auto MockUnmocked(const char* method) -> void
+{
+    fprintf(stderr, "[MockOpenVR] %s is not mocked\n", method);
+    std::abort();
+}
+
+// What SteamVR asks for on Linux, everything here is available on lavapipe as well
+static constexpr const char* MOCK_INSTANCE_EXTENSIONS = "VK_KHR_external_memory_capabilities VK_KHR_get_physical_device_properties2";
+static constexpr const char* MOCK_DEVICE_EXTENSIONS = "VK_KHR_external_memory VK_KHR_dedicated_allocation VK_KHR_get_memory_requirements2";
+
+static auto CopyString(const char* value, char* buffer, uint32_t buffer_size) -> uint32_t
+{
+    const uint32_t size = static_cast<uint32_t>(strlen(value)) + 1;
+    if (buffer != nullptr && buffer_size > 0) {
+        const uint32_t copied = std::min(size, buffer_size) - 1;
+        std::memcpy(buffer, value, copied);
+        buffer[copied] = '\0';
+    }
+    return size;
+}
+
+static auto SecondsSinceStart() -> double
+{
+    return static_cast<double>(MockOpenVR::Now()) / 1e9;
+}
+
+static constexpr const char* MOCK_KEYBOARD_TEXT = "The quick brown fox jumps over the lazy dog. ";
+
+// Must be called with the runtime mutex held
+static auto MakeStreamEvent(const MockEventStream& stream, uint64_t index, uint64_t time_ns) -> vr::VREvent_t
+{
+    vr::VREvent_t event = {};
+    event.eventAgeSeconds = 0.0f;
+
+    switch (stream.type) {
+        case MockEventStream_MouseMove: {
+            // One lap per second around the middle of the overlay
+            const double angle = static_cast<double>(time_ns) / 1e9 * 2.0 * std::numbers::pi;
+            event.eventType = vr::VREvent_MouseMove;
+            event.data.mouse.x = stream.width * (0.5f + 0.4f * static_cast<float>(std::cos(angle)));
+            event.data.mouse.y = stream.height * (0.5f + 0.4f * static_cast<float>(std::sin(angle)));
+            break;
+        }
+        case MockEventStream_Scroll: {
+            event.eventType = vr::VREvent_ScrollSmooth;
+            event.data.scroll.ydelta = (index / 32) % 2 == 0 ? 0.1f : -0.1f;
+            break;
+        }
+        case MockEventStream_Keyboard: {
+            event.eventType = vr::VREvent_KeyboardCharInput;
+            event.data.keyboard.cNewInput[0] = MOCK_KEYBOARD_TEXT[index % strlen(MOCK_KEYBOARD_TEXT)];
+            break;
+        }
+        case MockEventStream_PropertyChanged: {
+            event.eventType = vr::VREvent_PropertyChanged;
+            event.trackedDeviceIndex = vr::k_unTrackedDeviceIndex_Hmd;
+            event.data.property.prop = vr::Prop_DisplayFrequency_Float;
+            break;
+        }
+    }
+
+    return event;
+}
+
+// Must be called with the runtime mutex held
+static auto GenerateStreamEvents(MockOverlayState& overlay) -> void
+{
+    const uint64_t now = NowLocked();
+
+    for (size_t i = 0; i < overlay.streams.size(); i++) {
+        const MockEventStream& stream = overlay.streams[i];
+        if (stream.rate_hz <= 0.0)
+            continue;
+
+        const double elapsed = static_cast<double>(now - std::min(overlay.streams_start_ns[i], now)) / 1e9;
+        const uint64_t due = static_cast<uint64_t>(elapsed * stream.rate_hz);
+
+        // An application that stopped polling would otherwise get flooded with stale history
+        const uint64_t backlog_limit = static_cast<uint64_t>(std::ceil(stream.rate_hz));
+        if (due > overlay.streams_generated[i] + backlog_limit)
+            overlay.streams_generated[i] = due - backlog_limit;
+
+        for (; overlay.streams_generated[i] < due; overlay.streams_generated[i]++) {
+            const uint64_t index = overlay.streams_generated[i];
+            const uint64_t time_ns = overlay.streams_start_ns[i] + static_cast<uint64_t>(static_cast<double>(index) / stream.rate_hz * 1e9);
+            overlay.events.push_back(MakeStreamEvent(stream, index, time_ns));
+            Runtime().stats.events_generated++;
+        }
+    }
+}
+
+// IVRSystem
+
+static auto System_GetFloatTrackedDeviceProperty(vr::TrackedDeviceIndex_t index, vr::ETrackedDeviceProperty property, vr::ETrackedPropertyError* error) -> float
+{
+    float value = 0.0f;
+    vr::ETrackedPropertyError result = vr::TrackedProp_UnknownProperty;
+
+    if (index != vr::k_unTrackedDeviceIndex_Hmd) {
+        result = vr::TrackedProp_InvalidDevice;
+    }
+    else if (property == vr::Prop_DisplayFrequency_Float) {
+        std::lock_guard<std::mutex> lock(Runtime().mutex);
+        value = Runtime().refresh_rate;
+        result = vr::TrackedProp_Success;
+    }
+
+    if (error != nullptr)
+        *error = result;
+    return value;
+}
+
+static auto System_GetStringTrackedDeviceProperty(vr::TrackedDeviceIndex_t index, vr::ETrackedDeviceProperty property, char* buffer, uint32_t buffer_size, vr::ETrackedPropertyError* error) -> uint32_t
+{
+    const char* value = nullptr;
+    if (index == vr::k_unTrackedDeviceIndex_Hmd && property == vr::Prop_TrackingSystemName_String)
+        value = "mock";
+    if (index == vr::k_unTrackedDeviceIndex_Hmd && property == vr::Prop_ModelNumber_String)
+        value = "Mock HMD";
+
+    if (value == nullptr) {
+        if (error != nullptr)
+            *error = index == vr::k_unTrackedDeviceIndex_Hmd ? vr::TrackedProp_UnknownProperty : vr::TrackedProp_InvalidDevice;
+        return 0;
+    }
+
+    const uint32_t size = CopyString(value, buffer, buffer_size);
+    if (error != nullptr)
+        *error = size > buffer_size ? vr::TrackedProp_BufferTooSmall : vr::TrackedProp_Success;
+    return size;
+}
+
+static auto System_IsTrackedDeviceConnected(vr::TrackedDeviceIndex_t index) -> bool
+{
+    return index == vr::k_unTrackedDeviceIndex_Hmd;
+}
+
+static auto System_GetTrackedDeviceIndexForControllerRole([[maybe_unused]] vr::ETrackedControllerRole role) -> vr::TrackedDeviceIndex_t
+{
+    return vr::k_unTrackedDeviceIndexInvalid;
+}
+
+static auto System_GetTimeSinceLastVsync(float* seconds_since_last_vsync, uint64_t* frame_counter) -> bool
+{
+    float refresh_rate = {};
+    {
+        std::lock_guard<std::mutex> lock(Runtime().mutex);
+        refresh_rate = Runtime().refresh_rate;
+    }
+
+    const double frames = SecondsSinceStart() * refresh_rate;
+    if (seconds_since_last_vsync != nullptr)
+        *seconds_since_last_vsync = static_cast<float>((frames - std::floor(frames)) / refresh_rate);
+    if (frame_counter != nullptr)
+        *frame_counter = static_cast<uint64_t>(frames);
+    return true;
+}
+
+// Only the HMD is tracked, standing still at eye height
+static auto System_GetDeviceToAbsoluteTrackingPose([[maybe_unused]] vr::ETrackingUniverseOrigin origin, [[maybe_unused]] float predicted_seconds, vr::TrackedDevicePose_t* poses, uint32_t pose_count) -> void
+{
+    for (uint32_t i = 0; i < pose_count; i++)
+        poses[i] = {};
+
+    if (pose_count > vr::k_unTrackedDeviceIndex_Hmd) {
+        vr::TrackedDevicePose_t& hmd = poses[vr::k_unTrackedDeviceIndex_Hmd];
+        hmd.mDeviceToAbsoluteTracking = { { { 1.0f, 0.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f, 1.7f }, { 0.0f, 0.0f, 1.0f, 0.0f } } };
+        hmd.eTrackingResult = vr::TrackingResult_Running_OK;
+        hmd.bPoseIsValid = true;
+        hmd.bDeviceIsConnected = true;
+    }
+}
+
+// IVROverlay
+
+static auto Overlay_CreateOverlay(const char* key, [[maybe_unused]] const char* name, vr::VROverlayHandle_t* handle) -> vr::EVROverlayError
+{
+    std::lock_guard<std::mutex> lock(Runtime().mutex);
+    MockRuntime& runtime = Runtime();
+
+    for (const auto& [existing_handle, overlay] : runtime.overlays) {
+        if (overlay.key == key)
+            return vr::VROverlayError_KeyInUse;
+    }
+
+    *handle = runtime.next_handle++;
+    runtime.overlays[*handle] = { .key = key, .visible = false, .flags = 0, .events = {}, .streams = {}, .streams_generated = {}, .streams_start_ns = {} };
+    runtime.stats.overlays_created++;
+    return vr::VROverlayError_None;
+}
+
+static auto Overlay_CreateDashboardOverlay(const char* key, const char* name, vr::VROverlayHandle_t* handle, vr::VROverlayHandle_t* thumbnail_handle) -> vr::EVROverlayError
+{
+    vr::EVROverlayError result = Overlay_CreateOverlay(key, name, handle);
+    if (result != vr::VROverlayError_None)
+        return result;
+
+    return Overlay_CreateOverlay((std::string(key) + ".thumbnail").c_str(), name, thumbnail_handle);
+}
+
+static auto Overlay_DestroyOverlay(vr::VROverlayHandle_t handle) -> vr::EVROverlayError
+{
+    std::lock_guard<std::mutex> lock(Runtime().mutex);
+    return Runtime().overlays.erase(handle) > 0 ? vr::VROverlayError_None : vr::VROverlayError_InvalidHandle;
+}
+
+static auto Overlay_ShowOverlay(vr::VROverlayHandle_t handle) -> vr::EVROverlayError
+{
+    MockOpenVR::SetOverlayVisible(handle, true);
+    return vr::VROverlayError_None;
+}
+
+static auto Overlay_HideOverlay(vr::VROverlayHandle_t handle) -> vr::EVROverlayError
+{
+    MockOpenVR::SetOverlayVisible(handle, false);
+    return vr::VROverlayError_None;
+}
+
+static auto Overlay_IsOverlayVisible(vr::VROverlayHandle_t handle) -> bool
+{
+    std::lock_guard<std::mutex> lock(Runtime().mutex);
+    auto overlay = Runtime().overlays.find(handle);
+    return overlay != Runtime().overlays.end() && overlay->second.visible;
+}
+
+static auto Overlay_IsDashboardVisible() -> bool
+{
+    std::lock_guard<std::mutex> lock(Runtime().mutex);
+    return Runtime().dashboard_visible;
+}
+
+static auto Overlay_SetOverlayFlag(vr::VROverlayHandle_t handle, vr::VROverlayFlags flag, bool enabled) -> vr::EVROverlayError
+{
+    std::lock_guard<std::mutex> lock(Runtime().mutex);
+    auto overlay = Runtime().overlays.find(handle);
+    if (overlay == Runtime().overlays.end())
+        return vr::VROverlayError_InvalidHandle;
+
+    if (enabled)
+        overlay->second.flags |= static_cast<uint64_t>(flag);
+    else
+        overlay->second.flags &= ~static_cast<uint64_t>(flag);
+    return vr::VROverlayError_None;
+}
+
+static auto Overlay_GetOverlayFlag(vr::VROverlayHandle_t handle, vr::VROverlayFlags flag, bool* enabled) -> vr::EVROverlayError
+{
+    std::lock_guard<std::mutex> lock(Runtime().mutex);
+    auto overlay = Runtime().overlays.find(handle);
+    if (overlay == Runtime().overlays.end())
+        return vr::VROverlayError_InvalidHandle;
+
+    *enabled = (overlay->second.flags & static_cast<uint64_t>(flag)) != 0;
+    return vr::VROverlayError_None;
+}
+
+static auto Overlay_SetOverlayTexture(vr::VROverlayHandle_t handle, const vr::Texture_t* texture) -> vr::EVROverlayError
+{
+    std::lock_guard<std::mutex> lock(Runtime().mutex);
+    if (!Runtime().overlays.contains(handle))
+        return vr::VROverlayError_InvalidHandle;
+    if (texture == nullptr || texture->handle == nullptr)
+        return vr::VROverlayError_InvalidTexture;
+
+    Runtime().stats.texture_submits++;
+    return vr::VROverlayError_None;
+}
+
+static auto Overlay_PollNextOverlayEvent(vr::VROverlayHandle_t handle, vr::VREvent_t* event, uint32_t event_size) -> bool
+{
+    std::lock_guard<std::mutex> lock(Runtime().mutex);
+    auto overlay = Runtime().overlays.find(handle);
+    if (overlay == Runtime().overlays.end())
+        return false;
+
+    GenerateStreamEvents(overlay->second);
+    if (overlay->second.events.empty())
+        return false;
+
+    std::memcpy(event, &overlay->second.events.front(), std::min<size_t>(event_size, sizeof(vr::VREvent_t)));
+    overlay->second.events.pop_front();
+    Runtime().stats.events_polled++;
+    return true;
+}
+
+static auto Overlay_WaitFrameSync(uint32_t timeout_ms) -> vr::EVROverlayError
+{
+    float refresh_rate = {};
+    bool manual_time = {};
+    {
+        std::lock_guard<std::mutex> lock(Runtime().mutex);
+        refresh_rate = Runtime().refresh_rate;
+        manual_time = Runtime().manual_time;
+    }
+
+    const double frames = SecondsSinceStart() * refresh_rate;
+    const double wait_seconds = std::min((std::floor(frames) + 1.0 - frames) / refresh_rate, timeout_ms / 1000.0);
+
+    if (manual_time) {
+        std::lock_guard<std::mutex> lock(Runtime().mutex);
+        Runtime().time_ns += static_cast<uint64_t>(wait_seconds * 1e9);
+    }
+    else {
+        std::this_thread::sleep_for(std::chrono::duration<double>(wait_seconds));
+    }
+    return vr::VROverlayError_None;
+}
+
+// IVRCompositor
+
+static auto Compositor_GetVulkanInstanceExtensionsRequired(char* buffer, uint32_t buffer_size) -> uint32_t
+{
+    return CopyString(MOCK_INSTANCE_EXTENSIONS, buffer, buffer_size);
+}
+
+static auto Compositor_GetVulkanDeviceExtensionsRequired([[maybe_unused]] VkPhysicalDevice_T* physical_device, char* buffer, uint32_t buffer_size) -> uint32_t
+{
+    return CopyString(MOCK_DEVICE_EXTENSIONS, buffer, buffer_size);
+}
+
+// IVRApplications
+
+static auto Applications_IsApplicationInstalled([[maybe_unused]] const char* app_key) -> bool
+{
+    return true;
+}
+
+// The mock interfaces implement every method of the pinned openvr.h. The ones the project calls forward
+// to the functions above through a MockCallScope, a few whose effect nothing depends on succeed with a
+// value initialized result, and the rest abort with their name.
+
+class MockSystem final : public vr::IVRSystem {
+public:
+    auto GetRecommendedRenderTargetSize(uint32_t*, uint32_t*) -> void override { MockUnmocked("IVRSystem::GetRecommendedRenderTargetSize"); }
+    auto GetProjectionMatrix(vr::EVREye, float, float) -> vr::HmdMatrix44_t override { MockUnmocked("IVRSystem::GetProjectionMatrix"); }
+    auto GetProjectionRaw(vr::EVREye, float*, float*, float*, float*) -> void override { MockUnmocked("IVRSystem::GetProjectionRaw"); }
+    auto ComputeDistortion(vr::EVREye, float, float, vr::DistortionCoordinates_t*) -> bool override { MockUnmocked("IVRSystem::ComputeDistortion"); }
+    auto GetEyeToHeadTransform(vr::EVREye) -> vr::HmdMatrix34_t override { MockUnmocked("IVRSystem::GetEyeToHeadTransform"); }
+
+    auto GetTimeSinceLastVsync(float* seconds_since_last_vsync, uint64_t* frame_counter) -> bool override
+    {
+        const MockCallScope call("IVRSystem::GetTimeSinceLastVsync", MockArgumentBytes(seconds_since_last_vsync, frame_counter));
+        return System_GetTimeSinceLastVsync(seconds_since_last_vsync, frame_counter);
+    }
+
+    auto GetD3D9AdapterIndex() -> int32_t override { MockUnmocked("IVRSystem::GetD3D9AdapterIndex"); }
+    auto GetDXGIOutputInfo(int32_t*) -> void override { MockUnmocked("IVRSystem::GetDXGIOutputInfo"); }
+    auto GetOutputDevice(uint64_t*, vr::ETextureType, VkInstance_T*) -> void override { MockUnmocked("IVRSystem::GetOutputDevice"); }
+    auto IsDisplayOnDesktop() -> bool override { MockUnmocked("IVRSystem::IsDisplayOnDesktop"); }
+    auto SetDisplayVisibility(bool) -> bool override { MockUnmocked("IVRSystem::SetDisplayVisibility"); }
+
+    auto GetDeviceToAbsoluteTrackingPose(vr::ETrackingUniverseOrigin origin, float predicted_seconds, vr::TrackedDevicePose_t* poses, uint32_t pose_count) -> void override
+    {
+        const MockCallScope call("IVRSystem::GetDeviceToAbsoluteTrackingPose", MockArgumentBytes(origin, predicted_seconds, poses, pose_count));
+        System_GetDeviceToAbsoluteTrackingPose(origin, predicted_seconds, poses, pose_count);
+    }
+
+    auto GetSeatedZeroPoseToStandingAbsoluteTrackingPose() -> vr::HmdMatrix34_t override { MockUnmocked("IVRSystem::GetSeatedZeroPoseToStandingAbsoluteTrackingPose"); }
+    auto GetRawZeroPoseToStandingAbsoluteTrackingPose() -> vr::HmdMatrix34_t override { MockUnmocked("IVRSystem::GetRawZeroPoseToStandingAbsoluteTrackingPose"); }
+    auto GetSortedTrackedDeviceIndicesOfClass(vr::ETrackedDeviceClass, vr::TrackedDeviceIndex_t*, uint32_t, vr::TrackedDeviceIndex_t) -> uint32_t override { MockUnmocked("IVRSystem::GetSortedTrackedDeviceIndicesOfClass"); }
+    auto GetTrackedDeviceActivityLevel(vr::TrackedDeviceIndex_t) -> vr::EDeviceActivityLevel override { MockUnmocked("IVRSystem::GetTrackedDeviceActivityLevel"); }
+    auto ApplyTransform(vr::TrackedDevicePose_t*, const vr::TrackedDevicePose_t*, const vr::HmdMatrix34_t*) -> void override { MockUnmocked("IVRSystem::ApplyTransform"); }
+
+    auto GetTrackedDeviceIndexForControllerRole(vr::ETrackedControllerRole role) -> vr::TrackedDeviceIndex_t override
+    {
+        const MockCallScope call("IVRSystem::GetTrackedDeviceIndexForControllerRole", MockArgumentBytes(role));
+        return System_GetTrackedDeviceIndexForControllerRole(role);
+    }
+
+    auto GetControllerRoleForTrackedDeviceIndex(vr::TrackedDeviceIndex_t) -> vr::ETrackedControllerRole override { MockUnmocked("IVRSystem::GetControllerRoleForTrackedDeviceIndex"); }
+    auto GetTrackedDeviceClass(vr::TrackedDeviceIndex_t) -> vr::ETrackedDeviceClass override { MockUnmocked("IVRSystem::GetTrackedDeviceClass"); }
+
+    auto IsTrackedDeviceConnected(vr::TrackedDeviceIndex_t index) -> bool override
+    {
+        const MockCallScope call("IVRSystem::IsTrackedDeviceConnected", MockArgumentBytes(index));
+        return System_IsTrackedDeviceConnected(index);
+    }
+
+    auto GetBoolTrackedDeviceProperty(vr::TrackedDeviceIndex_t index, vr::ETrackedDeviceProperty property, vr::ETrackedPropertyError* error) -> bool override
+    {
+        const MockCallScope call("IVRSystem::GetBoolTrackedDeviceProperty", MockArgumentBytes(index, property, error));
+        return {};
+    }
+
+    auto GetFloatTrackedDeviceProperty(vr::TrackedDeviceIndex_t index, vr::ETrackedDeviceProperty property, vr::ETrackedPropertyError* error) -> float override
+    {
+        const MockCallScope call("IVRSystem::GetFloatTrackedDeviceProperty", MockArgumentBytes(index, property, error));
+        return System_GetFloatTrackedDeviceProperty(index, property, error);
+    }
+
+    auto GetInt32TrackedDeviceProperty(vr::TrackedDeviceIndex_t index, vr::ETrackedDeviceProperty property, vr::ETrackedPropertyError* error) -> int32_t override
+    {
+        const MockCallScope call("IVRSystem::GetInt32TrackedDeviceProperty", MockArgumentBytes(index, property, error));
+        return {};
+    }
+
+    auto GetUint64TrackedDeviceProperty(vr::TrackedDeviceIndex_t index, vr::ETrackedDeviceProperty property, vr::ETrackedPropertyError* error) -> uint64_t override
+    {
+        const MockCallScope call("IVRSystem::GetUint64TrackedDeviceProperty", MockArgumentBytes(index, property, error));
+        return {};
+    }
+
+    auto GetMatrix34TrackedDeviceProperty(vr::TrackedDeviceIndex_t index, vr::ETrackedDeviceProperty property, vr::ETrackedPropertyError* error) -> vr::HmdMatrix34_t override
+    {
+        const MockCallScope call("IVRSystem::GetMatrix34TrackedDeviceProperty", MockArgumentBytes(index, property, error));
+        return {};
+    }
+
+    auto GetArrayTrackedDeviceProperty(vr::TrackedDeviceIndex_t index, vr::ETrackedDeviceProperty property, vr::PropertyTypeTag_t tag, void* buffer, uint32_t buffer_size, vr::ETrackedPropertyError* error) -> uint32_t override
+    {
+        const MockCallScope call("IVRSystem::GetArrayTrackedDeviceProperty", MockArgumentBytes(index, property, tag, buffer, buffer_size, error));
+        return {};
+    }
+
+    auto GetStringTrackedDeviceProperty(vr::TrackedDeviceIndex_t index, vr::ETrackedDeviceProperty property, char* buffer, uint32_t buffer_size, vr::ETrackedPropertyError* error) -> uint32_t override
+    {
+        const MockCallScope call("IVRSystem::GetStringTrackedDeviceProperty", MockArgumentBytes(index, property, buffer, buffer_size, error));
+        return System_GetStringTrackedDeviceProperty(index, property, buffer, buffer_size, error);
+    }
+
+    auto GetPropErrorNameFromEnum(vr::ETrackedPropertyError) -> const char* override { MockUnmocked("IVRSystem::GetPropErrorNameFromEnum"); }
+
+    auto PollNextEvent(vr::VREvent_t* event, uint32_t event_size) -> bool override
+    {
+        const MockCallScope call("IVRSystem::PollNextEvent", MockArgumentBytes(event, event_size));
+        return {};
+    }
+
+    auto PollNextEventWithPose(vr::ETrackingUniverseOrigin, vr::VREvent_t*, uint32_t, vr::TrackedDevicePose_t*) -> bool override { MockUnmocked("IVRSystem::PollNextEventWithPose"); }
+    auto GetEventTypeNameFromEnum(vr::EVREventType) -> const char* override { MockUnmocked("IVRSystem::GetEventTypeNameFromEnum"); }
+    auto GetHiddenAreaMesh(vr::EVREye, vr::EHiddenAreaMeshType) -> vr::HiddenAreaMesh_t override { MockUnmocked("IVRSystem::GetHiddenAreaMesh"); }
+    auto GetControllerState(vr::TrackedDeviceIndex_t, vr::VRControllerState_t*, uint32_t) -> bool override { MockUnmocked("IVRSystem::GetControllerState"); }
+    auto GetControllerStateWithPose(vr::ETrackingUniverseOrigin, vr::TrackedDeviceIndex_t, vr::VRControllerState_t*, uint32_t, vr::TrackedDevicePose_t*) -> bool override { MockUnmocked("IVRSystem::GetControllerStateWithPose"); }
+    auto TriggerHapticPulse(vr::TrackedDeviceIndex_t, uint32_t, unsigned short) -> void override { MockUnmocked("IVRSystem::TriggerHapticPulse"); }
+    auto GetButtonIdNameFromEnum(vr::EVRButtonId) -> const char* override { MockUnmocked("IVRSystem::GetButtonIdNameFromEnum"); }
+    auto GetControllerAxisTypeNameFromEnum(vr::EVRControllerAxisType) -> const char* override { MockUnmocked("IVRSystem::GetControllerAxisTypeNameFromEnum"); }
+    auto IsInputAvailable() -> bool override { MockUnmocked("IVRSystem::IsInputAvailable"); }
+    auto IsSteamVRDrawingControllers() -> bool override { MockUnmocked("IVRSystem::IsSteamVRDrawingControllers"); }
+    auto ShouldApplicationPause() -> bool override { MockUnmocked("IVRSystem::ShouldApplicationPause"); }
+    auto ShouldApplicationReduceRenderingWork() -> bool override { MockUnmocked("IVRSystem::ShouldApplicationReduceRenderingWork"); }
+    auto PerformFirmwareUpdate(vr::TrackedDeviceIndex_t) -> vr::EVRFirmwareError override { MockUnmocked("IVRSystem::PerformFirmwareUpdate"); }
+    auto AcknowledgeQuit_Exiting() -> void override { MockUnmocked("IVRSystem::AcknowledgeQuit_Exiting"); }
+    auto GetAppContainerFilePaths(char*, uint32_t) -> uint32_t override { MockUnmocked("IVRSystem::GetAppContainerFilePaths"); }
+    auto GetRuntimeVersion() -> const char* override { MockUnmocked("IVRSystem::GetRuntimeVersion"); }
+};
+
+class MockOverlay final : public vr::IVROverlay {
+public:
+    auto FindOverlay(const char*, vr::VROverlayHandle_t*) -> vr::EVROverlayError override { MockUnmocked("IVROverlay::FindOverlay"); }
+
+    auto CreateOverlay(const char* key, const char* name, vr::VROverlayHandle_t* handle) -> vr::EVROverlayError override
+    {
+        const MockCallScope call("IVROverlay::CreateOverlay", MockArgumentBytes(key, name, handle));
+        return Overlay_CreateOverlay(key, name, handle);
+    }
+
+    auto CreateSubviewOverlay(vr::VROverlayHandle_t, const char*, const char*, vr::VROverlayHandle_t*) -> vr::EVROverlayError override { MockUnmocked("IVROverlay::CreateSubviewOverlay"); }
+
+    auto DestroyOverlay(vr::VROverlayHandle_t handle) -> vr::EVROverlayError override
+    {
+        const MockCallScope call("IVROverlay::DestroyOverlay", MockArgumentBytes(handle));
+        return Overlay_DestroyOverlay(handle);
+    }
+
+    auto GetOverlayKey(vr::VROverlayHandle_t, char*, uint32_t, vr::EVROverlayError*) -> uint32_t override { MockUnmocked("IVROverlay::GetOverlayKey"); }
+    auto GetOverlayName(vr::VROverlayHandle_t, char*, uint32_t, vr::EVROverlayError*) -> uint32_t override { MockUnmocked("IVROverlay::GetOverlayName"); }
+    auto SetOverlayName(vr::VROverlayHandle_t, const char*) -> vr::EVROverlayError override { MockUnmocked("IVROverlay::SetOverlayName"); }
+    auto GetOverlayImageData(vr::VROverlayHandle_t, void*, uint32_t, uint32_t*, uint32_t*) -> vr::EVROverlayError override { MockUnmocked("IVROverlay::GetOverlayImageData"); }
+    auto GetOverlayErrorNameFromEnum(vr::EVROverlayError) -> const char* override { MockUnmocked("IVROverlay::GetOverlayErrorNameFromEnum"); }
+    auto SetOverlayRenderingPid(vr::VROverlayHandle_t, uint32_t) -> vr::EVROverlayError override { MockUnmocked("IVROverlay::SetOverlayRenderingPid"); }
+    auto GetOverlayRenderingPid(vr::VROverlayHandle_t) -> uint32_t override { MockUnmocked("IVROverlay::GetOverlayRenderingPid"); }
+
+    auto SetOverlayFlag(vr::VROverlayHandle_t handle, vr::VROverlayFlags flag, bool enabled) -> vr::EVROverlayError override
+    {
+        const MockCallScope call("IVROverlay::SetOverlayFlag", MockArgumentBytes(handle, flag, enabled));
+        return Overlay_SetOverlayFlag(handle, flag, enabled);
+    }
+
+    auto GetOverlayFlag(vr::VROverlayHandle_t handle, vr::VROverlayFlags flag, bool* enabled) -> vr::EVROverlayError override
+    {
+        const MockCallScope call("IVROverlay::GetOverlayFlag", MockArgumentBytes(handle, flag, enabled));
+        return Overlay_GetOverlayFlag(handle, flag, enabled);
+    }
+
+    auto GetOverlayFlags(vr::VROverlayHandle_t, uint32_t*) -> vr::EVROverlayError override { MockUnmocked("IVROverlay::GetOverlayFlags"); }
+    auto SetOverlayColor(vr::VROverlayHandle_t, float, float, float) -> vr::EVROverlayError override { MockUnmocked("IVROverlay::SetOverlayColor"); }
+    auto GetOverlayColor(vr::VROverlayHandle_t, float*, float*, float*) -> vr::EVROverlayError override { MockUnmocked("IVROverlay::GetOverlayColor"); }
+    auto SetOverlayAlpha(vr::VROverlayHandle_t, float) -> vr::EVROverlayError override { MockUnmocked("IVROverlay::SetOverlayAlpha"); }
+    auto GetOverlayAlpha(vr::VROverlayHandle_t, float*) -> vr::EVROverlayError override { MockUnmocked("IVROverlay::GetOverlayAlpha"); }
+    auto SetOverlayTexelAspect(vr::VROverlayHandle_t, float) -> vr::EVROverlayError override { MockUnmocked("IVROverlay::SetOverlayTexelAspect"); }
+    auto GetOverlayTexelAspect(vr::VROverlayHandle_t, float*) -> vr::EVROverlayError override { MockUnmocked("IVROverlay::GetOverlayTexelAspect"); }
+    auto SetOverlaySortOrder(vr::VROverlayHandle_t, uint32_t) -> vr::EVROverlayError override { MockUnmocked("IVROverlay::SetOverlaySortOrder"); }
+    auto GetOverlaySortOrder(vr::VROverlayHandle_t, uint32_t*) -> vr::EVROverlayError override { MockUnmocked("IVROverlay::GetOverlaySortOrder"); }
+
+    auto SetOverlayWidthInMeters(vr::VROverlayHandle_t handle, float width) -> vr::EVROverlayError override
+    {
+        const MockCallScope call("IVROverlay::SetOverlayWidthInMeters", MockArgumentBytes(handle, width));
+        return {};
+    }
+
+    auto GetOverlayWidthInMeters(vr::VROverlayHandle_t, float*) -> vr::EVROverlayError override { MockUnmocked("IVROverlay::GetOverlayWidthInMeters"); }
+    auto SetOverlayCurvature(vr::VROverlayHandle_t, float) -> vr::EVROverlayError override { MockUnmocked("IVROverlay::SetOverlayCurvature"); }
+    auto GetOverlayCurvature(vr::VROverlayHandle_t, float*) -> vr::EVROverlayError override { MockUnmocked("IVROverlay::GetOverlayCurvature"); }
+    auto SetOverlayPreCurvePitch(vr::VROverlayHandle_t, float) -> vr::EVROverlayError override { MockUnmocked("IVROverlay::SetOverlayPreCurvePitch"); }
+    auto GetOverlayPreCurvePitch(vr::VROverlayHandle_t, float*) -> vr::EVROverlayError override { MockUnmocked("IVROverlay::GetOverlayPreCurvePitch"); }
+    auto SetOverlayTextureColorSpace(vr::VROverlayHandle_t, vr::EColorSpace) -> vr::EVROverlayError override { MockUnmocked("IVROverlay::SetOverlayTextureColorSpace"); }
+    auto GetOverlayTextureColorSpace(vr::VROverlayHandle_t, vr::EColorSpace*) -> vr::EVROverlayError override { MockUnmocked("IVROverlay::GetOverlayTextureColorSpace"); }
+    auto SetOverlayTextureBounds(vr::VROverlayHandle_t, const vr::VRTextureBounds_t*) -> vr::EVROverlayError override { MockUnmocked("IVROverlay::SetOverlayTextureBounds"); }
+    auto GetOverlayTextureBounds(vr::VROverlayHandle_t, vr::VRTextureBounds_t*) -> vr::EVROverlayError override { MockUnmocked("IVROverlay::GetOverlayTextureBounds"); }
+    auto GetOverlayTransformType(vr::VROverlayHandle_t, vr::VROverlayTransformType*) -> vr::EVROverlayError override { MockUnmocked("IVROverlay::GetOverlayTransformType"); }
+
+    auto SetOverlayTransformAbsolute(vr::VROverlayHandle_t handle, vr::ETrackingUniverseOrigin origin, const vr::HmdMatrix34_t* transform) -> vr::EVROverlayError override
+    {
+        const MockCallScope call("IVROverlay::SetOverlayTransformAbsolute", MockArgumentBytes(handle, origin, transform));
+        return {};
+    }
+
+    auto GetOverlayTransformAbsolute(vr::VROverlayHandle_t, vr::ETrackingUniverseOrigin*, vr::HmdMatrix34_t*) -> vr::EVROverlayError override { MockUnmocked("IVROverlay::GetOverlayTransformAbsolute"); }
+
+    auto SetOverlayTransformTrackedDeviceRelative(vr::VROverlayHandle_t handle, vr::TrackedDeviceIndex_t device, const vr::HmdMatrix34_t* transform) -> vr::EVROverlayError override
+    {
+        const MockCallScope call("IVROverlay::SetOverlayTransformTrackedDeviceRelative", MockArgumentBytes(handle, device, transform));
+        return {};
+    }
+
+    auto GetOverlayTransformTrackedDeviceRelative(vr::VROverlayHandle_t, vr::TrackedDeviceIndex_t*, vr::HmdMatrix34_t*) -> vr::EVROverlayError override { MockUnmocked("IVROverlay::GetOverlayTransformTrackedDeviceRelative"); }
+    auto SetOverlayTransformTrackedDeviceComponent(vr::VROverlayHandle_t, vr::TrackedDeviceIndex_t, const char*) -> vr::EVROverlayError override { MockUnmocked("IVROverlay::SetOverlayTransformTrackedDeviceComponent"); }
+    auto GetOverlayTransformTrackedDeviceComponent(vr::VROverlayHandle_t, vr::TrackedDeviceIndex_t*, char*, uint32_t) -> vr::EVROverlayError override { MockUnmocked("IVROverlay::GetOverlayTransformTrackedDeviceComponent"); }
+    auto SetOverlayTransformCursor(vr::VROverlayHandle_t, const vr::HmdVector2_t*) -> vr::EVROverlayError override { MockUnmocked("IVROverlay::SetOverlayTransformCursor"); }
+    auto GetOverlayTransformCursor(vr::VROverlayHandle_t, vr::HmdVector2_t*) -> vr::EVROverlayError override { MockUnmocked("IVROverlay::GetOverlayTransformCursor"); }
+    auto SetOverlayTransformProjection(vr::VROverlayHandle_t, vr::ETrackingUniverseOrigin, const vr::HmdMatrix34_t*, const vr::VROverlayProjection_t*, vr::EVREye) -> vr::EVROverlayError override { MockUnmocked("IVROverlay::SetOverlayTransformProjection"); }
+    auto SetSubviewPosition(vr::VROverlayHandle_t, float, float) -> vr::EVROverlayError override { MockUnmocked("IVROverlay::SetSubviewPosition"); }
+
+    auto ShowOverlay(vr::VROverlayHandle_t handle) -> vr::EVROverlayError override
+    {
+        const MockCallScope call("IVROverlay::ShowOverlay", MockArgumentBytes(handle));
+        return Overlay_ShowOverlay(handle);
+    }
+
+    auto HideOverlay(vr::VROverlayHandle_t handle) -> vr::EVROverlayError override
+    {
+        const MockCallScope call("IVROverlay::HideOverlay", MockArgumentBytes(handle));
+        return Overlay_HideOverlay(handle);
+    }
+
+    auto IsOverlayVisible(vr::VROverlayHandle_t handle) -> bool override
+    {
+        const MockCallScope call("IVROverlay::IsOverlayVisible", MockArgumentBytes(handle));
+        return Overlay_IsOverlayVisible(handle);
+    }
+
+    auto GetTransformForOverlayCoordinates(vr::VROverlayHandle_t, vr::ETrackingUniverseOrigin, vr::HmdVector2_t, vr::HmdMatrix34_t*) -> vr::EVROverlayError override { MockUnmocked("IVROverlay::GetTransformForOverlayCoordinates"); }
+
+    auto WaitFrameSync(uint32_t timeout_ms) -> vr::EVROverlayError override
+    {
+        const MockCallScope call("IVROverlay::WaitFrameSync", MockArgumentBytes(timeout_ms));
+        return Overlay_WaitFrameSync(timeout_ms);
+    }
+
+    auto PollNextOverlayEvent(vr::VROverlayHandle_t handle, vr::VREvent_t* event, uint32_t event_size) -> bool override
+    {
+        const MockCallScope call("IVROverlay::PollNextOverlayEvent", MockArgumentBytes(handle, event, event_size));
+        return Overlay_PollNextOverlayEvent(handle, event, event_size);
+    }
+
+    auto GetOverlayInputMethod(vr::VROverlayHandle_t, vr::VROverlayInputMethod*) -> vr::EVROverlayError override { MockUnmocked("IVROverlay::GetOverlayInputMethod"); }
+
+    auto SetOverlayInputMethod(vr::VROverlayHandle_t handle, vr::VROverlayInputMethod method) -> vr::EVROverlayError override
+    {
+        const MockCallScope call("IVROverlay::SetOverlayInputMethod", MockArgumentBytes(handle, method));
+        return {};
+    }
+
+    auto GetOverlayMouseScale(vr::VROverlayHandle_t, vr::HmdVector2_t*) -> vr::EVROverlayError override { MockUnmocked("IVROverlay::GetOverlayMouseScale"); }
+
+    auto SetOverlayMouseScale(vr::VROverlayHandle_t handle, const vr::HmdVector2_t* scale) -> vr::EVROverlayError override
+    {
+        const MockCallScope call("IVROverlay::SetOverlayMouseScale", MockArgumentBytes(handle, scale));
+        return {};
+    }
+
+    auto ComputeOverlayIntersection(vr::VROverlayHandle_t, const vr::VROverlayIntersectionParams_t*, vr::VROverlayIntersectionResults_t*) -> bool override { MockUnmocked("IVROverlay::ComputeOverlayIntersection"); }
+    auto IsHoverTargetOverlay(vr::VROverlayHandle_t) -> bool override { MockUnmocked("IVROverlay::IsHoverTargetOverlay"); }
+    auto SetOverlayIntersectionMask(vr::VROverlayHandle_t, vr::VROverlayIntersectionMaskPrimitive_t*, uint32_t, uint32_t) -> vr::EVROverlayError override { MockUnmocked("IVROverlay::SetOverlayIntersectionMask"); }
+
+    auto TriggerLaserMouseHapticVibration(vr::VROverlayHandle_t handle, float duration, float frequency, float amplitude) -> vr::EVROverlayError override
+    {
+        const MockCallScope call("IVROverlay::TriggerLaserMouseHapticVibration", MockArgumentBytes(handle, duration, frequency, amplitude));
+        return {};
+    }
+
+    auto SetOverlayCursor(vr::VROverlayHandle_t, vr::VROverlayHandle_t) -> vr::EVROverlayError override { MockUnmocked("IVROverlay::SetOverlayCursor"); }
+    auto SetOverlayCursorPositionOverride(vr::VROverlayHandle_t, const vr::HmdVector2_t*) -> vr::EVROverlayError override { MockUnmocked("IVROverlay::SetOverlayCursorPositionOverride"); }
+    auto ClearOverlayCursorPositionOverride(vr::VROverlayHandle_t) -> vr::EVROverlayError override { MockUnmocked("IVROverlay::ClearOverlayCursorPositionOverride"); }
+
+    auto SetOverlayTexture(vr::VROverlayHandle_t handle, const vr::Texture_t* texture) -> vr::EVROverlayError override
+    {
+        const MockCallScope call("IVROverlay::SetOverlayTexture", MockArgumentBytes(handle, texture));
+        return Overlay_SetOverlayTexture(handle, texture);
+    }
+
+    auto ClearOverlayTexture(vr::VROverlayHandle_t) -> vr::EVROverlayError override { MockUnmocked("IVROverlay::ClearOverlayTexture"); }
+    auto SetOverlayRaw(vr::VROverlayHandle_t, void*, uint32_t, uint32_t, uint32_t) -> vr::EVROverlayError override { MockUnmocked("IVROverlay::SetOverlayRaw"); }
+
+    auto SetOverlayFromFile(vr::VROverlayHandle_t handle, const char* path) -> vr::EVROverlayError override
+    {
+        const MockCallScope call("IVROverlay::SetOverlayFromFile", MockArgumentBytes(handle, path));
+        return {};
+    }
+
+    auto GetOverlayTexture(vr::VROverlayHandle_t, void**, void*, uint32_t*, uint32_t*, uint32_t*, vr::ETextureType*, vr::EColorSpace*, vr::VRTextureBounds_t*) -> vr::EVROverlayError override { MockUnmocked("IVROverlay::GetOverlayTexture"); }
+    auto ReleaseNativeOverlayHandle(vr::VROverlayHandle_t, void*) -> vr::EVROverlayError override { MockUnmocked("IVROverlay::ReleaseNativeOverlayHandle"); }
+    auto GetOverlayTextureSize(vr::VROverlayHandle_t, uint32_t*, uint32_t*) -> vr::EVROverlayError override { MockUnmocked("IVROverlay::GetOverlayTextureSize"); }
+
+    auto CreateDashboardOverlay(const char* key, const char* name, vr::VROverlayHandle_t* handle, vr::VROverlayHandle_t* thumbnail_handle) -> vr::EVROverlayError override
+    {
+        const MockCallScope call("IVROverlay::CreateDashboardOverlay", MockArgumentBytes(key, name, handle, thumbnail_handle));
+        return Overlay_CreateDashboardOverlay(key, name, handle, thumbnail_handle);
+    }
+
+    auto IsDashboardVisible() -> bool override
+    {
+        const MockCallScope call("IVROverlay::IsDashboardVisible", 0);
+        return Overlay_IsDashboardVisible();
+    }
+
+    auto IsActiveDashboardOverlay(vr::VROverlayHandle_t) -> bool override { MockUnmocked("IVROverlay::IsActiveDashboardOverlay"); }
+    auto SetDashboardOverlaySceneProcess(vr::VROverlayHandle_t, uint32_t) -> vr::EVROverlayError override { MockUnmocked("IVROverlay::SetDashboardOverlaySceneProcess"); }
+    auto GetDashboardOverlaySceneProcess(vr::VROverlayHandle_t, uint32_t*) -> vr::EVROverlayError override { MockUnmocked("IVROverlay::GetDashboardOverlaySceneProcess"); }
+    auto ShowDashboard(const char*) -> void override { MockUnmocked("IVROverlay::ShowDashboard"); }
+    auto GetPrimaryDashboardDevice() -> vr::TrackedDeviceIndex_t override { MockUnmocked("IVROverlay::GetPrimaryDashboardDevice"); }
+    auto ShowKeyboard(vr::EGamepadTextInputMode, vr::EGamepadTextInputLineMode, uint32_t, const char*, uint32_t, const char*, uint64_t) -> vr::EVROverlayError override { MockUnmocked("IVROverlay::ShowKeyboard"); }
+
+    auto ShowKeyboardForOverlay(vr::VROverlayHandle_t handle, vr::EGamepadTextInputMode input_mode, vr::EGamepadTextInputLineMode line_mode, uint32_t flags, const char* description, uint32_t char_max, const char* existing_text, uint64_t user_value) -> vr::EVROverlayError override
+    {
+        const MockCallScope call("IVROverlay::ShowKeyboardForOverlay", MockArgumentBytes(handle, input_mode, line_mode, flags, description, char_max, existing_text, user_value));
+        return {};
+    }
+
+    auto GetKeyboardText(char*, uint32_t) -> uint32_t override { MockUnmocked("IVROverlay::GetKeyboardText"); }
+
+    auto HideKeyboard() -> void override
+    {
+        const MockCallScope call("IVROverlay::HideKeyboard", 0);
+    }
+
+    auto SetKeyboardTransformAbsolute(vr::ETrackingUniverseOrigin, const vr::HmdMatrix34_t*) -> void override { MockUnmocked("IVROverlay::SetKeyboardTransformAbsolute"); }
+    auto SetKeyboardPositionForOverlay(vr::VROverlayHandle_t, vr::HmdRect2_t) -> void override { MockUnmocked("IVROverlay::SetKeyboardPositionForOverlay"); }
+    auto ShowMessageOverlay(const char*, const char*, const char*, const char*, const char*, const char*) -> vr::VRMessageOverlayResponse override { MockUnmocked("IVROverlay::ShowMessageOverlay"); }
+    auto CloseMessageOverlay() -> void override { MockUnmocked("IVROverlay::CloseMessageOverlay"); }
+};
+
+class MockCompositor final : public vr::IVRCompositor {
+public:
+    auto SetTrackingSpace(vr::ETrackingUniverseOrigin) -> void override { MockUnmocked("IVRCompositor::SetTrackingSpace"); }
+    auto GetTrackingSpace() -> vr::ETrackingUniverseOrigin override { MockUnmocked("IVRCompositor::GetTrackingSpace"); }
+    auto WaitGetPoses(vr::TrackedDevicePose_t*, uint32_t, vr::TrackedDevicePose_t*, uint32_t) -> vr::EVRCompositorError override { MockUnmocked("IVRCompositor::WaitGetPoses"); }
+    auto GetLastPoses(vr::TrackedDevicePose_t*, uint32_t, vr::TrackedDevicePose_t*, uint32_t) -> vr::EVRCompositorError override { MockUnmocked("IVRCompositor::GetLastPoses"); }
+    auto GetLastPoseForTrackedDeviceIndex(vr::TrackedDeviceIndex_t, vr::TrackedDevicePose_t*, vr::TrackedDevicePose_t*) -> vr::EVRCompositorError override { MockUnmocked("IVRCompositor::GetLastPoseForTrackedDeviceIndex"); }
+    auto GetSubmitTexture(vr::Texture_t*, bool*, vr::EVREye, const vr::Texture_t*, const vr::VRTextureBounds_t*, vr::EVRSubmitFlags) -> vr::EVRCompositorError override { MockUnmocked("IVRCompositor::GetSubmitTexture"); }
+    auto Submit(vr::EVREye, const vr::Texture_t*, const vr::VRTextureBounds_t*, vr::EVRSubmitFlags) -> vr::EVRCompositorError override { MockUnmocked("IVRCompositor::Submit"); }
+    auto SubmitWithArrayIndex(vr::EVREye, const vr::Texture_t*, uint32_t, const vr::VRTextureBounds_t*, vr::EVRSubmitFlags) -> vr::EVRCompositorError override { MockUnmocked("IVRCompositor::SubmitWithArrayIndex"); }
+    auto ClearLastSubmittedFrame() -> void override { MockUnmocked("IVRCompositor::ClearLastSubmittedFrame"); }
+    auto PostPresentHandoff() -> void override { MockUnmocked("IVRCompositor::PostPresentHandoff"); }
+    auto GetFrameTiming(vr::Compositor_FrameTiming*, uint32_t) -> bool override { MockUnmocked("IVRCompositor::GetFrameTiming"); }
+    auto GetFrameTimings(vr::Compositor_FrameTiming*, uint32_t) -> uint32_t override { MockUnmocked("IVRCompositor::GetFrameTimings"); }
+    auto GetFrameTimeRemaining() -> float override { MockUnmocked("IVRCompositor::GetFrameTimeRemaining"); }
+    auto GetCumulativeStats(vr::Compositor_CumulativeStats*, uint32_t) -> void override { MockUnmocked("IVRCompositor::GetCumulativeStats"); }
+    auto FadeToColor(float, float, float, float, float, bool) -> void override { MockUnmocked("IVRCompositor::FadeToColor"); }
+    auto GetCurrentFadeColor(bool) -> vr::HmdColor_t override { MockUnmocked("IVRCompositor::GetCurrentFadeColor"); }
+    auto FadeGrid(float, bool) -> void override { MockUnmocked("IVRCompositor::FadeGrid"); }
+    auto GetCurrentGridAlpha() -> float override { MockUnmocked("IVRCompositor::GetCurrentGridAlpha"); }
+    auto SetSkyboxOverride(const vr::Texture_t*, uint32_t) -> vr::EVRCompositorError override { MockUnmocked("IVRCompositor::SetSkyboxOverride"); }
+    auto ClearSkyboxOverride() -> void override { MockUnmocked("IVRCompositor::ClearSkyboxOverride"); }
+    auto CompositorBringToFront() -> void override { MockUnmocked("IVRCompositor::CompositorBringToFront"); }
+    auto CompositorGoToBack() -> void override { MockUnmocked("IVRCompositor::CompositorGoToBack"); }
+    auto CompositorQuit() -> void override { MockUnmocked("IVRCompositor::CompositorQuit"); }
+    auto IsFullscreen() -> bool override { MockUnmocked("IVRCompositor::IsFullscreen"); }
+    auto GetCurrentSceneFocusProcess() -> uint32_t override { MockUnmocked("IVRCompositor::GetCurrentSceneFocusProcess"); }
+    auto GetLastFrameRenderer() -> uint32_t override { MockUnmocked("IVRCompositor::GetLastFrameRenderer"); }
+    auto CanRenderScene() -> bool override { MockUnmocked("IVRCompositor::CanRenderScene"); }
+    auto ShowMirrorWindow() -> void override { MockUnmocked("IVRCompositor::ShowMirrorWindow"); }
+    auto HideMirrorWindow() -> void override { MockUnmocked("IVRCompositor::HideMirrorWindow"); }
+    auto IsMirrorWindowVisible() -> bool override { MockUnmocked("IVRCompositor::IsMirrorWindowVisible"); }
+    auto CompositorDumpImages() -> void override { MockUnmocked("IVRCompositor::CompositorDumpImages"); }
+    auto ShouldAppRenderWithLowResources() -> bool override { MockUnmocked("IVRCompositor::ShouldAppRenderWithLowResources"); }
+    auto ForceInterleavedReprojectionOn(bool) -> void override { MockUnmocked("IVRCompositor::ForceInterleavedReprojectionOn"); }
+    auto ForceReconnectProcess() -> void override { MockUnmocked("IVRCompositor::ForceReconnectProcess"); }
+    auto SuspendRendering(bool) -> void override { MockUnmocked("IVRCompositor::SuspendRendering"); }
+    auto GetMirrorTextureD3D11(vr::EVREye, void*, void**) -> vr::EVRCompositorError override { MockUnmocked("IVRCompositor::GetMirrorTextureD3D11"); }
+    auto ReleaseMirrorTextureD3D11(void*) -> void override { MockUnmocked("IVRCompositor::ReleaseMirrorTextureD3D11"); }
+    auto GetMirrorTextureGL(vr::EVREye, vr::glUInt_t*, vr::glSharedTextureHandle_t*) -> vr::EVRCompositorError override { MockUnmocked("IVRCompositor::GetMirrorTextureGL"); }
+    auto ReleaseSharedGLTexture(vr::glUInt_t, vr::glSharedTextureHandle_t) -> bool override { MockUnmocked("IVRCompositor::ReleaseSharedGLTexture"); }
+    auto LockGLSharedTextureForAccess(vr::glSharedTextureHandle_t) -> void override { MockUnmocked("IVRCompositor::LockGLSharedTextureForAccess"); }
+    auto UnlockGLSharedTextureForAccess(vr::glSharedTextureHandle_t) -> void override { MockUnmocked("IVRCompositor::UnlockGLSharedTextureForAccess"); }
+
+    auto GetVulkanInstanceExtensionsRequired(char* buffer, uint32_t buffer_size) -> uint32_t override
+    {
+        const MockCallScope call("IVRCompositor::GetVulkanInstanceExtensionsRequired", MockArgumentBytes(buffer, buffer_size));
+        return Compositor_GetVulkanInstanceExtensionsRequired(buffer, buffer_size);
+    }
+
+    auto GetVulkanDeviceExtensionsRequired(VkPhysicalDevice_T* physical_device, char* buffer, uint32_t buffer_size) -> uint32_t override
+    {
+        const MockCallScope call("IVRCompositor::GetVulkanDeviceExtensionsRequired", MockArgumentBytes(physical_device, buffer, buffer_size));
+        return Compositor_GetVulkanDeviceExtensionsRequired(physical_device, buffer, buffer_size);
+    }
+
+    auto SetExplicitTimingMode(vr::EVRCompositorTimingMode) -> void override { MockUnmocked("IVRCompositor::SetExplicitTimingMode"); }
+    auto SubmitExplicitTimingData() -> vr::EVRCompositorError override { MockUnmocked("IVRCompositor::SubmitExplicitTimingData"); }
+    auto IsMotionSmoothingEnabled() -> bool override { MockUnmocked("IVRCompositor::IsMotionSmoothingEnabled"); }
+    auto IsMotionSmoothingSupported() -> bool override { MockUnmocked("IVRCompositor::IsMotionSmoothingSupported"); }
+    auto IsCurrentSceneFocusAppLoading() -> bool override { MockUnmocked("IVRCompositor::IsCurrentSceneFocusAppLoading"); }
+    auto SetStageOverride_Async(const char*, const vr::HmdMatrix34_t*, const vr::Compositor_StageRenderSettings*, uint32_t) -> vr::EVRCompositorError override { MockUnmocked("IVRCompositor::SetStageOverride_Async"); }
+    auto ClearStageOverride() -> void override { MockUnmocked("IVRCompositor::ClearStageOverride"); }
+    auto GetCompositorBenchmarkResults(vr::Compositor_BenchmarkResults*, uint32_t) -> bool override { MockUnmocked("IVRCompositor::GetCompositorBenchmarkResults"); }
+    auto GetLastPosePredictionIDs(uint32_t*, uint32_t*) -> vr::EVRCompositorError override { MockUnmocked("IVRCompositor::GetLastPosePredictionIDs"); }
+    auto GetPosesForFrame(uint32_t, vr::TrackedDevicePose_t*, uint32_t) -> vr::EVRCompositorError override { MockUnmocked("IVRCompositor::GetPosesForFrame"); }
+};
+
+class MockApplications final : public vr::IVRApplications {
+public:
+    auto AddApplicationManifest(const char* manifest_path, bool temporary) -> vr::EVRApplicationError override
+    {
+        const MockCallScope call("IVRApplications::AddApplicationManifest", MockArgumentBytes(manifest_path, temporary));
+        return {};
+    }
+
+    auto RemoveApplicationManifest(const char*) -> vr::EVRApplicationError override { MockUnmocked("IVRApplications::RemoveApplicationManifest"); }
+
+    auto IsApplicationInstalled(const char* app_key) -> bool override
+    {
+        const MockCallScope call("IVRApplications::IsApplicationInstalled", MockArgumentBytes(app_key));
+        return Applications_IsApplicationInstalled(app_key);
+    }
+
+    auto GetApplicationCount() -> uint32_t override { MockUnmocked("IVRApplications::GetApplicationCount"); }
+    auto GetApplicationKeyByIndex(uint32_t, char*, uint32_t) -> vr::EVRApplicationError override { MockUnmocked("IVRApplications::GetApplicationKeyByIndex"); }
+    auto GetApplicationKeyByProcessId(uint32_t, char*, uint32_t) -> vr::EVRApplicationError override { MockUnmocked("IVRApplications::GetApplicationKeyByProcessId"); }
+    auto LaunchApplication(const char*) -> vr::EVRApplicationError override { MockUnmocked("IVRApplications::LaunchApplication"); }
+    auto LaunchTemplateApplication(const char*, const char*, const vr::AppOverrideKeys_t*, uint32_t) -> vr::EVRApplicationError override { MockUnmocked("IVRApplications::LaunchTemplateApplication"); }
+    auto LaunchApplicationFromMimeType(const char*, const char*) -> vr::EVRApplicationError override { MockUnmocked("IVRApplications::LaunchApplicationFromMimeType"); }
+    auto LaunchDashboardOverlay(const char*) -> vr::EVRApplicationError override { MockUnmocked("IVRApplications::LaunchDashboardOverlay"); }
+    auto CancelApplicationLaunch(const char*) -> bool override { MockUnmocked("IVRApplications::CancelApplicationLaunch"); }
+    auto IdentifyApplication(uint32_t, const char*) -> vr::EVRApplicationError override { MockUnmocked("IVRApplications::IdentifyApplication"); }
+    auto GetApplicationProcessId(const char*) -> uint32_t override { MockUnmocked("IVRApplications::GetApplicationProcessId"); }
+    auto GetApplicationsErrorNameFromEnum(vr::EVRApplicationError) -> const char* override { MockUnmocked("IVRApplications::GetApplicationsErrorNameFromEnum"); }
+    auto GetApplicationPropertyString(const char*, vr::EVRApplicationProperty, char*, uint32_t, vr::EVRApplicationError*) -> uint32_t override { MockUnmocked("IVRApplications::GetApplicationPropertyString"); }
+    auto GetApplicationPropertyBool(const char*, vr::EVRApplicationProperty, vr::EVRApplicationError*) -> bool override { MockUnmocked("IVRApplications::GetApplicationPropertyBool"); }
+    auto GetApplicationPropertyUint64(const char*, vr::EVRApplicationProperty, vr::EVRApplicationError*) -> uint64_t override { MockUnmocked("IVRApplications::GetApplicationPropertyUint64"); }
+    auto SetApplicationAutoLaunch(const char*, bool) -> vr::EVRApplicationError override { MockUnmocked("IVRApplications::SetApplicationAutoLaunch"); }
+    auto GetApplicationAutoLaunch(const char*) -> bool override { MockUnmocked("IVRApplications::GetApplicationAutoLaunch"); }
+    auto SetDefaultApplicationForMimeType(const char*, const char*) -> vr::EVRApplicationError override { MockUnmocked("IVRApplications::SetDefaultApplicationForMimeType"); }
+    auto GetDefaultApplicationForMimeType(const char*, char*, uint32_t) -> bool override { MockUnmocked("IVRApplications::GetDefaultApplicationForMimeType"); }
+    auto GetApplicationSupportedMimeTypes(const char*, char*, uint32_t) -> bool override { MockUnmocked("IVRApplications::GetApplicationSupportedMimeTypes"); }
+    auto GetApplicationsThatSupportMimeType(const char*, char*, uint32_t) -> uint32_t override { MockUnmocked("IVRApplications::GetApplicationsThatSupportMimeType"); }
+    auto GetApplicationLaunchArguments(uint32_t, char*, uint32_t) -> uint32_t override { MockUnmocked("IVRApplications::GetApplicationLaunchArguments"); }
+    auto GetStartingApplication(char*, uint32_t) -> vr::EVRApplicationError override { MockUnmocked("IVRApplications::GetStartingApplication"); }
+    auto GetSceneApplicationState() -> vr::EVRSceneApplicationState override { MockUnmocked("IVRApplications::GetSceneApplicationState"); }
+    auto PerformApplicationPrelaunchCheck(const char*) -> vr::EVRApplicationError override { MockUnmocked("IVRApplications::PerformApplicationPrelaunchCheck"); }
+    auto GetSceneApplicationStateNameFromEnum(vr::EVRSceneApplicationState) -> const char* override { MockUnmocked("IVRApplications::GetSceneApplicationStateNameFromEnum"); }
+    auto LaunchInternalProcess(const char*, const char*, const char*) -> vr::EVRApplicationError override { MockUnmocked("IVRApplications::LaunchInternalProcess"); }
+    auto GetCurrentSceneProcessId() -> uint32_t override { MockUnmocked("IVRApplications::GetCurrentSceneProcessId"); }
+};
+
+auto MockOpenVR::SetTime(uint64_t time_ns) -> void
+{
+    std::lock_guard<std::mutex> lock(Runtime().mutex);
+    Runtime().manual_time = true;
+    Runtime().time_ns = time_ns;
+}
+
+auto MockOpenVR::Now() -> uint64_t
+{
+    std::lock_guard<std::mutex> lock(Runtime().mutex);
+    return NowLocked();
+}
+
+auto MockOpenVR::SetCallLatency(uint64_t latency_ns) -> void
+{
+    std::lock_guard<std::mutex> lock(Runtime().mutex);
+    Runtime().call_latency_ns = latency_ns;
+}
+
+auto MockOpenVR::SetCallLatency(const char* method, uint64_t latency_ns) -> void
+{
+    std::lock_guard<std::mutex> lock(Runtime().mutex);
+    Runtime().method_latency_ns.insert_or_assign(std::string(method), latency_ns);
+}
+
+auto MockOpenVR::SetCallLog(bool enabled) -> void
+{
+    std::lock_guard<std::mutex> lock(Runtime().mutex);
+    Runtime().call_log_enabled = enabled;
+}
+
+auto MockOpenVR::SetRefreshRate(float refresh_rate) -> void
+{
+    std::lock_guard<std::mutex> lock(Runtime().mutex);
+    Runtime().refresh_rate = refresh_rate;
+}
+
+auto MockOpenVR::SetDashboardVisible(bool visible) -> void
+{
+    std::lock_guard<std::mutex> lock(Runtime().mutex);
+    Runtime().dashboard_visible = visible;
+}
+
+auto MockOpenVR::SetOverlayVisible(vr::VROverlayHandle_t handle, bool visible) -> void
+{
+    std::lock_guard<std::mutex> lock(Runtime().mutex);
+    auto overlay = Runtime().overlays.find(handle);
+    if (overlay == Runtime().overlays.end() || overlay->second.visible == visible)
+        return;
+
+    overlay->second.visible = visible;
+
+    vr::VREvent_t event = {};
+    event.eventType = visible ? vr::VREvent_OverlayShown : vr::VREvent_OverlayHidden;
+    overlay->second.events.push_back(event);
+}
+
+auto MockOpenVR::QueueEvent(vr::VROverlayHandle_t handle, const vr::VREvent_t& event) -> void
+{
+    std::lock_guard<std::mutex> lock(Runtime().mutex);
+    auto overlay = Runtime().overlays.find(handle);
+    if (overlay != Runtime().overlays.end())
+        overlay->second.events.push_back(event);
+}
+
+auto MockOpenVR::QueueMouseMove(vr::VROverlayHandle_t handle, float x, float y) -> void
+{
+    vr::VREvent_t event = {};
+    event.eventType = vr::VREvent_MouseMove;
+    event.data.mouse.x = x;
+    event.data.mouse.y = y;
+    MockOpenVR::QueueEvent(handle, event);
+}
+
+auto MockOpenVR::QueueMouseButton(vr::VROverlayHandle_t handle, uint32_t button, bool down) -> void
+{
+    vr::VREvent_t event = {};
+    event.eventType = down ? vr::VREvent_MouseButtonDown : vr::VREvent_MouseButtonUp;
+    event.data.mouse.button = button;
+    MockOpenVR::QueueEvent(handle, event);
+}
+
+auto MockOpenVR::QueueScroll(vr::VROverlayHandle_t handle, float x_delta, float y_delta) -> void
+{
+    vr::VREvent_t event = {};
+    event.eventType = vr::VREvent_ScrollSmooth;
+    event.data.scroll.xdelta = x_delta;
+    event.data.scroll.ydelta = y_delta;
+    MockOpenVR::QueueEvent(handle, event);
+}
+
+auto MockOpenVR::QueueKeyboardInput(vr::VROverlayHandle_t handle, const char* text) -> void
+{
+    // The compositor sends at most 8 bytes of input per event
+    for (size_t offset = 0; text[offset] != '\0';) {
+        vr::VREvent_t event = {};
+        event.eventType = vr::VREvent_KeyboardCharInput;
+
+        const size_t length = std::min(strlen(text + offset), sizeof(event.data.keyboard.cNewInput) - 1);
+        std::memcpy(event.data.keyboard.cNewInput, text + offset, length);
+        offset += length;
+
+        MockOpenVR::QueueEvent(handle, event);
+    }
+}
+
+auto MockOpenVR::QueuePropertyChanged(vr::VROverlayHandle_t handle, vr::TrackedDeviceIndex_t device, vr::ETrackedDeviceProperty property) -> void
+{
+    vr::VREvent_t event = {};
+    event.eventType = vr::VREvent_PropertyChanged;
+    event.trackedDeviceIndex = device;
+    event.data.property.prop = property;
+    MockOpenVR::QueueEvent(handle, event);
+}
+
+auto MockOpenVR::AddEventStream(vr::VROverlayHandle_t handle, const MockEventStream& stream) -> void
+{
+    std::lock_guard<std::mutex> lock(Runtime().mutex);
+    auto overlay = Runtime().overlays.find(handle);
+    if (overlay == Runtime().overlays.end())
+        return;
+
+    overlay->second.streams.push_back(stream);
+    overlay->second.streams_generated.push_back(0);
+    overlay->second.streams_start_ns.push_back(NowLocked());
+}
+
+auto MockOpenVR::ClearEventStreams(vr::VROverlayHandle_t handle) -> void
+{
+    std::lock_guard<std::mutex> lock(Runtime().mutex);
+    auto overlay = Runtime().overlays.find(handle);
+    if (overlay == Runtime().overlays.end())
+        return;
+
+    overlay->second.streams.clear();
+    overlay->second.streams_generated.clear();
+    overlay->second.streams_start_ns.clear();
+}
+
+auto MockOpenVR::Stats() -> MockOpenVRStats
+{
+    std::lock_guard<std::mutex> lock(Runtime().mutex);
+    return Runtime().stats;
+}
+
+auto MockOpenVR::MethodStats() -> std::vector<MockOpenVRMethodStats>
+{
+    std::vector<MockOpenVRMethodStats> result = {};
+    {
+        std::lock_guard<std::mutex> lock(Runtime().mutex);
+        result.reserve(Runtime().method_stats.size());
+        for (const auto& [method, stats] : Runtime().method_stats)
+            result.push_back(stats);
+    }
+
+    std::ranges::sort(result, [](const MockOpenVRMethodStats& a, const MockOpenVRMethodStats& b) { return a.calls > b.calls; });
+    return result;
+}
+
+auto MockOpenVR::CallLog() -> std::vector<MockOpenVRCall>
+{
+    std::lock_guard<std::mutex> lock(Runtime().mutex);
+    return Runtime().call_log;
+}
+
+auto MockOpenVR::ResetStats() -> void
+{
+    std::lock_guard<std::mutex> lock(Runtime().mutex);
+    Runtime().stats = {};
+    Runtime().method_stats.clear();
+    Runtime().call_log.clear();
+}
+
+// Entry points normally exported by openvr_api, the inline helpers in openvr.h go through these.
+namespace vr {
+
+uint32_t VR_CALLTYPE VR_InitInternal2(EVRInitError* error, [[maybe_unused]] EVRApplicationType application_type, [[maybe_unused]] const char* startup_info)
+{
+    if (error != nullptr)
+        *error = VRInitError_None;
+
+    std::lock_guard<std::mutex> lock(Runtime().mutex);
+    return ++Runtime().init_token;
+}
+
+void VR_CALLTYPE VR_ShutdownInternal()
+{
+    std::lock_guard<std::mutex> lock(Runtime().mutex);
+    Runtime().init_token++;
+}
+
+uint32_t VR_CALLTYPE VR_GetInitToken()
+{
+    std::lock_guard<std::mutex> lock(Runtime().mutex);
+    return Runtime().init_token;
+}
+
+void* VR_CALLTYPE VR_GetGenericInterface(const char* interface_version, EVRInitError* error)
+{
+    static MockSystem system;
+    static MockOverlay overlay;
+    static MockCompositor compositor;
+    static MockApplications applications;
+
+    void* result = nullptr;
+
+    if (strcmp(interface_version, IVRSystem_Version) == 0)
+        result = static_cast<IVRSystem*>(&system);
+    else if (strcmp(interface_version, IVROverlay_Version) == 0)
+        result = static_cast<IVROverlay*>(&overlay);
+    else if (strcmp(interface_version, IVRCompositor_Version) == 0)
+        result = static_cast<IVRCompositor*>(&compositor);
+    else if (strcmp(interface_version, IVRApplications_Version) == 0)
+        result = static_cast<IVRApplications*>(&applications);
+
+    if (error != nullptr)
+        *error = result != nullptr ? VRInitError_None : VRInitError_Init_InterfaceNotFound;
+    return result;
+}
+
+bool VR_CALLTYPE VR_IsInterfaceVersionValid(const char* interface_version)
+{
+    return strcmp(interface_version, IVRSystem_Version) == 0
+        || strcmp(interface_version, IVROverlay_Version) == 0
+        || strcmp(interface_version, IVRCompositor_Version) == 0
+        || strcmp(interface_version, IVRApplications_Version) == 0;
+}
+
+bool VR_CALLTYPE VR_IsHmdPresent()
+{
+    return true;
+}
+
+bool VR_CALLTYPE VR_IsRuntimeInstalled()
+{
+    return true;
+}
+
+const char* VR_CALLTYPE VR_GetVRInitErrorAsSymbol(EVRInitError error)
+{
+    return error == VRInitError_None ? "VRInitError_None" : "VRInitError_Unknown";
+}
+
+const char* VR_CALLTYPE VR_GetVRInitErrorAsEnglishDescription(EVRInitError error)
+{
+    return error == VRInitError_None ? "No Error (0)" : "Mock OpenVR runtime error";
+}
+
+}
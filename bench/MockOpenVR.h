@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2025. Nyabsi <nyabsi@sovellus.cc>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <openvr.h>
+
+struct MockOpenVRStats
+{
+    uint64_t calls;             // every call into a mock interface, each one a round trip to the compositor for real
+    uint64_t texture_submits;
+    uint64_t events_polled;
+    uint64_t events_generated;  // produced by event streams
+    uint64_t overlays_created;
+};
+
+struct MockOpenVRCall
+{
+    uint64_t timestamp_ns;      // mock clock when the call was made
+    const char* method;         // "IVROverlay::PollNextOverlayEvent"
+    uint32_t argument_bytes;    // arguments plus the structures and strings they point to
+    uint64_t duration_ns;       // including the simulated latency
+};
+
+struct MockOpenVRMethodStats
+{
+    const char* method;
+    uint64_t calls;
+    uint64_t argument_bytes;
+    uint64_t duration_ns;
+};
+
+enum MockEventStreamType
+{
+    MockEventStream_MouseMove = 0,  // laser sweeping a circle over the overlay
+    MockEventStream_Scroll,         // smooth scrolling back and forth
+    MockEventStream_Keyboard,       // VREvent_KeyboardCharInput typing a sentence
+    MockEventStream_PropertyChanged // Prop_DisplayFrequency_Float changing on the HMD
+};
+
+struct MockEventStream
+{
+    MockEventStreamType type;
+    double rate_hz;
+    float width;    // MouseMove: overlay mouse scale the sweep covers
+    float height;
+};
+
+// In-process stand-in for the OpenVR runtime. Linking MockOpenVR.cpp provides the VR_* entry points
+// openvr_api normally exports, so vr::VROverlay(), vr::VRSystem(), vr::VRCompositor() and
+// vr::VRApplications() hand out mock interfaces and the code under test runs unmodified without SteamVR.
+// The mocks subclass the interfaces of the pinned openvr.h, methods this project doesn't call abort with their name.
+class MockOpenVR {
+public:
+    // Switches from the steady clock to a manual one, time then only moves through SetTime and
+    // simulated latency which makes event streams and vsync timing reproducible.
+    static auto SetTime(uint64_t time_ns) -> void;
+    [[nodiscard]] static auto Now() -> uint64_t;
+
+    // Every call spends this long before it returns, like the IPC round trip to vrserver would
+    static auto SetCallLatency(uint64_t latency_ns) -> void;
+    static auto SetCallLatency(const char* method, uint64_t latency_ns) -> void;
+    // Keeps every call in a log on top of the per method totals
+    static auto SetCallLog(bool enabled) -> void;
+
+    static auto SetRefreshRate(float refresh_rate) -> void;
+    static auto SetDashboardVisible(bool visible) -> void;
+    // Changes the visibility like the user opening or closing the overlay would, including the event
+    static auto SetOverlayVisible(vr::VROverlayHandle_t handle, bool visible) -> void;
+
+    static auto QueueEvent(vr::VROverlayHandle_t handle, const vr::VREvent_t& event) -> void;
+    // Coordinates are in overlay mouse space, bottom left is 0,0 like the compositor sends them
+    static auto QueueMouseMove(vr::VROverlayHandle_t handle, float x, float y) -> void;
+    static auto QueueMouseButton(vr::VROverlayHandle_t handle, uint32_t button, bool down) -> void;
+    static auto QueueScroll(vr::VROverlayHandle_t handle, float x_delta, float y_delta) -> void;
+    static auto QueueKeyboardInput(vr::VROverlayHandle_t handle, const char* text) -> void;
+    static auto QueuePropertyChanged(vr::VROverlayHandle_t handle, vr::TrackedDeviceIndex_t device, vr::ETrackedDeviceProperty property) -> void;
+
+    // Streams produce their events from the mock clock whenever the overlay is polled, so the rate holds
+    // no matter how often the application polls. At most one second worth of events is kept back.
+    static auto AddEventStream(vr::VROverlayHandle_t handle, const MockEventStream& stream) -> void;
+    static auto ClearEventStreams(vr::VROverlayHandle_t handle) -> void;
+
+    [[nodiscard]] static auto Stats() -> MockOpenVRStats;
+    // Sorted by number of calls, most called first
+    [[nodiscard]] static auto MethodStats() -> std::vector<MockOpenVRMethodStats>;
+    [[nodiscard]] static auto CallLog() -> std::vector<MockOpenVRCall>;
+    // Clears the stats, the per method totals and the call log
+    static auto ResetStats() -> void;
+};
@@ -69,6 +69,14 @@ if (OpenVR_FOUND)
                 INTERFACE_INCLUDE_DIRECTORIES "${OpenVR_INCLUDE_DIR}")
     endif ()
 
+    # Headers without the client DLL, for code whose VR_* entry points come from elsewhere.
+    if (NOT TARGET OpenVR::Headers)
+        add_library(OpenVR::Headers INTERFACE IMPORTED)
+        set_target_properties(OpenVR::Headers
+            PROPERTIES
+                INTERFACE_INCLUDE_DIRECTORIES "${OpenVR_INCLUDE_DIR}")
+    endif ()
+
     # OpenVR Driver API is header only.
     if (NOT TARGET OpenVR::Driver)
         add_library(OpenVR::Driver INTERFACE IMPORTED)
@@ -0,0 +1,141 @@
+/*
+ * Copyright (C) 2025. Nyabsi <nyabsi@sovellus.cc>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "DrawDataSnapshot.h"
+
+#include <algorithm>
+#include <cstring>
+
+static constexpr size_t ARENA_ALIGNMENT = 16;
+static constexpr size_t ARENA_MINIMUM_CAPACITY = 64 * 1024;
+
+static auto AlignArena(size_t size) -> size_t
+{
+    return (size + ARENA_ALIGNMENT - 1) & ~(ARENA_ALIGNMENT - 1);
+}
+
+template <typename T>
+static auto PointInto(ImVector<T>& vector, uint8_t* data, int size) -> void
+{
+    vector.Data = reinterpret_cast<T*>(data);
+    vector.Size = vector.Capacity = size;
+}
+
+DrawDataSnapshot::DrawDataSnapshot()
+{
+    draw_data_.Clear();
+    draw_lists_.clear();
+    arena_ = nullptr;
+    arena_capacity_ = 0;
+    stats_ = {};
+}
+
+DrawDataSnapshot::~DrawDataSnapshot()
+{
+    for (ImDrawList* draw_list : draw_lists_) {
+        DetachDrawList(draw_list);
+        IM_DELETE(draw_list);
+    }
+
+    IM_FREE(arena_);
+}
+
+auto DrawDataSnapshot::Copy(const ImDrawData* source) -> void
+{
+    this->Clear();
+
+    if (source == nullptr || !source->Valid)
+        return;
+
+    stats_.copies++;
+
+    size_t required = 0;
+    for (const ImDrawList* source_list : source->CmdLists)
+        required += AlignArena(source_list->CmdBuffer.size_in_bytes()) + AlignArena(source_list->IdxBuffer.size_in_bytes()) + AlignArena(source_list->VtxBuffer.size_in_bytes());
+
+    if (required > arena_capacity_) {
+        for (ImDrawList* draw_list : draw_lists_)
+            DetachDrawList(draw_list);
+
+        IM_FREE(arena_);
+        arena_capacity_ = std::max({ required + required / 2, arena_capacity_ * 2, ARENA_MINIMUM_CAPACITY });
+        arena_ = static_cast<uint8_t*>(IM_ALLOC(arena_capacity_));
+
+        stats_.arena_allocations++;
+    }
+
+    while (draw_lists_.Size < source->CmdListsCount)
+        draw_lists_.push_back(IM_NEW(ImDrawList)(nullptr));
+
+    draw_data_.Valid = true;
+    draw_data_.CmdListsCount = source->CmdListsCount;
+    draw_data_.TotalIdxCount = source->TotalIdxCount;
+    draw_data_.TotalVtxCount = source->TotalVtxCount;
+    draw_data_.DisplayPos = source->DisplayPos;
+    draw_data_.DisplaySize = source->DisplaySize;
+    draw_data_.FramebufferScale = source->FramebufferScale;
+    draw_data_.OwnerViewport = source->OwnerViewport;
+    draw_data_.Textures = nullptr;
+    draw_data_.CmdLists.resize(source->CmdListsCount);
+
+    size_t offset = 0;
+
+    for (int n = 0; n < source->CmdListsCount; n++) {
+        const ImDrawList* source_list = source->CmdLists[n];
+        ImDrawList* draw_list = draw_lists_[n];
+
+        const size_t cmd_size = source_list->CmdBuffer.size_in_bytes();
+        const size_t idx_size = source_list->IdxBuffer.size_in_bytes();
+        const size_t vtx_size = source_list->VtxBuffer.size_in_bytes();
+
+        uint8_t* cmd_data = arena_ + offset;
+        uint8_t* idx_data = cmd_data + AlignArena(cmd_size);
+        uint8_t* vtx_data = idx_data + AlignArena(idx_size);
+
+        // Commands are few next to the geometry and get their textures resolved, they are always rewritten
+        const ImDrawCmd* source_cmds = source_list->CmdBuffer.Data;
+        ImDrawCmd* cmds = reinterpret_cast<ImDrawCmd*>(cmd_data);
+
+        for (int i = 0; i < source_list->CmdBuffer.Size; i++) {
+            cmds[i] = source_cmds[i];
+            cmds[i].TexRef = ImTextureRef(source_cmds[i].GetTexID());
+        }
+
+        if (idx_size > 0)
+            memcpy(idx_data, source_list->IdxBuffer.Data, idx_size);
+        if (vtx_size > 0)
+            memcpy(vtx_data, source_list->VtxBuffer.Data, vtx_size);
+        stats_.bytes_copied += cmd_size + idx_size + vtx_size;
+
+        PointInto(draw_list->CmdBuffer, cmd_data, source_list->CmdBuffer.Size);
+        PointInto(draw_list->IdxBuffer, idx_data, source_list->IdxBuffer.Size);
+        PointInto(draw_list->VtxBuffer, vtx_data, source_list->VtxBuffer.Size);
+        draw_list->Flags = source_list->Flags;
+
+        draw_data_.CmdLists[n] = draw_list;
+        offset = static_cast<size_t>(vtx_data - arena_) + AlignArena(vtx_size);
+    }
+}
+
+auto DrawDataSnapshot::Clear() -> void
+{
+    // Keeps the capacity of CmdLists and the arena, ImDrawData::Clear() would free the former
+    draw_data_.Valid = false;
+    draw_data_.CmdListsCount = 0;
+    draw_data_.TotalIdxCount = 0;
+    draw_data_.TotalVtxCount = 0;
+    draw_data_.CmdLists.resize(0);
+    draw_data_.Textures = nullptr;
+}
+
+auto DrawDataSnapshot::DetachDrawList(ImDrawList* draw_list) -> void
+{
+    PointInto(draw_list->CmdBuffer, nullptr, 0);
+    PointInto(draw_list->IdxBuffer, nullptr, 0);
+    PointInto(draw_list->VtxBuffer, nullptr, 0);
+}
@@ -0,0 +1,57 @@
+/*
+ * Copyright (C) 2025. Nyabsi <nyabsi@sovellus.cc>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <imgui.h>
+
+struct DrawDataSnapshotStats
+{
+    uint64_t copies;
+    uint64_t arena_allocations;
+    uint64_t bytes_copied;
+};
+
+// Owned copy of an ImDrawData that stays valid after ImGui starts the next frame and reuses the draw list
+// buffers, the unit handed from the UI thread to the render thread.
+//
+// The commands, indices and vertices of every draw list live in one bump arena. The arena only grows when a
+// frame needs more than it ever did, so copying a frame allocates nothing in steady state. Commands are rewritten
+// with their texture resolved to an ImTextureID so the renderer never reads ImTextureData, which belongs to the
+// UI thread.
+class DrawDataSnapshot {
+public:
+    explicit DrawDataSnapshot();
+    ~DrawDataSnapshot();
+
+    DrawDataSnapshot(const DrawDataSnapshot&) = delete;
+    DrawDataSnapshot& operator=(const DrawDataSnapshot&) = delete;
+
+    // Textures is left empty, the texture requests of the frame have to be handled by the caller beforehand
+    auto Copy(const ImDrawData* source) -> void;
+    auto Clear() -> void;
+
+    [[nodiscard]] auto DrawData() -> ImDrawData* { return draw_data_.Valid ? &draw_data_ : nullptr; }
+    [[nodiscard]] auto ArenaCapacity() const -> size_t { return arena_capacity_; }
+    [[nodiscard]] auto Stats() const -> const DrawDataSnapshotStats& { return stats_; }
+
+private:
+    // Points the buffers of the draw list back at nothing, the arena is not theirs to free
+    static auto DetachDrawList(ImDrawList* draw_list) -> void;
+
+    ImDrawData draw_data_;
+    ImVector<ImDrawList*> draw_lists_;
+
+    uint8_t* arena_;
+    size_t arena_capacity_;
+
+    DrawDataSnapshotStats stats_;
+};
@@ -0,0 +1,227 @@
+/*
+ * Copyright (C) 2025. Nyabsi <nyabsi@sovellus.cc>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "FramePacer.h"
+
+#include <algorithm>
+
+#include <openvr.h>
+#include <SDL3/SDL.h>
+
+#include "Profiler.h"
+
+// How often WaitFrameSync is retried after the compositor refused it, in frames
+static constexpr uint32_t FRAME_SYNC_RETRY_INTERVAL = 90;
+// Fraction of the measured wake up error fed back into the PLL correction every frame
+static constexpr double PLL_GAIN = 0.25;
+// How long an observed vsync is extrapolated from before TimeSinceLastVsync gives up on it
+static constexpr uint64_t VSYNC_MAX_AGE_NS = 1000000000;
+
+auto OpenVRFrameClock::Now() -> uint64_t
+{
+    return SDL_GetTicksNS();
+}
+
+auto OpenVRFrameClock::SleepUntil(uint64_t time_ns) -> void
+{
+    const uint64_t now = SDL_GetTicksNS();
+    if (time_ns > now)
+        SDL_DelayPrecise(time_ns - now);
+}
+
+auto OpenVRFrameClock::WaitFrameSync(uint32_t timeout_ms) -> bool
+{
+    return vr::VROverlay()->WaitFrameSync(timeout_ms) == vr::VROverlayError_None;
+}
+
+auto OpenVRFrameClock::TimeSinceLastVsync(uint64_t* since_ns, uint64_t* frame_counter) -> bool
+{
+    float seconds_since_last_vsync = {};
+    if (!vr::VRSystem()->GetTimeSinceLastVsync(&seconds_since_last_vsync, frame_counter))
+        return false;
+
+    *since_ns = static_cast<uint64_t>(std::max(seconds_since_last_vsync, 0.0f) * 1e9);
+    return true;
+}
+
+auto SimulatedFrameClock::WaitFrameSync([[maybe_unused]] uint32_t timeout_ms) -> bool
+{
+    if (!frame_sync_)
+        return false;
+
+    now_ns_ = phase_ns_ + (this->FrameCounter() + 1) * period_ns_;
+    return true;
+}
+
+auto SimulatedFrameClock::TimeSinceLastVsync(uint64_t* since_ns, uint64_t* frame_counter) -> bool
+{
+    if (!vsync_timing_ || now_ns_ < phase_ns_)
+        return false;
+
+    *since_ns = (now_ns_ - phase_ns_) % period_ns_;
+    *frame_counter = this->FrameCounter();
+    return true;
+}
+
+FramePacer::FramePacer(FrameClock& clock)
+    : clock_(clock)
+{
+    stats_ = {};
+    period_ns_ = static_cast<uint64_t>(1e9 / 90.0);
+    phase_offset_ns_ = 0;
+    pll_grid_ns_ = 0;
+    pll_correction_ns_ = 0;
+    last_frame_counter_ = 0;
+    has_frame_counter_ = false;
+    frame_sync_retry_ = 0;
+    vsync_ns_ = UINT64_MAX;
+}
+
+auto FramePacer::SetRefreshRate(float refresh_rate) -> void
+{
+    if (refresh_rate <= 0.0f)
+        return;
+
+    period_ns_ = static_cast<uint64_t>(1e9 / static_cast<double>(refresh_rate));
+}
+
+auto FramePacer::SetPhaseOffset(double seconds) -> void
+{
+    phase_offset_ns_ = static_cast<int64_t>(seconds * 1e9);
+}
+
+auto FramePacer::Wait() -> void
+{
+    PROFILE_SCOPE("Frame pacing");
+
+    stats_.frames++;
+
+    // The compositor itself tells us when its frame starts, nothing to predict.
+    if (frame_sync_retry_ == 0) {
+        const uint32_t timeout_ms = static_cast<uint32_t>(period_ns_ * 2 / 1000000) + 1;
+
+        if (clock_.WaitFrameSync(timeout_ms)) {
+            stats_.mode = FramePacerMode_FrameSync;
+
+            if (phase_offset_ns_ > 0)
+                clock_.SleepUntil(clock_.Now() + static_cast<uint64_t>(phase_offset_ns_));
+
+            uint64_t since_vsync_ns = {};
+            uint64_t frame_counter = {};
+            if (clock_.TimeSinceLastVsync(&since_vsync_ns, &frame_counter)) {
+                const uint64_t now = clock_.Now();
+                vsync_ns_ = now - std::min(since_vsync_ns, now);
+                this->CountFrames(frame_counter);
+                stats_.phase_error_ms = (static_cast<double>(since_vsync_ns) - static_cast<double>(std::max<int64_t>(phase_offset_ns_, 0))) / 1e6;
+            }
+
+            pll_grid_ns_ = clock_.Now() + period_ns_;
+            return;
+        }
+
+        frame_sync_retry_ = FRAME_SYNC_RETRY_INTERVAL;
+    }
+    else {
+        frame_sync_retry_--;
+    }
+
+    uint64_t since_vsync_ns = {};
+    uint64_t frame_counter = {};
+    if (clock_.TimeSinceLastVsync(&since_vsync_ns, &frame_counter)) {
+        stats_.mode = FramePacerMode_VsyncTiming;
+        this->WaitVsyncTiming(since_vsync_ns, frame_counter);
+        return;
+    }
+
+    stats_.mode = FramePacerMode_PLL;
+    vsync_ns_ = UINT64_MAX;
+    this->WaitPLL();
+}
+
+auto FramePacer::Reset() -> void
+{
+    pll_grid_ns_ = 0;
+    has_frame_counter_ = false;
+    vsync_ns_ = UINT64_MAX;
+}
+
+auto FramePacer::TimeSinceLastVsync(uint64_t* since_ns) const -> bool
+{
+    const uint64_t now = clock_.Now();
+    if (now < vsync_ns_ || now - vsync_ns_ > VSYNC_MAX_AGE_NS)
+        return false;
+
+    *since_ns = (now - vsync_ns_) % period_ns_;
+    return true;
+}
+
+auto FramePacer::WaitVsyncTiming(uint64_t since_vsync_ns, uint64_t frame_counter) -> void
+{
+    const uint64_t now = clock_.Now();
+    const uint64_t last_vsync = now - std::min(since_vsync_ns, now);
+    const int64_t period = static_cast<int64_t>(period_ns_);
+
+    vsync_ns_ = last_vsync;
+
+    // Aim for the first vsync + phase offset still ahead of us. With a negative offset the target
+    // lies before the vsync it belongs to, so start counting from the next vsync.
+    uint64_t vsyncs_ahead = phase_offset_ns_ < 0 ? 1 : 0;
+    while (static_cast<int64_t>(last_vsync) + static_cast<int64_t>(vsyncs_ahead) * period + phase_offset_ns_ <= static_cast<int64_t>(now))
+        vsyncs_ahead++;
+
+    // Never build twice for the same compositor frame.
+    if (has_frame_counter_ && frame_counter + vsyncs_ahead <= last_frame_counter_)
+        vsyncs_ahead = last_frame_counter_ - frame_counter + 1;
+
+    const uint64_t target = static_cast<uint64_t>(static_cast<int64_t>(last_vsync) + static_cast<int64_t>(vsyncs_ahead) * period + phase_offset_ns_);
+    clock_.SleepUntil(target);
+
+    this->CountFrames(frame_counter + vsyncs_ahead);
+
+    stats_.phase_error_ms = static_cast<double>(static_cast<int64_t>(clock_.Now()) - static_cast<int64_t>(target)) / 1e6;
+    pll_grid_ns_ = target + period_ns_;
+}
+
+auto FramePacer::WaitPLL() -> void
+{
+    const uint64_t now = clock_.Now();
+
+    if (pll_grid_ns_ == 0)
+        pll_grid_ns_ = now + period_ns_;
+
+    // Deadlines are absolute and advance by exactly one period, so unlike sleeping for
+    // "period minus frame time" the schedule does not drift with every late wake up.
+    if (now > pll_grid_ns_ + period_ns_) {
+        const uint64_t late_frames = (now - pll_grid_ns_) / period_ns_;
+        stats_.missed_frames += late_frames;
+        pll_grid_ns_ += late_frames * period_ns_;
+    }
+
+    const int64_t wake_up = static_cast<int64_t>(pll_grid_ns_) - pll_correction_ns_;
+    clock_.SleepUntil(static_cast<uint64_t>(std::max<int64_t>(wake_up, 0)));
+
+    // Learn the sleep overshoot so the average wake up lands on the grid.
+    const int64_t error = static_cast<int64_t>(clock_.Now()) - static_cast<int64_t>(pll_grid_ns_);
+    pll_correction_ns_ = std::clamp<int64_t>(pll_correction_ns_ + static_cast<int64_t>(error * PLL_GAIN), 0, static_cast<int64_t>(period_ns_ / 2));
+
+    stats_.phase_error_ms = static_cast<double>(error) / 1e6;
+    pll_grid_ns_ += period_ns_;
+}
+
+auto FramePacer::CountFrames(uint64_t frame_counter) -> void
+{
+    if (has_frame_counter_) {
+        if (frame_counter == last_frame_counter_)
+            stats_.duplicated_frames++;
+        else if (frame_counter > last_frame_counter_ + 1)
+            stats_.missed_frames += frame_counter - last_frame_counter_ - 1;
+    }
+
+    last_frame_counter_ = frame_counter;
+    has_frame_counter_ = true;
+}
@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2025. Nyabsi <nyabsi@sovellus.cc>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+// Time source the pacer is driven by, the OpenVR implementation talks to the compositor while
+// SimulatedFrameClock runs a fake compositor so pacing can be exercised without SteamVR, the bench's
+// pace_* scenes do that.
+class FrameClock {
+public:
+    virtual ~FrameClock() = default;
+
+    // Monotonic time in nanoseconds
+    virtual auto Now() -> uint64_t = 0;
+    virtual auto SleepUntil(uint64_t time_ns) -> void = 0;
+    // Blocks until the compositor starts its next frame, false if the compositor cannot do this
+    virtual auto WaitFrameSync(uint32_t timeout_ms) -> bool = 0;
+    // Time since the last vsync and the compositor frame counter, false if not available
+    virtual auto TimeSinceLastVsync(uint64_t* since_ns, uint64_t* frame_counter) -> bool = 0;
+};
+
+class OpenVRFrameClock final : public FrameClock {
+public:
+    auto Now() -> uint64_t override;
+    auto SleepUntil(uint64_t time_ns) -> void override;
+    auto WaitFrameSync(uint32_t timeout_ms) -> bool override;
+    auto TimeSinceLastVsync(uint64_t* since_ns, uint64_t* frame_counter) -> bool override;
+};
+
+// Deterministic compositor with a vsync every period_ns starting at phase_ns. Time only moves through
+// SleepUntil and Advance, SetPeriod lets the fake compositor drift away from the rate the pacer was given.
+class SimulatedFrameClock final : public FrameClock {
+public:
+    explicit SimulatedFrameClock(uint64_t period_ns, bool frame_sync = false, bool vsync_timing = true)
+        : now_ns_(0),
+        period_ns_(period_ns),
+        phase_ns_(0),
+        frame_sync_(frame_sync),
+        vsync_timing_(vsync_timing) {}
+
+    auto Now() -> uint64_t override { return now_ns_; }
+    auto SleepUntil(uint64_t time_ns) -> void override { now_ns_ = time_ns > now_ns_ ? time_ns : now_ns_; }
+    auto WaitFrameSync(uint32_t timeout_ms) -> bool override;
+    auto TimeSinceLastVsync(uint64_t* since_ns, uint64_t* frame_counter) -> bool override;
+
+    // Simulates work done between two waits
+    auto Advance(uint64_t duration_ns) -> void { now_ns_ += duration_ns; }
+    auto SetPeriod(uint64_t period_ns) -> void { period_ns_ = period_ns; }
+    auto SetPhase(uint64_t phase_ns) -> void { phase_ns_ = phase_ns; }
+    [[nodiscard]] auto FrameCounter() const -> uint64_t { return now_ns_ < phase_ns_ ? 0 : (now_ns_ - phase_ns_) / period_ns_; }
+
+private:
+    uint64_t now_ns_;
+    uint64_t period_ns_;
+    uint64_t phase_ns_;
+    bool frame_sync_;
+    bool vsync_timing_;
+};
+
+enum FramePacerMode
+{
+    FramePacerMode_FrameSync = 0, // IVROverlay::WaitFrameSync
+    FramePacerMode_VsyncTiming,   // IVRSystem::GetTimeSinceLastVsync
+    FramePacerMode_PLL,           // free running absolute deadlines, locked to vsync whenever it can be observed
+};
+
+struct FramePacerStats
+{
+    FramePacerMode mode;
+    uint64_t frames;
+    uint64_t missed_frames;     // compositor frames that passed without a frame from us
+    uint64_t duplicated_frames; // frames of ours that landed in the same compositor frame as the previous one
+    double phase_error_ms;      // last measured distance from the requested phase
+};
+
+class FramePacer {
+public:
+    explicit FramePacer(FrameClock& clock);
+
+    auto SetRefreshRate(float refresh_rate) -> void;
+    // How long after the compositor's vsync the UI build should start, may be negative
+    auto SetPhaseOffset(double seconds) -> void;
+
+    // Blocks until it is time to build and submit the next frame
+    auto Wait() -> void;
+    // Forgets the schedule after the loop did not pace for a while, so the gap is not counted as missed frames
+    auto Reset() -> void;
+
+    // Time since the compositor's last vsync, extrapolated from the one Wait observed last without asking the
+    // compositor again. False in PLL mode, after Reset and once that observation is a second old.
+    [[nodiscard]] auto TimeSinceLastVsync(uint64_t* since_ns) const -> bool;
+
+    [[nodiscard]] auto Stats() const -> const FramePacerStats& { return stats_; }
+
+private:
+    auto WaitVsyncTiming(uint64_t since_vsync_ns, uint64_t frame_counter) -> void;
+    auto WaitPLL() -> void;
+    auto CountFrames(uint64_t frame_counter) -> void;
+
+    FrameClock& clock_;
+    FramePacerStats stats_;
+    uint64_t period_ns_;
+    int64_t phase_offset_ns_;
+    uint64_t pll_grid_ns_;       // ideal wake up time, advances by exactly one period per frame
+    int64_t pll_correction_ns_;  // learned sleep overshoot, wake ups are requested this much early
+    uint64_t last_frame_counter_;
+    bool has_frame_counter_;
+    uint32_t frame_sync_retry_;  // frames until WaitFrameSync is tried again after it failed
+    uint64_t vsync_ns_;          // clock time of the last vsync Wait observed, UINT64_MAX when unknown
+};
@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2025. Nyabsi <nyabsi@sovellus.cc>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "IdleScheduler.h"
+
+#include <algorithm>
+#include <cmath>
+
+// ImGui needs a few frames after the last input to settle hover, release and fade states
+static constexpr uint32_t IDLE_SETTLE_FRAMES = 3;
+// Overlay poll interval while idle and the dashboard is closed, opening it wakes the loop through the system queue
+static constexpr uint32_t IDLE_WAKE_INTERVAL_MS = 200;
+
+IdleScheduler::IdleScheduler()
+{
+    stats_ = {};
+    idle_since_ns_ = 0;
+    quiet_frames_ = 0;
+    idle_ = false;
+    resumed_ = false;
+}
+
+auto IdleScheduler::EndFrame(const IdleFrameState& state, uint64_t now_ns) -> void
+{
+    const bool quiet = !state.overlay_visible && !state.window_visible && !state.ui_busy;
+    if (!quiet) {
+        quiet_frames_ = 0;
+        if (idle_)
+            this->Wake(now_ns);
+        return;
+    }
+
+    if (idle_ || ++quiet_frames_ < IDLE_SETTLE_FRAMES)
+        return;
+
+    idle_ = true;
+    idle_since_ns_ = now_ns;
+    stats_.idle_entries++;
+}
+
+auto IdleScheduler::Wake(uint64_t now_ns) -> void
+{
+    quiet_frames_ = 0;
+
+    if (!idle_)
+        return;
+
+    idle_ = false;
+    resumed_ = true;
+    stats_.idle_ns += now_ns > idle_since_ns_ ? now_ns - idle_since_ns_ : 0;
+}
+
+auto IdleScheduler::WakeIntervalMs(bool dashboard_visible, float refresh_rate) const -> uint32_t
+{
+    if (!dashboard_visible || refresh_rate <= 0.0f)
+        return IDLE_WAKE_INTERVAL_MS;
+
+    return std::max(static_cast<uint32_t>(std::floor(1000.0f / refresh_rate)), 1u);
+}
+
+auto IdleScheduler::Resumed() -> bool
+{
+    const bool resumed = resumed_;
+    resumed_ = false;
+    return resumed;
+}
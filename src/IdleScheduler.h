@@ -0,0 +1,60 @@
+/*
+ * Copyright (C) 2025. Nyabsi <nyabsi@sovellus.cc>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+// What the main loop saw at the end of a frame
+struct IdleFrameState
+{
+    bool overlay_visible;
+    bool window_visible;   // SDL window shown and not minimized
+    // An item is active or hovered, a mouse button is held, text input is wanted or the VR keyboard is open.
+    // Hover covers tooltip delays, nav moves and scrolls settle within the settle frames.
+    bool ui_busy;
+};
+
+struct IdleSchedulerStats
+{
+    uint64_t idle_entries;
+    uint64_t idle_wakeups;  // times the loop woke up while idle, with or without something to do
+    uint64_t idle_ns;       // total time spent idle
+};
+
+// Decides when nothing can change on screen so the main loop can stop building frames and block
+// instead. The loop reports every frame through EndFrame and every event through Wake, while idle
+// OpenVR is polled every WakeIntervalMs since its events cannot be waited on.
+class IdleScheduler {
+public:
+    explicit IdleScheduler();
+
+    auto EndFrame(const IdleFrameState& state, uint64_t now_ns) -> void;
+    // Something happened that may need a frame, leaves idle immediately
+    auto Wake(uint64_t now_ns) -> void;
+    // Counts a wake up while idle, call once per idle iteration of the loop
+    auto Tick() -> void { stats_.idle_wakeups++; }
+
+    // While the dashboard is open our overlay can be selected any moment, so poll once per HMD frame
+    // to pick VREvent_OverlayShown up within a frame. With the dashboard closed the overlay queues are
+    // polled slowly, the system queue is still polled at HMD rate and its dashboard activation ends
+    // the wait early.
+    [[nodiscard]] auto WakeIntervalMs(bool dashboard_visible, float refresh_rate) const -> uint32_t;
+
+    [[nodiscard]] auto Idle() const -> bool { return idle_; }
+    // True once for the first frame after idle ended
+    [[nodiscard]] auto Resumed() -> bool;
+    [[nodiscard]] auto Stats() const -> const IdleSchedulerStats& { return stats_; }
+
+private:
+    IdleSchedulerStats stats_;
+    uint64_t idle_since_ns_;
+    uint32_t quiet_frames_;
+    bool idle_;
+    bool resumed_;
+};
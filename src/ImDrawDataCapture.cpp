@@ -0,0 +1,657 @@
+/*
+ * Copyright (C) 2025. Nyabsi <nyabsi@sovellus.cc>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "ImDrawDataCapture.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "Profiler.h"
+
+enum CaptureChunkType
+{
+    CaptureChunk_TextureCreate = 1,
+    CaptureChunk_TextureUpdate,
+    CaptureChunk_TextureDestroy,
+    CaptureChunk_Frame,
+};
+
+struct CaptureFileHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t vertex_size; // sizeof(ImDrawVert) and sizeof(ImDrawIdx) of the build that recorded it
+    uint32_t index_size;
+};
+
+struct CaptureChunkHeader
+{
+    uint32_t type;
+    uint32_t size;
+};
+
+// Followed by rect.w * rect.h pixels, rows tightly packed. Destroy chunks carry no pixels.
+struct CaptureTexture
+{
+    int32_t id;
+    int32_t format;
+    int32_t width;
+    int32_t height;
+    ImTextureRect rect;
+};
+
+// Followed by draw_list_count draw lists
+struct CaptureFrame
+{
+    uint64_t time_ns;
+    ImVec2 display_pos;
+    ImVec2 display_size;
+    ImVec2 framebuffer_scale;
+    uint32_t draw_list_count;
+    int32_t total_vertex_count;
+    int32_t total_index_count;
+    uint32_t reserved;
+};
+
+// Followed by the vertices, the indices and the commands, each starting 8 byte aligned
+struct CaptureDrawList
+{
+    uint32_t vertex_count;
+    uint32_t index_count;
+    uint32_t command_count;
+    uint32_t reserved;
+};
+
+enum CaptureCommandFlags
+{
+    CaptureCommandFlags_None = 0,
+    CaptureCommandFlags_ResetRenderState = 1 << 0,
+};
+
+struct CaptureCommand
+{
+    ImVec4 clip_rect;
+    int32_t texture;
+    uint32_t vertex_offset;
+    uint32_t index_offset;
+    uint32_t element_count;
+    uint32_t flags;
+    uint32_t reserved;
+};
+
+static constexpr size_t CAPTURE_ALIGNMENT = 8;
+
+static auto AlignCapture(size_t size) -> size_t
+{
+    return (size + CAPTURE_ALIGNMENT - 1) & ~(CAPTURE_ALIGNMENT - 1);
+}
+
+static auto AppendBytes(std::vector<uint8_t>& buffer, const void* data, size_t size) -> void
+{
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    buffer.insert(buffer.end(), bytes, bytes + size);
+}
+
+template <typename T>
+static auto AppendValue(std::vector<uint8_t>& buffer, const T& value) -> void
+{
+    AppendBytes(buffer, &value, sizeof(T));
+}
+
+static auto AppendPadding(std::vector<uint8_t>& buffer) -> void
+{
+    buffer.resize(AlignCapture(buffer.size()), 0);
+}
+
+// Returns the offset of the header, the size is filled in by EndChunk
+static auto BeginChunk(std::vector<uint8_t>& buffer, CaptureChunkType type) -> size_t
+{
+    const size_t offset = buffer.size();
+    AppendValue(buffer, CaptureChunkHeader { .type = static_cast<uint32_t>(type), .size = 0 });
+    return offset;
+}
+
+static auto EndChunk(std::vector<uint8_t>& buffer, size_t offset) -> void
+{
+    const uint32_t size = static_cast<uint32_t>(buffer.size() - offset - sizeof(CaptureChunkHeader));
+    std::memcpy(buffer.data() + offset + offsetof(CaptureChunkHeader, size), &size, sizeof(size));
+    AppendPadding(buffer);
+}
+
+// Bounds checked view into a chunk payload
+struct CaptureCursor
+{
+    const uint8_t* data;
+    size_t size;
+    size_t offset;
+
+    auto Bytes(size_t count) -> const uint8_t*
+    {
+        if (count > size - offset)
+            return nullptr;
+
+        const uint8_t* result = data + offset;
+        offset += count;
+        return result;
+    }
+
+    template <typename T>
+    auto Read(T* value) -> bool
+    {
+        const uint8_t* bytes = this->Bytes(sizeof(T));
+        if (bytes != nullptr)
+            std::memcpy(value, bytes, sizeof(T));
+        return bytes != nullptr;
+    }
+
+    auto Align() -> void { offset = std::min(AlignCapture(offset), size); }
+};
+
+static auto BytesPerPixel(int32_t format) -> int32_t
+{
+    return format == ImTextureFormat_RGBA32 ? 4 : 1;
+}
+
+ImDrawDataCaptureWriter::ImDrawDataCaptureWriter()
+{
+    start_ns_ = 0;
+    frames_ = 0;
+}
+
+auto ImDrawDataCaptureWriter::Open(const std::string& path) -> bool
+{
+    this->Close();
+
+    file_.open(path, std::ios::binary | std::ios::trunc);
+    if (!file_)
+        return false;
+
+    const CaptureFileHeader header =
+    {
+        .magic = IMDRAWDATA_CAPTURE_MAGIC,
+        .version = IMDRAWDATA_CAPTURE_VERSION,
+        .vertex_size = sizeof(ImDrawVert),
+        .index_size = sizeof(ImDrawIdx),
+    };
+
+    file_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    textures_.clear();
+    start_ns_ = Profiler::Now();
+    frames_ = 0;
+
+    return static_cast<bool>(file_);
+}
+
+auto ImDrawDataCaptureWriter::WriteTexture(const ImTextureData* texture, ImTextureRect rect, bool create) -> void
+{
+    const size_t chunk = BeginChunk(buffer_, create ? CaptureChunk_TextureCreate : CaptureChunk_TextureUpdate);
+
+    AppendValue(buffer_, CaptureTexture {
+        .id = texture->UniqueID,
+        .format = static_cast<int32_t>(texture->Format),
+        .width = texture->Width,
+        .height = texture->Height,
+        .rect = rect,
+    });
+
+    for (int y = rect.y; y < rect.y + rect.h; y++)
+        AppendBytes(buffer_, texture->GetPixelsAt(rect.x, y), static_cast<size_t>(rect.w) * texture->BytesPerPixel);
+
+    EndChunk(buffer_, chunk);
+}
+
+auto ImDrawDataCaptureWriter::Record(const ImDrawData* draw_data) -> void
+{
+    if (!this->Recording() || draw_data == nullptr || !draw_data->Valid)
+        return;
+
+    PROFILE_SCOPE("Draw capture");
+
+    buffer_.clear();
+
+    // Textures that existed before the capture started are written out in full the first time they are seen.
+    if (draw_data->Textures != nullptr) {
+        for (const ImTextureData* texture : *draw_data->Textures) {
+            if (texture->Status == ImTextureStatus_WantDestroy || texture->Status == ImTextureStatus_Destroyed) {
+                if (textures_.erase(texture->UniqueID) > 0) {
+                    const size_t chunk = BeginChunk(buffer_, CaptureChunk_TextureDestroy);
+                    AppendValue(buffer_, CaptureTexture { .id = texture->UniqueID, .format = 0, .width = 0, .height = 0, .rect = {} });
+                    EndChunk(buffer_, chunk);
+                }
+                continue;
+            }
+
+            if (texture->Pixels == nullptr)
+                continue;
+
+            if (!textures_.contains(texture->UniqueID) || texture->Status == ImTextureStatus_WantCreate) {
+                const ImTextureRect full_rect =
+                {
+                    .x = 0,
+                    .y = 0,
+                    .w = static_cast<unsigned short>(texture->Width),
+                    .h = static_cast<unsigned short>(texture->Height),
+                };
+
+                this->WriteTexture(texture, full_rect, true);
+                textures_.insert(texture->UniqueID);
+            }
+            else if (texture->Status == ImTextureStatus_WantUpdates) {
+                this->WriteTexture(texture, texture->UpdateRect, false);
+            }
+        }
+    }
+
+    const size_t chunk = BeginChunk(buffer_, CaptureChunk_Frame);
+
+    AppendValue(buffer_, CaptureFrame {
+        .time_ns = Profiler::Now() - start_ns_,
+        .display_pos = draw_data->DisplayPos,
+        .display_size = draw_data->DisplaySize,
+        .framebuffer_scale = draw_data->FramebufferScale,
+        .draw_list_count = static_cast<uint32_t>(draw_data->CmdLists.Size),
+        .total_vertex_count = draw_data->TotalVtxCount,
+        .total_index_count = draw_data->TotalIdxCount,
+        .reserved = 0,
+    });
+
+    for (const ImDrawList* draw_list : draw_data->CmdLists) {
+        // Only ImGui's own render state reset survives a capture, any other callback is dropped.
+        uint32_t command_count = 0;
+        for (const ImDrawCmd& cmd : draw_list->CmdBuffer)
+            if (cmd.UserCallback == nullptr || cmd.UserCallback == ImDrawCallback_ResetRenderState)
+                command_count++;
+
+        AppendValue(buffer_, CaptureDrawList {
+            .vertex_count = static_cast<uint32_t>(draw_list->VtxBuffer.Size),
+            .index_count = static_cast<uint32_t>(draw_list->IdxBuffer.Size),
+            .command_count = command_count,
+            .reserved = 0,
+        });
+
+        AppendBytes(buffer_, draw_list->VtxBuffer.Data, draw_list->VtxBuffer.size_in_bytes());
+        AppendPadding(buffer_);
+        AppendBytes(buffer_, draw_list->IdxBuffer.Data, draw_list->IdxBuffer.size_in_bytes());
+        AppendPadding(buffer_);
+
+        for (const ImDrawCmd& cmd : draw_list->CmdBuffer) {
+            if (cmd.UserCallback != nullptr && cmd.UserCallback != ImDrawCallback_ResetRenderState)
+                continue;
+
+            AppendValue(buffer_, CaptureCommand {
+                .clip_rect = cmd.ClipRect,
+                .texture = cmd.TexRef._TexData != nullptr ? cmd.TexRef._TexData->UniqueID : -1,
+                .vertex_offset = cmd.VtxOffset,
+                .index_offset = cmd.IdxOffset,
+                .element_count = cmd.ElemCount,
+                .flags = cmd.UserCallback == ImDrawCallback_ResetRenderState ? CaptureCommandFlags_ResetRenderState : CaptureCommandFlags_None,
+                .reserved = 0,
+            });
+        }
+    }
+
+    EndChunk(buffer_, chunk);
+
+    file_.write(reinterpret_cast<const char*>(buffer_.data()), static_cast<std::streamsize>(buffer_.size()));
+    frames_++;
+
+    if (!file_) {
+        printf("[ImDrawDataCapture] write failed, capture stopped after %u frames\n", frames_);
+        this->Close();
+    }
+}
+
+auto ImDrawDataCaptureWriter::Close() -> void
+{
+    if (file_.is_open())
+        file_.close();
+
+    textures_.clear();
+}
+
+ImDrawDataCaptureReader::ImDrawDataCaptureReader()
+{
+    mapping_ = nullptr;
+    mapping_size_ = 0;
+    mapping_handle_ = nullptr;
+    cursor_ = 0;
+    frame_count_ = 0;
+}
+
+ImDrawDataCaptureReader::~ImDrawDataCaptureReader()
+{
+    this->Close();
+}
+
+auto ImDrawDataCaptureReader::Open(const std::string& path) -> bool
+{
+    this->Close();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER file_size = {};
+    HANDLE mapping = nullptr;
+    if (GetFileSizeEx(file, &file_size) && file_size.QuadPart > 0)
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+
+    if (mapping == nullptr)
+        return false;
+
+    mapping_ = static_cast<const uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    if (mapping_ == nullptr) {
+        CloseHandle(mapping);
+        return false;
+    }
+
+    mapping_size_ = static_cast<size_t>(file_size.QuadPart);
+    mapping_handle_ = mapping;
+#else
+    int file = open(path.c_str(), O_RDONLY);
+    if (file < 0)
+        return false;
+
+    struct stat file_stat = {};
+    void* mapping = MAP_FAILED;
+    if (fstat(file, &file_stat) == 0 && file_stat.st_size > 0)
+        mapping = mmap(nullptr, static_cast<size_t>(file_stat.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+    close(file);
+
+    if (mapping == MAP_FAILED)
+        return false;
+
+    mapping_ = static_cast<const uint8_t*>(mapping);
+    mapping_size_ = static_cast<size_t>(file_stat.st_size);
+#endif
+
+    CaptureFileHeader header = {};
+    if (mapping_size_ < sizeof(header)) {
+        this->Close();
+        return false;
+    }
+
+    std::memcpy(&header, mapping_, sizeof(header));
+    if (header.magic != IMDRAWDATA_CAPTURE_MAGIC || header.version != IMDRAWDATA_CAPTURE_VERSION || header.vertex_size != sizeof(ImDrawVert) || header.index_size != sizeof(ImDrawIdx)) {
+        printf("[ImDrawDataCapture] %s is not a capture this build can replay\n", path.c_str());
+        this->Close();
+        return false;
+    }
+
+    // A capture cut short by a crash still replays up to its last complete chunk.
+    size_t offset = AlignCapture(sizeof(header));
+    while (mapping_size_ - offset >= sizeof(CaptureChunkHeader)) {
+        CaptureChunkHeader chunk = {};
+        std::memcpy(&chunk, mapping_ + offset, sizeof(chunk));
+
+        if (chunk.size > mapping_size_ - offset - sizeof(chunk))
+            break;
+
+        chunks_.push_back({ .type = chunk.type, .size = chunk.size, .data = mapping_ + offset + sizeof(chunk) });
+        if (chunk.type == CaptureChunk_Frame)
+            frame_count_++;
+
+        offset += AlignCapture(sizeof(chunk) + chunk.size);
+        if (offset > mapping_size_)
+            break;
+    }
+
+    return true;
+}
+
+auto ImDrawDataCaptureReader::Close() -> void
+{
+    this->ReleaseDrawLists();
+
+    for (ImTextureData* texture : textures_)
+        IM_DELETE(texture);
+    textures_.clear();
+    texture_ids_.clear();
+
+    if (mapping_ != nullptr) {
+#ifdef _WIN32
+        UnmapViewOfFile(mapping_);
+        CloseHandle(static_cast<HANDLE>(mapping_handle_));
+#else
+        munmap(const_cast<uint8_t*>(mapping_), mapping_size_);
+#endif
+    }
+
+    mapping_ = nullptr;
+    mapping_size_ = 0;
+    mapping_handle_ = nullptr;
+    chunks_.clear();
+    cursor_ = 0;
+    frame_count_ = 0;
+}
+
+auto ImDrawDataCaptureReader::Rewind() -> void
+{
+    cursor_ = 0;
+}
+
+auto ImDrawDataCaptureReader::NextFrame() -> ImDrawData*
+{
+    if (frame_count_ == 0)
+        return nullptr;
+
+    // Like ImGui does for its own textures, a texture is only destroyed by the backend once it went
+    // unused for as many frames as can be in flight.
+    for (int i = 0; i < textures_.Size;) {
+        ImTextureData* texture = textures_[i];
+
+        if (texture->Status == ImTextureStatus_WantDestroy)
+            texture->UnusedFrames++;
+
+        if (texture->Status == ImTextureStatus_Destroyed && texture_ids_[i] < 0) {
+            IM_DELETE(texture);
+            textures_.erase(textures_.begin() + i);
+            texture_ids_.erase(texture_ids_.begin() + i);
+            continue;
+        }
+
+        i++;
+    }
+
+    // Two passes find a frame that can be built if there is one
+    for (size_t i = 0; i < chunks_.size() * 2; i++) {
+        if (cursor_ == chunks_.size())
+            cursor_ = 0;
+
+        const Chunk& chunk = chunks_[cursor_++];
+
+        if (chunk.type == CaptureChunk_Frame) {
+            if (ImDrawData* draw_data = this->BuildFrame(chunk))
+                return draw_data;
+        }
+        else {
+            this->ApplyTexture(chunk);
+        }
+    }
+
+    return nullptr;
+}
+
+auto ImDrawDataCaptureReader::ApplyTexture(const Chunk& chunk) -> void
+{
+    CaptureCursor cursor = { .data = chunk.data, .size = chunk.size, .offset = 0 };
+
+    CaptureTexture captured = {};
+    if (!cursor.Read(&captured))
+        return;
+
+    auto id = std::find(texture_ids_.begin(), texture_ids_.end(), captured.id);
+    ImTextureData* texture = id != texture_ids_.end() ? textures_[static_cast<int>(id - texture_ids_.begin())] : nullptr;
+
+    // Retired textures stay in the list until the backend destroyed them
+    auto retire = [&]() -> void {
+        if (texture->TexID != ImTextureID_Invalid) {
+            texture->SetStatus(ImTextureStatus_WantDestroy);
+            texture->UnusedFrames = 0;
+        }
+        else {
+            texture->SetStatus(ImTextureStatus_Destroyed);
+        }
+        *id = -1;
+        texture = nullptr;
+    };
+
+    if (chunk.type == CaptureChunk_TextureDestroy) {
+        if (texture != nullptr)
+            retire();
+        return;
+    }
+
+    if (captured.width <= 0 || captured.height <= 0 || captured.rect.x + captured.rect.w > captured.width || captured.rect.y + captured.rect.h > captured.height)
+        return;
+
+    const size_t row_size = static_cast<size_t>(captured.rect.w) * BytesPerPixel(captured.format);
+    const uint8_t* pixels = cursor.Bytes(row_size * captured.rect.h);
+    if (pixels == nullptr)
+        return;
+
+    if (chunk.type == CaptureChunk_TextureCreate) {
+        // Replaying from the start again creates textures that are still alive, reuse them if nothing but the pixels changed
+        if (texture != nullptr && (texture->Width != captured.width || texture->Height != captured.height || texture->Format != static_cast<ImTextureFormat>(captured.format)))
+            retire();
+
+        if (texture == nullptr) {
+            texture = IM_NEW(ImTextureData)();
+            texture->Create(static_cast<ImTextureFormat>(captured.format), captured.width, captured.height);
+            textures_.push_back(texture);
+            texture_ids_.push_back(captured.id);
+        }
+    }
+    else if (texture == nullptr || texture->Status == ImTextureStatus_WantDestroy) {
+        return;
+    }
+
+    for (int y = 0; y < captured.rect.h; y++)
+        std::memcpy(texture->GetPixelsAt(captured.rect.x, captured.rect.y + y), pixels + y * row_size, row_size);
+
+    if (texture->Status == ImTextureStatus_OK) {
+        texture->SetStatus(ImTextureStatus_WantUpdates);
+        texture->Updates.resize(0);
+        texture->UpdateRect = captured.rect;
+        texture->Updates.push_back(captured.rect);
+    }
+    else if (texture->Status == ImTextureStatus_WantUpdates) {
+        const int x0 = std::min<int>(texture->UpdateRect.x, captured.rect.x);
+        const int y0 = std::min<int>(texture->UpdateRect.y, captured.rect.y);
+        const int x1 = std::max<int>(texture->UpdateRect.x + texture->UpdateRect.w, captured.rect.x + captured.rect.w);
+        const int y1 = std::max<int>(texture->UpdateRect.y + texture->UpdateRect.h, captured.rect.y + captured.rect.h);
+
+        texture->UpdateRect = { .x = static_cast<unsigned short>(x0), .y = static_cast<unsigned short>(y0), .w = static_cast<unsigned short>(x1 - x0), .h = static_cast<unsigned short>(y1 - y0) };
+        texture->Updates.push_back(captured.rect);
+    }
+}
+
+auto ImDrawDataCaptureReader::BuildFrame(const Chunk& chunk) -> ImDrawData*
+{
+    CaptureCursor cursor = { .data = chunk.data, .size = chunk.size, .offset = 0 };
+
+    CaptureFrame frame = {};
+    if (!cursor.Read(&frame))
+        return nullptr;
+
+    while (draw_lists_.Size < static_cast<int>(frame.draw_list_count))
+        draw_lists_.push_back(IM_NEW(ImDrawList)(nullptr));
+
+    draw_data_.Clear();
+    draw_data_.Valid = true;
+    draw_data_.DisplayPos = frame.display_pos;
+    draw_data_.DisplaySize = frame.display_size;
+    draw_data_.FramebufferScale = frame.framebuffer_scale;
+    draw_data_.Textures = &textures_;
+
+    for (uint32_t n = 0; n < frame.draw_list_count; n++) {
+        ImDrawList* draw_list = draw_lists_[n];
+
+        CaptureDrawList captured = {};
+        if (!cursor.Read(&captured))
+            return nullptr;
+
+        const uint8_t* vertices = cursor.Bytes(captured.vertex_count * sizeof(ImDrawVert));
+        cursor.Align();
+        const uint8_t* indices = cursor.Bytes(captured.index_count * sizeof(ImDrawIdx));
+        cursor.Align();
+        if (vertices == nullptr || indices == nullptr)
+            return nullptr;
+
+        // The backend only reads the buffers, they are never grown or freed while they point into the mapping
+        draw_list->VtxBuffer.Data = reinterpret_cast<ImDrawVert*>(const_cast<uint8_t*>(vertices));
+        draw_list->VtxBuffer.Size = draw_list->VtxBuffer.Capacity = static_cast<int>(captured.vertex_count);
+        draw_list->IdxBuffer.Data = reinterpret_cast<ImDrawIdx*>(const_cast<uint8_t*>(indices));
+        draw_list->IdxBuffer.Size = draw_list->IdxBuffer.Capacity = static_cast<int>(captured.index_count);
+
+        // Commands hold texture pointers, they are the only part rebuilt on every frame
+        draw_list->CmdBuffer.resize(0);
+
+        for (uint32_t i = 0; i < captured.command_count; i++) {
+            CaptureCommand captured_cmd = {};
+            if (!cursor.Read(&captured_cmd))
+                return nullptr;
+
+            ImDrawCmd cmd = {};
+            cmd.ClipRect = captured_cmd.clip_rect;
+            cmd.VtxOffset = captured_cmd.vertex_offset;
+            cmd.IdxOffset = captured_cmd.index_offset;
+            cmd.ElemCount = captured_cmd.element_count;
+
+            if (captured_cmd.flags & CaptureCommandFlags_ResetRenderState) {
+                cmd.UserCallback = ImDrawCallback_ResetRenderState;
+            }
+            else {
+                auto id = std::find(texture_ids_.begin(), texture_ids_.end(), captured_cmd.texture);
+                if (id == texture_ids_.end())
+                    continue;
+
+                cmd.TexRef._TexData = textures_[static_cast<int>(id - texture_ids_.begin())];
+            }
+
+            draw_list->CmdBuffer.push_back(cmd);
+        }
+
+        draw_data_.CmdLists.push_back(draw_list);
+        draw_data_.CmdListsCount++;
+        draw_data_.TotalVtxCount += draw_list->VtxBuffer.Size;
+        draw_data_.TotalIdxCount += draw_list->IdxBuffer.Size;
+    }
+
+    return &draw_data_;
+}
+
+auto ImDrawDataCaptureReader::ReleaseDrawLists() -> void
+{
+    draw_data_.Clear();
+
+    for (ImDrawList* draw_list : draw_lists_) {
+        // Hand the mapped buffers back before ImDrawList tries to free them
+        draw_list->VtxBuffer.Data = nullptr;
+        draw_list->VtxBuffer.Size = draw_list->VtxBuffer.Capacity = 0;
+        draw_list->IdxBuffer.Data = nullptr;
+        draw_list->IdxBuffer.Size = draw_list->IdxBuffer.Capacity = 0;
+        IM_DELETE(draw_list);
+    }
+
+    draw_lists_.clear();
+}
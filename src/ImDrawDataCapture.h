@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2025. Nyabsi <nyabsi@sovellus.cc>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include <imgui.h>
+
+// Binary capture of a sequence of ImDrawData frames, replayed through the renderer without running any UI code.
+//
+// The file is a header followed by chunks, each an 8 byte aligned { type, size } pair and its payload.
+// Texture chunks carry the pixels of textures when they are created and the rect of every later update,
+// frame chunks carry the draw lists with their vertices, indices and commands. Commands reference textures
+// by ImTextureData::UniqueID, textures registered by ImTextureID alone are not captured.
+static constexpr uint32_t IMDRAWDATA_CAPTURE_MAGIC = 0x43444D49; // "IMDC"
+static constexpr uint32_t IMDRAWDATA_CAPTURE_VERSION = 1;
+
+class ImDrawDataCaptureWriter {
+public:
+    explicit ImDrawDataCaptureWriter();
+
+    auto Open(const std::string& path) -> bool;
+    // Call right after ImGui::Render(), before the renderer backend processed the texture requests of the frame
+    auto Record(const ImDrawData* draw_data) -> void;
+    auto Close() -> void;
+
+    [[nodiscard]] auto Recording() const -> bool { return file_.is_open(); }
+    [[nodiscard]] auto Frames() const -> uint32_t { return frames_; }
+
+private:
+    auto WriteTexture(const ImTextureData* texture, ImTextureRect rect, bool create) -> void;
+
+    std::ofstream file_;
+    std::vector<uint8_t> buffer_;
+    std::unordered_set<int> textures_;
+    uint64_t start_ns_;
+    uint32_t frames_;
+};
+
+// Memory maps a capture, vertex and index buffers of the returned draw data point straight into the mapping.
+class ImDrawDataCaptureReader {
+public:
+    explicit ImDrawDataCaptureReader();
+    ~ImDrawDataCaptureReader();
+
+    ImDrawDataCaptureReader(const ImDrawDataCaptureReader&) = delete;
+    ImDrawDataCaptureReader& operator=(const ImDrawDataCaptureReader&) = delete;
+
+    auto Open(const std::string& path) -> bool;
+    // Textures the renderer backend created have to be destroyed through it before this
+    auto Close() -> void;
+
+    // Applies the texture changes recorded up to the next frame and returns its draw data, valid until the next
+    // call. Starts over at the end, returns nullptr if the capture holds no frames.
+    auto NextFrame() -> ImDrawData*;
+    auto Rewind() -> void;
+
+    [[nodiscard]] auto FrameCount() const -> uint32_t { return frame_count_; }
+    [[nodiscard]] auto Textures() -> ImVector<ImTextureData*>& { return textures_; }
+
+private:
+    struct Chunk
+    {
+        uint32_t type;
+        uint32_t size;
+        const uint8_t* data;
+    };
+
+    auto ApplyTexture(const Chunk& chunk) -> void;
+    auto BuildFrame(const Chunk& chunk) -> ImDrawData*;
+    auto ReleaseDrawLists() -> void;
+
+    const uint8_t* mapping_;
+    size_t mapping_size_;
+    void* mapping_handle_;
+
+    std::vector<Chunk> chunks_;
+    size_t cursor_;
+    uint32_t frame_count_;
+
+    ImDrawData draw_data_;
+    ImVector<ImDrawList*> draw_lists_;
+    ImVector<ImTextureData*> textures_;
+    std::vector<int> texture_ids_; // capture id of each entry in textures_
+};
@@ -0,0 +1,356 @@
+/*
+ * Copyright (C) 2025. Nyabsi <nyabsi@sovellus.cc>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cfloat>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include <imgui.h>
+
+// Small non-cryptographic 64-bit hash, consumes 8 bytes per round which keeps
+// hashing the vertex buffers of a typical panel well under the cost of drawing them.
+static auto HashBytes(uint64_t seed, const void* data, size_t size) -> uint64_t
+{
+    constexpr uint64_t prime_1 = 0x9E3779B185EBCA87ull;
+    constexpr uint64_t prime_2 = 0xC2B2AE3D27D4EB4Full;
+
+    auto round = [&](uint64_t hash, uint64_t word) -> uint64_t {
+        hash ^= word * prime_2;
+        hash = (hash << 31) | (hash >> 33);
+        return hash * prime_1;
+    };
+
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    uint64_t hash = seed ^ (static_cast<uint64_t>(size) * prime_1);
+
+    while (size >= sizeof(uint64_t)) {
+        uint64_t word = {};
+        memcpy(&word, bytes, sizeof(uint64_t));
+        hash = round(hash, word);
+        bytes += sizeof(uint64_t);
+        size -= sizeof(uint64_t);
+    }
+
+    if (size > 0) {
+        uint64_t word = {};
+        memcpy(&word, bytes, size);
+        hash = round(hash, word);
+    }
+
+    hash ^= hash >> 33;
+    hash *= prime_2;
+    hash ^= hash >> 29;
+    return hash;
+}
+
+template <typename T>
+static auto HashValue(uint64_t seed, const T& value) -> uint64_t
+{
+    return HashBytes(seed, &value, sizeof(T));
+}
+
+// Textures that still have to be created or updated by the renderer backend have no valid
+// ImTextureID yet, a frame referencing them can never be considered identical to a previous one.
+static auto ImDrawDataHasPendingTextures(const ImDrawData* draw_data) -> bool
+{
+    if (draw_data->Textures == nullptr)
+        return false;
+
+    for (const ImTextureData* texture : *draw_data->Textures)
+        if (texture->Status != ImTextureStatus_OK)
+            return true;
+
+    return false;
+}
+
+// Hashes everything that determines the rasterized output of a frame: geometry, draw commands,
+// clip rects, bound textures and the display transform. Returns 0 only for an invalid frame.
+static auto HashImDrawData(const ImDrawData* draw_data) -> uint64_t
+{
+    if (draw_data == nullptr || !draw_data->Valid)
+        return 0;
+
+    uint64_t hash = {};
+
+    hash = HashValue(hash, draw_data->DisplayPos);
+    hash = HashValue(hash, draw_data->DisplaySize);
+    hash = HashValue(hash, draw_data->FramebufferScale);
+    hash = HashValue(hash, draw_data->CmdListsCount);
+
+    for (const ImDrawList* draw_list : draw_data->CmdLists) {
+        hash = HashBytes(hash, draw_list->VtxBuffer.Data, draw_list->VtxBuffer.size_in_bytes());
+        hash = HashBytes(hash, draw_list->IdxBuffer.Data, draw_list->IdxBuffer.size_in_bytes());
+
+        for (const ImDrawCmd& cmd : draw_list->CmdBuffer) {
+            hash = HashValue(hash, cmd.ClipRect);
+            hash = HashValue(hash, cmd.GetTexID());
+            hash = HashValue(hash, cmd.VtxOffset);
+            hash = HashValue(hash, cmd.IdxOffset);
+            hash = HashValue(hash, cmd.ElemCount);
+            hash = HashValue(hash, cmd.UserCallback);
+        }
+    }
+
+    return hash != 0 ? hash : 1;
+}
+
+// Hash of the transform from ImGui coordinates to framebuffer pixels, rects recorded under a
+// different transform cannot be compared against each other.
+static auto HashImDrawDataDisplay(const ImDrawData* draw_data) -> uint64_t
+{
+    uint64_t hash = {};
+
+    hash = HashValue(hash, draw_data->DisplayPos);
+    hash = HashValue(hash, draw_data->DisplaySize);
+    hash = HashValue(hash, draw_data->FramebufferScale);
+
+    return hash;
+}
+
+struct ImDrawCmdSignature
+{
+    uint64_t hash; // clip rect, texture and geometry of the command, independent of its buffer offsets
+    ImVec4 rect;   // area the command can touch, in ImGui coordinates
+};
+
+// Working memory of ComputeImDrawDamage, kept by the caller so diffing a frame allocates nothing once warm
+struct ImDrawDamageScratch
+{
+    std::vector<std::pair<uint64_t, uint32_t>> previous_sorted;
+    std::vector<int32_t> matches;
+    std::vector<bool> previous_used;
+    std::vector<int32_t> tails;
+    std::vector<int32_t> tails_index;
+    std::vector<int32_t> parent;
+    std::vector<bool> current_stable;
+    std::vector<bool> previous_stable;
+};
+
+static auto ImRectIntersects(const ImVec4& a, const ImVec4& b) -> bool
+{
+    return a.x < b.z && b.x < a.z && a.y < b.w && b.y < a.w;
+}
+
+static auto ImRectUnion(const ImVec4& a, const ImVec4& b) -> ImVec4
+{
+    return ImVec4(std::min(a.x, b.x), std::min(a.y, b.y), std::max(a.z, b.z), std::max(a.w, b.w));
+}
+
+static auto ImRectIntersection(const ImVec4& a, const ImVec4& b) -> ImVec4
+{
+    return ImVec4(std::max(a.x, b.x), std::max(a.y, b.y), std::min(a.z, b.z), std::min(a.w, b.w));
+}
+
+// Builds one signature per visible draw command, in draw order. Returns false when the frame
+// contains user callbacks, their output cannot be tracked and the frame has to be fully redrawn.
+static auto BuildImDrawCmdSignatures(const ImDrawData* draw_data, std::vector<ImDrawCmdSignature>& signatures) -> bool
+{
+    signatures.clear();
+
+    for (const ImDrawList* draw_list : draw_data->CmdLists) {
+        for (const ImDrawCmd& cmd : draw_list->CmdBuffer) {
+            if (cmd.UserCallback != nullptr) {
+                if (cmd.UserCallback == ImDrawCallback_ResetRenderState)
+                    continue;
+                return false;
+            }
+
+            if (cmd.ElemCount == 0 || cmd.ClipRect.z <= cmd.ClipRect.x || cmd.ClipRect.w <= cmd.ClipRect.y)
+                continue;
+
+            // Hash the index deltas rather than the indices, so the signature of a command does
+            // not change when the geometry before it in the same draw list grows or shrinks.
+            const ImDrawIdx* indices = draw_list->IdxBuffer.Data + cmd.IdxOffset;
+
+            uint64_t hash = {};
+            uint32_t index_min = UINT32_MAX;
+            uint32_t index_max = 0;
+            uint32_t index_previous = indices[0];
+
+            for (uint32_t i = 0; i < cmd.ElemCount; i++) {
+                const uint32_t index = indices[i];
+                index_min = std::min(index_min, index);
+                index_max = std::max(index_max, index);
+                hash = (hash ^ static_cast<uint32_t>(index - index_previous)) * 0x100000001B3ull;
+                index_previous = index;
+            }
+
+            const ImDrawVert* vertices = draw_list->VtxBuffer.Data + cmd.VtxOffset + index_min;
+            const uint32_t vertex_count = index_max - index_min + 1;
+
+            ImVec4 bounds = ImVec4(FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX);
+            for (uint32_t i = 0; i < vertex_count; i++) {
+                bounds.x = std::min(bounds.x, vertices[i].pos.x);
+                bounds.y = std::min(bounds.y, vertices[i].pos.y);
+                bounds.z = std::max(bounds.z, vertices[i].pos.x);
+                bounds.w = std::max(bounds.w, vertices[i].pos.y);
+            }
+
+            const ImVec4 rect = ImRectIntersection(bounds, cmd.ClipRect);
+            if (rect.z <= rect.x || rect.w <= rect.y)
+                continue;
+
+            hash = HashValue(hash, cmd.ClipRect);
+            hash = HashValue(hash, cmd.GetTexID());
+            hash = HashBytes(hash, vertices, vertex_count * sizeof(ImDrawVert));
+
+            signatures.push_back({ .hash = hash, .rect = rect });
+        }
+    }
+
+    return true;
+}
+
+// Diffs the commands of two frames and appends the areas whose pixels may differ to rects.
+// Commands are matched by signature, matched commands that kept their relative draw order are
+// unchanged, every other command damages the area it covers in the frame it belongs to.
+static auto ComputeImDrawDamage(const std::vector<ImDrawCmdSignature>& previous, const std::vector<ImDrawCmdSignature>& current, std::vector<ImVec4>& rects, ImDrawDamageScratch& scratch) -> void
+{
+    std::vector<std::pair<uint64_t, uint32_t>>& previous_sorted = scratch.previous_sorted;
+    previous_sorted.resize(previous.size());
+    for (uint32_t i = 0; i < previous.size(); i++)
+        previous_sorted[i] = { previous[i].hash, i };
+    std::sort(previous_sorted.begin(), previous_sorted.end());
+
+    // For every current command the index of the previous command it matched, or -1.
+    std::vector<int32_t>& matches = scratch.matches;
+    std::vector<bool>& previous_used = scratch.previous_used;
+    matches.assign(current.size(), -1);
+    previous_used.assign(previous.size(), false);
+
+    for (uint32_t i = 0; i < current.size(); i++) {
+        auto it = std::lower_bound(previous_sorted.begin(), previous_sorted.end(), std::pair<uint64_t, uint32_t>{ current[i].hash, 0 });
+        for (; it != previous_sorted.end() && it->first == current[i].hash; ++it) {
+            if (!previous_used[it->second]) {
+                previous_used[it->second] = true;
+                matches[i] = static_cast<int32_t>(it->second);
+                break;
+            }
+        }
+    }
+
+    // Longest increasing subsequence of the matched indices, these commands are drawn in the same
+    // order as before. Anything matched outside of it moved relative to its neighbours.
+    std::vector<int32_t>& tails = scratch.tails;
+    std::vector<int32_t>& tails_index = scratch.tails_index;
+    std::vector<int32_t>& parent = scratch.parent;
+    tails.clear();
+    tails_index.clear();
+    parent.assign(current.size(), -1);
+
+    for (uint32_t i = 0; i < current.size(); i++) {
+        if (matches[i] < 0)
+            continue;
+
+        const size_t position = std::lower_bound(tails.begin(), tails.end(), matches[i]) - tails.begin();
+        if (position == tails.size()) {
+            tails.push_back(matches[i]);
+            tails_index.push_back(static_cast<int32_t>(i));
+        }
+        else {
+            tails[position] = matches[i];
+            tails_index[position] = static_cast<int32_t>(i);
+        }
+        parent[i] = position > 0 ? tails_index[position - 1] : -1;
+    }
+
+    std::vector<bool>& current_stable = scratch.current_stable;
+    std::vector<bool>& previous_stable = scratch.previous_stable;
+    current_stable.assign(current.size(), false);
+    previous_stable.assign(previous.size(), false);
+
+    for (int32_t i = tails_index.empty() ? -1 : tails_index.back(); i >= 0; i = parent[i]) {
+        current_stable[i] = true;
+        previous_stable[matches[i]] = true;
+    }
+
+    for (uint32_t i = 0; i < current.size(); i++)
+        if (!current_stable[i])
+            rects.push_back(current[i].rect);
+
+    for (uint32_t i = 0; i < previous.size(); i++)
+        if (!previous_stable[i])
+            rects.push_back(previous[i].rect);
+}
+
+// Merges rects until none of them overlap, falling back to their bounding box
+// once more than max_rects remain since every rect costs another pass over the geometry.
+static auto MergeDamageRects(std::vector<ImVec4>& rects, size_t max_rects) -> void
+{
+    bool merged = true;
+    while (merged) {
+        merged = false;
+        for (size_t i = 0; i < rects.size() && !merged; i++) {
+            for (size_t j = i + 1; j < rects.size(); j++) {
+                if (ImRectIntersects(rects[i], rects[j])) {
+                    rects[i] = ImRectUnion(rects[i], rects[j]);
+                    rects.erase(rects.begin() + j);
+                    merged = true;
+                    break;
+                }
+            }
+        }
+    }
+
+    if (rects.size() > max_rects) {
+        ImVec4 bounds = rects[0];
+        for (const ImVec4& rect : rects)
+            bounds = ImRectUnion(bounds, rect);
+        rects.assign(1, bounds);
+    }
+}
+
+// Replaces the command buffer of every draw list by copies of its commands clipped to each rect,
+// restricting rasterization to rects. The original command buffers are kept in storage and have
+// to be put back with ImDrawDataRestoreCommands before the draw data is used again.
+static auto ImDrawDataClipCommands(ImDrawData* draw_data, const std::vector<ImVec4>& rects, std::vector<ImVector<ImDrawCmd>>& storage) -> void
+{
+    if (storage.size() < static_cast<size_t>(draw_data->CmdLists.Size))
+        storage.resize(draw_data->CmdLists.Size);
+
+    for (int n = 0; n < draw_data->CmdLists.Size; n++) {
+        ImDrawList* draw_list = draw_data->CmdLists[n];
+        ImVector<ImDrawCmd>& clipped = storage[n];
+
+        // Sized up front, the storage keeps its capacity from frame to frame
+        int clipped_count = 0;
+        for (const ImDrawCmd& cmd : draw_list->CmdBuffer)
+            clipped_count += cmd.UserCallback != nullptr ? 1 : static_cast<int>(rects.size());
+
+        clipped.resize(0);
+        clipped.reserve(clipped_count);
+
+        for (const ImDrawCmd& cmd : draw_list->CmdBuffer) {
+            if (cmd.UserCallback != nullptr) {
+                clipped.push_back(cmd);
+                continue;
+            }
+
+            for (const ImVec4& rect : rects) {
+                const ImVec4 clip_rect = ImRectIntersection(cmd.ClipRect, rect);
+                if (clip_rect.z <= clip_rect.x || clip_rect.w <= clip_rect.y)
+                    continue;
+
+                clipped.push_back(cmd);
+                clipped.back().ClipRect = clip_rect;
+            }
+        }
+
+        draw_list->CmdBuffer.swap(clipped);
+    }
+}
+
+static auto ImDrawDataRestoreCommands(ImDrawData* draw_data, std::vector<ImVector<ImDrawCmd>>& storage) -> void
+{
+    for (int n = 0; n < draw_data->CmdLists.Size; n++)
+        draw_data->CmdLists[n]->CmdBuffer.swap(storage[n]);
+}
@@ -12,16 +12,24 @@
 #include <backends/imgui_impl_vulkan.h>
 
 #include "backends/imgui_impl_openvr.h"
+#include "Profiler.h"
 
 #include <math.h>
 
 ImGuiOverlayWindow::ImGuiOverlayWindow()
 {
-
+    renderer_ = nullptr;
+    surface_format_ =
+    {
+        .format = VK_FORMAT_R8G8B8A8_SRGB,
+        .colorSpace = VK_COLOR_SPACE_SRGB_NONLINEAR_KHR
+    };
 }
 
 auto ImGuiOverlayWindow::Initialize(VulkanRenderer*& renderer, VrOverlay*& overlay, int width, int height) -> void
 {
+    renderer_ = renderer;
+
     IMGUI_CHECKVERSION();
 
     ImGui::CreateContext();
@@ -63,18 +71,12 @@ auto ImGuiOverlayWindow::Initialize(VulkanRenderer*& renderer, VrOverlay*& overl
 
     ImGui_ImplOpenVR_Init(&openvr_init_info);
 
-    VkSurfaceFormatKHR surface_format =
-    {
-        .format = VK_FORMAT_R8G8B8A8_SRGB,
-        .colorSpace = VK_COLOR_SPACE_SRGB_NONLINEAR_KHR
-    };
-
     VkPipelineRenderingCreateInfoKHR pipeline_rendering_create_info = 
     {
         .sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO_KHR,
         .viewMask = 0,
         .colorAttachmentCount = 1,
-        .pColorAttachmentFormats = &surface_format.format,
+        .pColorAttachmentFormats = &surface_format_.format,
         .depthAttachmentFormat = VK_FORMAT_UNDEFINED,
         .stencilAttachmentFormat = VK_FORMAT_UNDEFINED,
     };
@@ -89,7 +91,8 @@ auto ImGuiOverlayWindow::Initialize(VulkanRenderer*& renderer, VrOverlay*& overl
         .DescriptorPool = renderer->DescriptorPool(),
         .RenderPass = VK_NULL_HANDLE,
         .MinImageCount = 16,
-        .ImageCount = 16,
+        // The context draws this window's overlay only
+        .ImageCount = VulkanRenderer::ImGuiRenderBufferCount(1),
         .MSAASamples = VK_SAMPLE_COUNT_1_BIT,
         .PipelineCache = renderer->PipelineCache(),
         .Subpass = 0,
@@ -100,7 +103,6 @@ auto ImGuiOverlayWindow::Initialize(VulkanRenderer*& renderer, VrOverlay*& overl
     };
 
     ImGui_ImplVulkan_Init(&init_info);
-    renderer->SetupOverlay(width, height, surface_format);
 }
 
 auto ImGuiOverlayWindow::Draw() -> void
@@ -125,15 +127,44 @@ auto ImGuiOverlayWindow::Draw() -> void
         ImGui::Text("This is some useful text.");
         ImGui::InputText("Your input", buffer, IM_ARRAYSIZE(buffer));
         ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / io.Framerate, io.Framerate);
+
+        const Vulkan_RenderStats stats = renderer_->Stats();
+        ImGui::Text("Overlay %.2f submits/frame", stats.overlay_frames > 0 ? static_cast<double>(stats.overlay_submits) / stats.overlay_frames : 0.0);
+        ImGui::Text("Overlay %llu unchanged frames skipped", static_cast<unsigned long long>(stats.overlay_frames_skipped));
+        ImGui::Text("Overlay %llu partially redrawn frames", static_cast<unsigned long long>(stats.overlay_partial_frames));
+
+        for (const Vulkan_GpuTiming& timing : renderer_->GpuTimings()) {
+            if (timing.samples > 0)
+                ImGui::Text("GPU %s: min %.3f mean %.3f p99 %.3f max %.3f ms", timing.name, timing.min_ms, timing.mean_ms, timing.p99_ms, timing.max_ms);
+        }
+
+#ifdef ENABLE_PROFILER
+        if (ImGui::Button("Write CPU trace"))
+            Profiler::WriteChromeTrace();
+#endif
+
+        if (!capture_path_.empty()) {
+            if (!capture_.Recording() && ImGui::Button("Start draw capture"))
+                capture_.Open(capture_path_);
+            else if (capture_.Recording() && ImGui::Button("Stop draw capture"))
+                capture_.Close();
+            if (capture_.Frames() > 0) {
+                ImGui::SameLine();
+                ImGui::Text("%u frames captured", capture_.Frames());
+            }
+        }
         ImGui::End();
     }
 
     // == Menu Render End
 
     ImGui::Render();
+
+    capture_.Record(ImGui::GetDrawData());
 }
 
 auto ImGuiOverlayWindow::Destroy() -> void
 {
+    capture_.Close();
     ImGui_ImplOpenVR_Shutdown();
 }
\ No newline at end of file
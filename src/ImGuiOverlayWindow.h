@@ -11,6 +11,7 @@
 #include <imgui.h>
 
 #include "VulkanRenderer.h"
+#include "ImDrawDataCapture.h"
 #include "VrOverlay.h"
 
 class ImGuiOverlayWindow
@@ -19,12 +20,19 @@ public:
     explicit ImGuiOverlayWindow();
     auto Initialize(VulkanRenderer*& renderer, VrOverlay*& overlay, int width, int height) -> void;
 
-    [[nodiscard]] auto OverlayData() -> Vulkan_Overlay* { return reinterpret_cast<Vulkan_Overlay*>(&overlay_data_); };
+    // Format the pipeline renders in, overlay textures drawn with this window's draw data must use it
+    [[nodiscard]] auto SurfaceFormat() const -> VkSurfaceFormatKHR { return surface_format_; }
 
     auto Draw() -> void;
+
+    // Where the capture button in the UI writes the draw data to, nothing is recorded until it is pressed
+    auto SetCapturePath(const std::string& path) -> void { capture_path_ = path; }
     auto Destroy() -> void;
 
 private:
 
-    Vulkan_Overlay overlay_data_;
+    VkSurfaceFormatKHR surface_format_;
+    VulkanRenderer* renderer_;
+    ImDrawDataCaptureWriter capture_;
+    std::string capture_path_;
 };
\ No newline at end of file
@@ -13,6 +13,7 @@
 #include <backends/imgui_impl_vulkan.h>
 
 #include "backends/imgui_impl_openvr.h"
+#include "Profiler.h"
 
 #include <SDL3/SDL.h>
 #include <SDL3/SDL_vulkan.h>
@@ -22,6 +23,7 @@
 ImGuiWindow::ImGuiWindow()
 {
     window_ = nullptr;
+    renderer_ = nullptr;
     window_data_ = {};
     window_shown_ = false;
     window_minimized_ = false;
@@ -30,6 +32,8 @@ ImGuiWindow::ImGuiWindow()
 
 auto ImGuiWindow::Initialize(VulkanRenderer*& renderer, const char* name, int width, int height, float dpiScale, bool show) -> void
 {
+    renderer_ = renderer;
+
     auto sdl_window_flags = SDL_WINDOW_VULKAN | SDL_WINDOW_HIDDEN | SDL_WINDOW_MOUSE_FOCUS | SDL_WINDOW_HIGH_PIXEL_DENSITY;
     window_ = SDL_CreateWindow(name, width * static_cast<int>(dpiScale), height * static_cast<int>(dpiScale), sdl_window_flags);
     if (window_ == nullptr) {
@@ -113,7 +117,8 @@ auto ImGuiWindow::Initialize(VulkanRenderer*& renderer, const char* name, int wi
         .DescriptorPool = renderer->DescriptorPool(),
         .RenderPass = VK_NULL_HANDLE,
         .MinImageCount = renderer->MinimumConcurrentImageCount(),
-        .ImageCount = window->image_count,
+        // ImGui rotates its vertex/index buffers on every RenderDrawData call, this context is only drawn into the window
+        .ImageCount = VulkanRenderer::ImGuiRenderBufferCount(0),
         .MSAASamples = VK_SAMPLE_COUNT_1_BIT,
         .PipelineCache = renderer->PipelineCache(),
         .Subpass = 0,
@@ -175,16 +180,45 @@ auto ImGuiWindow::Draw() -> void
         ImGui::Text("This is some useful text.");
         ImGui::InputText("Your input", buffer, IM_ARRAYSIZE(buffer));
         ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / io.Framerate, io.Framerate);
+
+        const Vulkan_RenderStats stats = renderer_->Stats();
+        ImGui::Text("Overlay %.2f submits/frame", stats.overlay_frames > 0 ? static_cast<double>(stats.overlay_submits) / stats.overlay_frames : 0.0);
+        ImGui::Text("Overlay %llu unchanged frames skipped", static_cast<unsigned long long>(stats.overlay_frames_skipped));
+        ImGui::Text("Overlay %llu partially redrawn frames", static_cast<unsigned long long>(stats.overlay_partial_frames));
+
+        for (const Vulkan_GpuTiming& timing : renderer_->GpuTimings()) {
+            if (timing.samples > 0)
+                ImGui::Text("GPU %s: min %.3f mean %.3f p99 %.3f max %.3f ms", timing.name, timing.min_ms, timing.mean_ms, timing.p99_ms, timing.max_ms);
+        }
+
+#ifdef ENABLE_PROFILER
+        if (ImGui::Button("Write CPU trace"))
+            Profiler::WriteChromeTrace();
+#endif
+
+        if (!capture_path_.empty()) {
+            if (!capture_.Recording() && ImGui::Button("Start draw capture"))
+                capture_.Open(capture_path_);
+            else if (capture_.Recording() && ImGui::Button("Stop draw capture"))
+                capture_.Close();
+            if (capture_.Frames() > 0) {
+                ImGui::SameLine();
+                ImGui::Text("%u frames captured", capture_.Frames());
+            }
+        }
         ImGui::End();
     }
 
     // == Menu Render End
 
     ImGui::Render();
+
+    capture_.Record(ImGui::GetDrawData());
 }
 
 auto ImGuiWindow::Destroy(VulkanRenderer*& renderer) -> void
 {
+    capture_.Close();
     ImGui_ImplSDL3_Shutdown();
     SDL_DestroyWindow(window_);
 }
\ No newline at end of file
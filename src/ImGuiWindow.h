@@ -14,6 +14,7 @@
 #include <SDL3/SDL.h>
 
 #include "VulkanRenderer.h"
+#include "ImDrawDataCapture.h"
 
 class ImGuiWindow
 {
@@ -33,11 +34,17 @@ public:
     auto SetKeyboardActiveState(bool state) -> void;
     auto Draw() -> void;
 
+    // Where the capture button in the UI writes the draw data to, nothing is recorded until it is pressed
+    auto SetCapturePath(const std::string& path) -> void { capture_path_ = path; }
+
     auto Destroy(VulkanRenderer*& renderer) -> void;
 
 private:
 
     SDL_Window* window_;
+    VulkanRenderer* renderer_;
+    ImDrawDataCaptureWriter capture_;
+    std::string capture_path_;
     Vulkan_Window window_data_;
     bool window_shown_;
     bool window_minimized_;
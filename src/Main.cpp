@@ -9,6 +9,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+#include <algorithm>
 #include <sstream>
 #include <fstream>
 #include <vector>
@@ -38,8 +39,21 @@
 #include "VrOverlay.h"
 #include "VrUtils.h"
 
+#include "OverlayManager.h"
+#include "Profiler.h"
+#include "FramePacer.h"
+#include "IdleScheduler.h"
+#include "RenderThread.h"
+#include "VrEventPump.h"
+#include "VrPropertyCache.h"
+#include "VrPoseService.h"
+
 #include "backends/imgui_impl_openvr.h"
 
+#ifdef ENABLE_MOCK_OPENVR
+#include "MockOpenVR.h"
+#endif
+
 #ifdef _WIN32
 extern "C" __declspec(dllexport) unsigned long NvOptimusEnablement = 0x00000001;
 extern "C" __declspec(dllexport) unsigned long AmdPowerXpressRequestHighPerformance = 0x00000001;
@@ -48,9 +62,16 @@ extern "C" __declspec(dllexport) unsigned long AmdPowerXpressRequestHighPerforma
 static VulkanRenderer* g_vulkanRenderer = new VulkanRenderer();
 static ImGuiWindow* g_imGuiWindow = new ImGuiWindow();
 static ImGuiOverlayWindow* g_ImGuiOverlayWindow = new ImGuiOverlayWindow();
-static VrOverlay* g_overlay = new VrOverlay();
-
-static uint64_t g_last_frame_time = SDL_GetTicksNS();
+static VrOverlay* g_overlay = nullptr;
+
+static OpenVRFrameClock g_frame_clock = {};
+static FramePacer g_frame_pacer = FramePacer(g_frame_clock);
+static IdleScheduler g_idle_scheduler = IdleScheduler();
+static RenderThread g_render_thread = RenderThread();
+static VrEventPump g_vr_event_pump = VrEventPump();
+static OverlayManager g_overlay_manager = OverlayManager();
+static uint64_t g_texture_generation = 0;         // UI thread
+static uint64_t g_rendered_texture_generation = 0; // render thread
 static float g_hmd_refresh_rate = 24.0f;
 static bool g_ticking = true;
 
@@ -60,12 +81,16 @@ static bool g_ticking = true;
 #define WIN_WIDTH   1280
 #define WIN_HEIGHT  720
 
+// Start building the UI this long after the compositor's vsync
+#define FRAME_PHASE_OFFSET_SECONDS  0.0
+
 static auto UpdateApplicationRefreshRate() -> void
 {
     try {
         auto hmd_properties = VrTrackedDeviceProperties::FromDeviceIndex(vr::k_unTrackedDeviceIndex_Hmd);
         hmd_properties.CheckConnection();
         g_hmd_refresh_rate = hmd_properties.GetFloat(vr::Prop_DisplayFrequency_Float);
+        g_frame_pacer.SetRefreshRate(g_hmd_refresh_rate);
     }
     catch (std::exception& ex) {
         printf("%s\n\n", ex.what());
@@ -74,12 +99,87 @@ static auto UpdateApplicationRefreshRate() -> void
     }
 }
 
+// Runs on the render thread, the only place the swapchain and the overlay textures are touched while the main loop runs
+static auto RenderSubmittedFrame(RenderFrame& frame) -> void
+{
+    // UpdateTextures on the UI thread waits for this before it changes a texture the frame may sample
+    std::lock_guard<std::mutex> render_lock(g_vulkanRenderer->RenderMutex());
+
+    ImDrawData* draw_data = frame.draw_data.DrawData();
+    if (draw_data == nullptr)
+        return;
+
+    // The UI thread replaced glyphs or images behind the draw data, what is in the overlay texture can't be trusted
+    if (frame.texture_generation != g_rendered_texture_generation) {
+        g_rendered_texture_generation = frame.texture_generation;
+#ifdef IMGUI_OPENVR_PLATFORM_BACKEND
+        g_overlay_manager.Invalidate();
+#else
+        g_vulkanRenderer->InvalidateOverlay();
+#endif
+    }
+
+#ifdef IMGUI_OPENVR_PLATFORM_BACKEND
+    // Every overlay the manager owns goes out in one submission, overlays without new draw data keep their texture
+    g_overlay_manager.SetDrawData(g_overlay, draw_data);
+    g_overlay_manager.Render();
+#endif
+
+#ifdef IMGUI_SDL_PLATFORM_BACKEND
+    const int fb_width = frame.framebuffer_width;
+    const int fb_height = frame.framebuffer_height;
+
+    if ((fb_width != 0 && fb_height != 0) && (g_vulkanRenderer->ShouldRebuildSwapchain() || g_imGuiWindow->WindowData()->width != fb_width || g_imGuiWindow->WindowData()->height != fb_height))
+    {
+        PROFILE_SCOPE("Swapchain rebuild");
+
+        {
+            // The backend state is shared with the texture uploads of the UI thread
+            std::lock_guard<std::mutex> queue_lock(g_vulkanRenderer->QueueMutex());
+            ImGui_ImplVulkan_SetMinImageCount(g_vulkanRenderer->MinimumConcurrentImageCount());
+        }
+
+        g_imGuiWindow->WindowData()->width = fb_width;
+        g_imGuiWindow->WindowData()->width = fb_height;
+
+        g_vulkanRenderer->SetupSwapchain(g_imGuiWindow->WindowData(), fb_width, fb_height);
+        g_imGuiWindow->WindowData()->frame_index = 0;
+    }
+
+    const ImVec4 background_color = ImVec4(0.45f, 0.55f, 0.60f, 1.00f);
+
+    g_imGuiWindow->WindowData()->clear_value.color.float32[0] = background_color.x * background_color.w;
+    g_imGuiWindow->WindowData()->clear_value.color.float32[1] = background_color.y * background_color.w;
+    g_imGuiWindow->WindowData()->clear_value.color.float32[2] = background_color.z * background_color.w;
+    g_imGuiWindow->WindowData()->clear_value.color.float32[3] = background_color.w;
+
+    const bool is_minimized = frame.window_minimized;
+    g_imGuiWindow->WindowData()->is_minimized = is_minimized;
+
+    // While both are live the UI is rasterized once into the overlay texture and copied into the window.
+    if (!is_minimized && g_vulkanRenderer->CanMirror(g_imGuiWindow->WindowData()) && g_overlay->IsVisible()) {
+        g_vulkanRenderer->RenderMirrored(draw_data, g_imGuiWindow->WindowData(), g_overlay);
+        g_vulkanRenderer->Present(g_imGuiWindow->WindowData());
+    }
+    else {
+        if (!is_minimized) {
+            g_vulkanRenderer->RenderWindow(draw_data, g_imGuiWindow->WindowData());
+            g_vulkanRenderer->Present(g_imGuiWindow->WindowData());
+        }
+
+        g_vulkanRenderer->RenderOverlay(draw_data, g_overlay);
+    }
+#endif
+}
+
 int main(
     [[maybe_unused]] int argc, 
     [[maybe_unused]] char** argv
 ) {
     std::srand(std::time(nullptr));
 
+    PROFILE_THREAD("Main");
+
     // Initialize the overlay as "VRApplication_Background" instead of "VRApplication_Overlay"
     // This makes sure that the overlay *cannot* run while SteamVR is not running.
     try {
@@ -90,7 +190,11 @@ int main(
         return EXIT_FAILURE;
     }
 
+    // Device panels and the refresh rate below read properties from here instead of asking vrserver each time
+    VrPropertyCache::Prefetch();
     UpdateApplicationRefreshRate();
+    g_frame_pacer.SetPhaseOffset(FRAME_PHASE_OFFSET_SECONDS);
+    VrPoseService::SetFramePacer(&g_frame_pacer);
 
     try {
         if (!OpenVRManifestInstalled(APP_KEY)) OpenVRManifestInstall();
@@ -100,12 +204,15 @@ int main(
         return EXIT_FAILURE;
     }
     
+    // Overlays are polled for events from the moment they are added
+    g_overlay_manager.SetEventPump(&g_vr_event_pump);
+
     try {
         char overlay_key[100];
         snprintf(overlay_key, 100, "%s-%d", APP_KEY, std::rand() % 1024); // chances of overlap? Slim.
 
 #ifdef EXAMPLE_OVERLAY_TYPE_DASHBOARD
-        g_overlay->Create(vr::VROverlayType_Dashboard, overlay_key, APP_NAME);
+        g_overlay = g_overlay_manager.Add(vr::VROverlayType_Dashboard, overlay_key, APP_NAME);
 
         // when overlay is VROverlayType_Dashboard we should set a thumbnail for the dashboard
         std::string thumbnail_path = {};
@@ -121,7 +228,7 @@ int main(
 #endif
 
 #ifdef EXAMPLE_OVERLAY_DEVICE_RELATIVE
-        g_overlay->Create(vr::VROverlayType_World, overlay_key, APP_NAME);
+        g_overlay = g_overlay_manager.Add(vr::VROverlayType_World, overlay_key, APP_NAME);
 
         g_overlay->SetInputMethod(vr::VROverlayInputMethod_Mouse);
         g_overlay->SetWidth(0.15f);
@@ -141,7 +248,7 @@ int main(
 #endif
 
 #ifdef EXAMPLE_OVERLAY_ORIGIN_RELATIVE
-        g_overlay->Create(vr::VROverlayType_World, overlay_key, APP_NAME);
+        g_overlay = g_overlay_manager.Add(vr::VROverlayType_World, overlay_key, APP_NAME);
 
         g_overlay->SetInputMethod(vr::VROverlayInputMethod_Mouse);
         g_overlay->SetWidth(1.0f);
@@ -171,75 +278,184 @@ int main(
     }
 #endif
 
-    g_vulkanRenderer->Initialize();
+    std::string pipeline_cache_path = {};
+    std::string capture_path = {};
+    if (char* pref_path = SDL_GetPrefPath("github", "VulkanOverlayExample")) {
+        pipeline_cache_path += pref_path;
+        pipeline_cache_path += "pipeline_cache.bin";
+        capture_path = std::string(pref_path) + "capture.imdc";
+        Profiler::SetOutputPath(std::string(pref_path) + "trace.json");
+        SDL_free(pref_path);
+    }
+
+    g_vulkanRenderer->Initialize(pipeline_cache_path);
 
 #ifdef IMGUI_OPENVR_PLATFORM_BACKEND
     g_ImGuiOverlayWindow->Initialize(g_vulkanRenderer, g_overlay, WIN_WIDTH, WIN_HEIGHT);
+    g_ImGuiOverlayWindow->SetCapturePath(capture_path);
+    g_overlay_manager.Initialize(g_vulkanRenderer);
+    g_overlay_manager.SetupTexture(g_overlay, WIN_WIDTH, WIN_HEIGHT, g_ImGuiOverlayWindow->SurfaceFormat());
 #else
     float dpiScale = SDL_GetDisplayContentScale(SDL_GetPrimaryDisplay());
     g_imGuiWindow->Initialize(g_vulkanRenderer, APP_NAME, WIN_WIDTH, WIN_HEIGHT, dpiScale);
+    g_imGuiWindow->SetCapturePath(capture_path);
     g_vulkanRenderer->SetupOverlay(WIN_WIDTH, WIN_HEIGHT, g_imGuiWindow->WindowData()->surface_format);
 #endif
 
     SDL_Event event = {};
-    vr::VREvent_t vr_event = {};
+    VrInputEvent vr_input = {};
+
+    // Overlay events are polled on a thread of their own from here on and drained below before each frame
+    g_vr_event_pump.SetSystemEvents(true);
+    g_vr_event_pump.SetPollInterval(VrEventPump::PollIntervalUs(g_hmd_refresh_rate));
+#ifdef IMGUI_SDL_PLATFORM_BACKEND
+    // An idle loop waits on SDL, a VR event has to show up there to end the wait early
+    const Uint32 vr_wake_event_type = SDL_RegisterEvents(1);
+    g_vr_event_pump.Start([vr_wake_event_type]() {
+        SDL_Event wake_event = {};
+        wake_event.type = vr_wake_event_type;
+        SDL_PushEvent(&wake_event);
+    });
+#else
+    g_vr_event_pump.Start();
+#endif
+
+    // From here on the main thread builds the UI and the render thread records and submits it, one frame behind
+    g_render_thread.Start(RenderSubmittedFrame);
 
     while (g_ticking)
     {
+        PROFILE_SCOPE("Frame");
+
+        // Nothing is on screen, block until something happens or OpenVR has to be polled again.
+        if (g_idle_scheduler.Idle()) {
+            PROFILE_SCOPE("Idle");
+            g_idle_scheduler.Tick();
+
+            const uint32_t timeout_ms = g_idle_scheduler.WakeIntervalMs(vr::VROverlay()->IsDashboardVisible(), g_hmd_refresh_rate);
+            // Nothing is drawn, overlay input only has to be noticed as fast as the idle loop would have polled it.
+            // The system queue stays at HMD rate, dashboard activation arrives there and ends the wait below, the
+            // next iteration then polls the overlays once per HMD frame again.
+            g_vr_event_pump.SetOverlayPollInterval(timeout_ms * 1000);
+#ifdef IMGUI_SDL_PLATFORM_BACKEND
+            // Returns as soon as any SDL event arrives, it stays queued for the poll below
+            SDL_WaitEventTimeout(nullptr, static_cast<Sint32>(timeout_ms));
+#else
+            g_vr_event_pump.WaitForEvents(timeout_ms);
+#endif
+        }
+
 #ifdef IMGUI_SDL_PLATFORM_BACKEND
-        while (SDL_PollEvent(&event))
         {
-            ImGui_ImplSDL3_ProcessEvent(&event);
-
-            if (event.type == SDL_EVENT_WINDOW_MINIMIZED && event.window.windowID == SDL_GetWindowID(g_imGuiWindow->Window()))
-                g_imGuiWindow->SetMinimizedFromEvent(true);
-            if (event.type == SDL_EVENT_WINDOW_RESTORED && event.window.windowID == SDL_GetWindowID(g_imGuiWindow->Window()))
-                g_imGuiWindow->SetMinimizedFromEvent(false);
-            if (event.type == SDL_EVENT_WINDOW_CLOSE_REQUESTED && event.window.windowID == SDL_GetWindowID(g_imGuiWindow->Window()))
-                g_ticking = false;
+            PROFILE_SCOPE("SDL events");
+            while (SDL_PollEvent(&event))
+            {
+                // Only ends the wait above, the VR events it stands for decide below whether idle ends
+                if (event.type == vr_wake_event_type)
+                    continue;
+
+                g_idle_scheduler.Wake(g_frame_clock.Now());
+                ImGui_ImplSDL3_ProcessEvent(&event);
+
+                if (event.type == SDL_EVENT_WINDOW_MINIMIZED && event.window.windowID == SDL_GetWindowID(g_imGuiWindow->Window()))
+                    g_imGuiWindow->SetMinimizedFromEvent(true);
+                if (event.type == SDL_EVENT_WINDOW_RESTORED && event.window.windowID == SDL_GetWindowID(g_imGuiWindow->Window()))
+                    g_imGuiWindow->SetMinimizedFromEvent(false);
+                if (event.type == SDL_EVENT_WINDOW_CLOSE_REQUESTED && event.window.windowID == SDL_GetWindowID(g_imGuiWindow->Window()))
+                    g_ticking = false;
+            }
         }
 #endif
-        while (vr::VROverlay()->PollNextOverlayEvent(g_overlay->Handle(), &vr_event, sizeof(vr_event))) 
+        uint64_t input_timestamp_ns = 0;
         {
-            ImGui_ImplOpenVR_ProcessOverlayEvent(vr_event);
-
-            switch (vr_event.eventType) 
+            PROFILE_SCOPE("VR events");
+            while (g_vr_event_pump.Pop(vr_input)) 
             {
-                case vr::VREvent_PropertyChanged:
+                const vr::VREvent_t& vr_event = vr_input.event;
+
+                // Drops cached properties before anything below reads them again
+                VrPropertyCache::ProcessEvent(vr_event);
+                VrPoseService::ProcessEvent(vr_event);
+
+                // Keeps the visibility each overlay reports in step without asking the runtime every frame
+                VrOverlay* target = g_overlay_manager.ProcessEvent(vr_input);
+
+                // System events are not input, they should not keep the UI awake
+                if (vr_input.handle != vr::k_ulOverlayHandleInvalid) {
+                    if (input_timestamp_ns == 0)
+                        input_timestamp_ns = vr_input.timestamp_ns;
+
+                    g_idle_scheduler.Wake(g_frame_clock.Now());
+                    // The ImGui context only drives g_overlay
+                    if (target == g_overlay)
+                        ImGui_ImplOpenVR_ProcessOverlayEvent(vr_event);
+                }
+
+                switch (vr_event.eventType) 
                 {
-                    // Some drivers such as lighthouse or vrlink are capable of changing
-                    // vr::Prop_DisplayFrequency_Float without restarting SteamVR
-                    if (vr_event.data.property.prop == vr::Prop_DisplayFrequency_Float) {
-                        UpdateApplicationRefreshRate();
+                    case vr::VREvent_PropertyChanged:
+                    {
+                        // Some drivers such as lighthouse or vrlink are capable of changing
+                        // vr::Prop_DisplayFrequency_Float without restarting SteamVR
+                        if (vr_event.data.property.prop == vr::Prop_DisplayFrequency_Float) {
+                            UpdateApplicationRefreshRate();
+                            g_vr_event_pump.SetPollInterval(VrEventPump::PollIntervalUs(g_hmd_refresh_rate));
+                        }
+                        break;
                     }
-                    break;
-                }
 #ifdef IMGUI_SDL_PLATFORM_BACKEND
-                case vr::VREvent_OverlayShown:
-                {
-                    if (g_overlay->IsVisible() && g_imGuiWindow->Shown()) {
-                        g_imGuiWindow->Hide();
+                    case vr::VREvent_OverlayShown:
+                    {
+                        if (g_overlay->IsVisible() && g_imGuiWindow->Shown()) {
+                            g_imGuiWindow->Hide();
+                        }
+                        break;
                     }
-                    break;
-                }
-                case vr::VREvent_OverlayHidden:
-                {
-                    if (!g_overlay->IsVisible() && g_imGuiWindow->Shown()) {
-                        g_imGuiWindow->Show();
+                    case vr::VREvent_OverlayHidden:
+                    {
+                        if (!g_overlay->IsVisible() && g_imGuiWindow->Shown()) {
+                            g_imGuiWindow->Show();
+                        }
+                        break;
                     }
-                    break;
-                }
 #endif
-                case vr::VREvent_Quit:
-                {
-                    g_ticking = false;
-                    return false;
+                    case vr::VREvent_Quit:
+                    {
+                        g_ticking = false;
+                        break;
+                    }
                 }
             }
+
+            // The SDL3 backend owns the context in the windowed build, the held back mouse input is queued here for both
+            ImGui_ImplOpenVR_FlushOverlayEvents();
+        }
+
+        // Leave through the teardown below, the render thread and the event pump have to be stopped first
+        if (!g_ticking)
+            break;
+
+        if (g_idle_scheduler.Idle()) {
+            if (!g_overlay->IsVisible())
+                continue;
+
+            g_idle_scheduler.Wake(g_frame_clock.Now());
         }
 
+        // The pacer's schedule went stale while idle, start over instead of counting the gap as missed frames
+        if (g_idle_scheduler.Resumed()) {
+            g_frame_pacer.Reset();
+            g_vr_event_pump.SetPollInterval(VrEventPump::PollIntervalUs(g_hmd_refresh_rate));
+        }
+
+        // Whatever this frame builds reads poses from here, the first read queries them for every device
+        VrPoseService::BeginFrame();
+
 #ifdef IMGUI_OPENVR_PLATFORM_BACKEND
-        g_ImGuiOverlayWindow->Draw();
+        {
+            PROFILE_SCOPE("ImGui frame");
+            g_ImGuiOverlayWindow->Draw();
+        }
 #endif
 
 #ifdef IMGUI_SDL_PLATFORM_BACKEND
@@ -263,59 +479,145 @@ int main(
         fb_width *= static_cast<int>(dpiScale);
         fb_height *= static_cast<int>(dpiScale);
 
-        if ((fb_width != 0 && fb_height != 0) && (g_vulkanRenderer->ShouldRebuildSwapchain() || g_imGuiWindow->WindowData()->width != fb_width || g_imGuiWindow->WindowData()->height != fb_height))
+        g_overlay->SetMouseScale(fb_width, fb_height);
         {
-            ImGui_ImplVulkan_SetMinImageCount(g_vulkanRenderer->MinimumConcurrentImageCount());
-
-            g_imGuiWindow->WindowData()->width = fb_width;
-            g_imGuiWindow->WindowData()->width = fb_height;
-
-            g_vulkanRenderer->SetupSwapchain(g_imGuiWindow->WindowData(), fb_width, fb_height);
-            g_imGuiWindow->WindowData()->frame_index = 0;
+            PROFILE_SCOPE("ImGui frame");
+            g_imGuiWindow->Draw();
         }
-
-        g_overlay->SetMouseScale(fb_width, fb_height);
-        g_imGuiWindow->Draw();
 #endif
 
-        ImDrawData* draw_data = ImGui::GetDrawData();
+        {
+            PROFILE_SCOPE("Submit frame");
 
-#ifdef IMGUI_OPENVR_PLATFORM_BACKEND
-        g_vulkanRenderer->RenderOverlay(draw_data, g_overlay);
-#endif
+            ImDrawData* draw_data = ImGui::GetDrawData();
 
-#ifdef IMGUI_SDL_PLATFORM_BACKEND
-        const ImVec4 background_color = ImVec4(0.45f, 0.55f, 0.60f, 1.00f);
+            // Textures are owned by the ImGui context, they are brought up to date here before the draw data leaves this thread
+            if (g_vulkanRenderer->UpdateTextures(draw_data))
+                g_texture_generation++;
 
-        g_imGuiWindow->WindowData()->clear_value.color.float32[0] = background_color.x * background_color.w;
-        g_imGuiWindow->WindowData()->clear_value.color.float32[1] = background_color.y * background_color.w;
-        g_imGuiWindow->WindowData()->clear_value.color.float32[2] = background_color.z * background_color.w;
-        g_imGuiWindow->WindowData()->clear_value.color.float32[3] = background_color.w;
+            RenderFrame& frame = g_render_thread.NextFrame();
+            frame.draw_data.Copy(draw_data);
+            frame.texture_generation = g_texture_generation;
+            frame.input_timestamp_ns = input_timestamp_ns;
+#ifdef IMGUI_SDL_PLATFORM_BACKEND
+            frame.framebuffer_width = fb_width;
+            frame.framebuffer_height = fb_height;
+            frame.window_minimized = g_imGuiWindow->Shown() && g_imGuiWindow->Minimized();
+#endif
+            g_render_thread.Submit();
+        }
 
-        const bool is_minimized = g_imGuiWindow->Shown() && g_imGuiWindow->Minimized();
-        g_imGuiWindow->WindowData()->is_minimized = is_minimized;
+        {
+            ImGuiIO& io = ImGui::GetIO();
 
-        if (!is_minimized) {
-            g_vulkanRenderer->RenderWindow(draw_data, g_imGuiWindow->WindowData());
-            g_vulkanRenderer->Present(g_imGuiWindow->WindowData());
-        }
-        
-        g_vulkanRenderer->RenderOverlay(draw_data, g_overlay);
+            IdleFrameState idle_state = {
+                .overlay_visible = g_overlay->IsVisible(),
+                .window_visible = false,
+                .ui_busy = io.WantTextInput || ImGui::IsAnyItemActive() || ImGui::IsAnyItemHovered() || std::ranges::any_of(io.MouseDown, [](bool down) { return down; }),
+            };
+#ifdef IMGUI_SDL_PLATFORM_BACKEND
+            idle_state.window_visible = g_imGuiWindow->Shown() && !g_imGuiWindow->Minimized();
+            idle_state.ui_busy |= g_imGuiWindow->KeyboardActive();
 #endif
-        uint64_t target_time = static_cast<uint64_t>((static_cast<float>(1000000000) / g_hmd_refresh_rate));
-        const uint64_t frame_duration = (SDL_GetTicksNS() - g_last_frame_time);
-
-        if (frame_duration < target_time) {
-            SDL_DelayPrecise(target_time - frame_duration);
+            g_idle_scheduler.EndFrame(idle_state, g_frame_clock.Now());
         }
 
-        g_last_frame_time = SDL_GetTicksNS();
+        // Lines the next UI build up with the compositor's frame instead of sleeping a fixed amount.
+        if (!g_idle_scheduler.Idle())
+            g_frame_pacer.Wait();
     }
 
+    g_vr_event_pump.Stop();
+    g_render_thread.Stop();
+
+#ifdef ENABLE_PROFILER
+    // Counters of every subsystem, printed next to the trace it complements
+    const FramePacerStats& pacer_stats = g_frame_pacer.Stats();
+    printf("Frame pacing: %llu frames, %llu compositor frames missed, %llu duplicated\n",
+        static_cast<unsigned long long>(pacer_stats.frames),
+        static_cast<unsigned long long>(pacer_stats.missed_frames),
+        static_cast<unsigned long long>(pacer_stats.duplicated_frames));
+
+    const IdleSchedulerStats& idle_stats = g_idle_scheduler.Stats();
+    printf("Idle: entered %llu times, %.1f s total, %llu wake ups\n",
+        static_cast<unsigned long long>(idle_stats.idle_entries),
+        static_cast<double>(idle_stats.idle_ns) / 1e9,
+        static_cast<unsigned long long>(idle_stats.idle_wakeups));
+
+    const RenderThreadStats render_stats = g_render_thread.Stats();
+    printf("Render thread: %llu frames submitted, %llu rendered, %llu replaced before rendering\n",
+        static_cast<unsigned long long>(render_stats.frames_submitted),
+        static_cast<unsigned long long>(render_stats.frames_rendered),
+        static_cast<unsigned long long>(render_stats.frames_replaced));
+
+    const VrEventPumpStats pump_stats = g_vr_event_pump.Stats();
+    printf("VR input: %llu events polled in %llu polls, %llu of them over the overlays, %llu cut short by a full queue, polled to drained %.2f ms avg %.2f ms max, polled to submitted %.2f ms avg %.2f ms max\n",
+        static_cast<unsigned long long>(pump_stats.events_polled),
+        static_cast<unsigned long long>(pump_stats.polls),
+        static_cast<unsigned long long>(pump_stats.overlay_polls),
+        static_cast<unsigned long long>(pump_stats.queue_full),
+        static_cast<double>(pump_stats.latency_total_ns) / 1e6 / static_cast<double>(std::max<uint64_t>(pump_stats.events_drained, 1)),
+        static_cast<double>(pump_stats.latency_max_ns) / 1e6,
+        static_cast<double>(render_stats.input_latency_total_ns) / 1e6 / static_cast<double>(std::max<uint64_t>(render_stats.input_frames, 1)),
+        static_cast<double>(render_stats.input_latency_max_ns) / 1e6);
+
+    const VrOverlayStats overlay_stats = g_overlay->Stats();
+    printf("Overlay: %llu IPC calls, %llu answered from the shadow state\n",
+        static_cast<unsigned long long>(overlay_stats.ipc_calls),
+        static_cast<unsigned long long>(overlay_stats.ipc_calls_skipped));
+
+    const Vulkan_RenderStats vulkan_stats = g_vulkanRenderer->Stats();
+    const OverlayManagerStats manager_stats = g_overlay_manager.Stats();
+    printf("Overlay rendering: %u overlays, %.2f overlays per render, %llu frames in %llu submits\n",
+        g_overlay_manager.Count(),
+        manager_stats.renders > 0 ? static_cast<double>(manager_stats.draws) / static_cast<double>(manager_stats.renders) : 0.0,
+        static_cast<unsigned long long>(vulkan_stats.overlay_frames),
+        static_cast<unsigned long long>(vulkan_stats.overlay_submits));
+
+    const VrPropertyCacheStats property_stats = VrPropertyCache::Stats();
+    printf("Device properties: %llu cache hits, %llu misses, %llu invalidations\n",
+        static_cast<unsigned long long>(property_stats.hits),
+        static_cast<unsigned long long>(property_stats.misses),
+        static_cast<unsigned long long>(property_stats.invalidations));
+
+    const VrPoseServiceStats pose_stats = VrPoseService::Stats();
+    printf("Poses: %llu of %llu frames sampled, predicted %.2f ms ahead on average, %llu controller role lookups\n",
+        static_cast<unsigned long long>(pose_stats.samples),
+        static_cast<unsigned long long>(pose_stats.frames),
+        pose_stats.samples > 0 ? pose_stats.predicted_seconds_total * 1e3 / static_cast<double>(pose_stats.samples) : 0.0,
+        static_cast<unsigned long long>(pose_stats.role_lookups));
+
+    const ImGui_ImplOpenVR_InputStats input_stats = ImGui_ImplOpenVR_GetInputStats();
+    printf("VR input: %llu events received, %llu forwarded to ImGui\n",
+        static_cast<unsigned long long>(input_stats.events_received),
+        static_cast<unsigned long long>(input_stats.events_forwarded));
+#endif
+
+#ifdef ENABLE_MOCK_OPENVR
+    const MockOpenVRStats mock_stats = MockOpenVR::Stats();
+    printf("OpenVR: %llu calls, %.1f per frame\n",
+        static_cast<unsigned long long>(mock_stats.calls),
+        static_cast<double>(mock_stats.calls) / static_cast<double>(std::max<uint64_t>(g_frame_pacer.Stats().frames, 1)));
+
+    const std::vector<MockOpenVRMethodStats> method_stats = MockOpenVR::MethodStats();
+    for (size_t i = 0; i < std::min<size_t>(method_stats.size(), 10); i++) {
+        printf("  %-48s %10llu calls %10.3f ms\n",
+            method_stats[i].method,
+            static_cast<unsigned long long>(method_stats[i].calls),
+            static_cast<double>(method_stats[i].duration_ns) / 1e6);
+    }
+#endif
+
     VkResult vk_result = vkDeviceWaitIdle(g_vulkanRenderer->Device());
     VK_VALIDATE_RESULT(vk_result);
 
+#ifdef ENABLE_PROFILER
+    if (Profiler::WriteChromeTrace())
+        printf("Wrote trace to %s\n", Profiler::OutputPath().c_str());
+#endif
+
     g_ImGuiOverlayWindow->Destroy();
+    g_overlay_manager.Destroy();
     g_vulkanRenderer->DestroyWindow(g_imGuiWindow->WindowData());
     g_imGuiWindow->Destroy(g_vulkanRenderer);
     g_vulkanRenderer->Destroy();
@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2025. Nyabsi <nyabsi@sovellus.cc>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Bounded lock free queue for any number of producers and a single consumer. Every cell carries a sequence
+// number telling whose turn it is, producers claim a cell by moving the tail forward and the consumer frees it
+// again by moving its sequence one lap ahead. Nothing is allocated after construction, a full queue rejects.
+template <typename T, size_t Capacity>
+class MpscQueue {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    explicit MpscQueue()
+    {
+        for (size_t i = 0; i < Capacity; i++)
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+
+        tail_.store(0, std::memory_order_relaxed);
+        head_ = 0;
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    // Producer side, any thread. Returns false if the queue is full
+    auto Push(const T& value) -> bool
+    {
+        size_t position = tail_.load(std::memory_order_relaxed);
+        Cell* cell = nullptr;
+
+        for (;;) {
+            cell = &cells_[position & INDEX_MASK];
+            const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            const intptr_t distance = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+
+            if (distance == 0) {
+                if (tail_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (distance < 0) {
+                // The consumer has not freed this cell yet
+                return false;
+            }
+            else {
+                position = tail_.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->value = value;
+        cell->sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side. Returns false if nothing is queued
+    auto Pop(T& value) -> bool
+    {
+        Cell& cell = cells_[head_ & INDEX_MASK];
+        if (cell.sequence.load(std::memory_order_acquire) != head_ + 1)
+            return false;
+
+        value = cell.value;
+        cell.sequence.store(head_ + Capacity, std::memory_order_release);
+        head_++;
+        return true;
+    }
+
+    // Consumer side, a value still being written by a producer counts as not there yet
+    [[nodiscard]] auto Empty() const -> bool
+    {
+        return cells_[head_ & INDEX_MASK].sequence.load(std::memory_order_acquire) != head_ + 1;
+    }
+
+private:
+    static constexpr size_t INDEX_MASK = Capacity - 1;
+
+    struct Cell
+    {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    std::array<Cell, Capacity> cells_;
+    alignas(64) std::atomic<size_t> tail_;  // next cell a producer claims
+    alignas(64) size_t head_;               // next cell the consumer reads, owned by the consumer
+};
@@ -0,0 +1,226 @@
+/*
+ * Copyright (C) 2025. Nyabsi <nyabsi@sovellus.cc>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "OverlayManager.h"
+
+#include <algorithm>
+#include <cassert>
+#include <format>
+#include <stdexcept>
+
+#include "Profiler.h"
+
+OverlayManager::OverlayManager()
+{
+    renderer_ = nullptr;
+    pump_ = nullptr;
+    entries_.clear();
+    removed_.clear();
+    setups_.clear();
+    draws_.clear();
+    stats_ = {};
+}
+
+auto OverlayManager::Add(vr::VROverlayType type, const char* key, const char* name) -> VrOverlay*
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    const auto live = std::count_if(entries_.begin(), entries_.end(), [](const OverlayEntry& entry) { return !entry.removed; });
+    if (static_cast<uint32_t>(live) >= MAX_OVERLAYS)
+        throw std::runtime_error(std::format("Failed to add overlay \"{}\": {} overlays are live already", name, MAX_OVERLAYS));
+
+    auto overlay = std::make_unique<VrOverlay>();
+    overlay->Create(type, key, name);
+
+    if (pump_ != nullptr)
+        pump_->AddOverlay(overlay->Handle());
+
+    entries_.push_back({
+        .overlay = std::move(overlay),
+        .vulkan_overlay = std::make_unique<Vulkan_Overlay>(),
+        .draw_data = nullptr,
+        .setup_width = 0,
+        .setup_height = 0,
+        .setup_format = {},
+        .setup_frame_count = 0,
+        .setup_pending = false,
+        .removed = false,
+    });
+
+    return entries_.back().overlay.get();
+}
+
+auto OverlayManager::SetupTexture(VrOverlay* overlay, uint32_t width, uint32_t height, VkSurfaceFormatKHR format, uint32_t frame_count) -> void
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    OverlayEntry* entry = this->Find(overlay);
+    if (entry == nullptr)
+        return;
+
+    entry->setup_width = width;
+    entry->setup_height = height;
+    entry->setup_format = format;
+    entry->setup_frame_count = frame_count;
+    entry->setup_pending = true;
+}
+
+auto OverlayManager::Remove(VrOverlay* overlay) -> void
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    OverlayEntry* entry = this->Find(overlay);
+    if (entry == nullptr)
+        return;
+
+    if (pump_ != nullptr)
+        pump_->RemoveOverlay(overlay->Handle());
+
+    // A Render in flight may still be handing its texture to OpenVR, the next one destroys it
+    entry->draw_data = nullptr;
+    entry->setup_pending = false;
+    entry->removed = true;
+}
+
+auto OverlayManager::ProcessEvent(const VrInputEvent& event) -> VrOverlay*
+{
+    if (event.handle == vr::k_ulOverlayHandleInvalid)
+        return nullptr;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    for (OverlayEntry& entry : entries_) {
+        if (!entry.removed && entry.overlay->Handle() == event.handle) {
+            entry.overlay->ProcessEvent(event.event);
+            return entry.overlay.get();
+        }
+    }
+
+    return nullptr;
+}
+
+auto OverlayManager::SetDrawData(VrOverlay* overlay, ImDrawData* draw_data) -> void
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (OverlayEntry* entry = this->Find(overlay))
+        entry->draw_data = draw_data;
+}
+
+auto OverlayManager::Invalidate() -> void
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    for (OverlayEntry& entry : entries_)
+        renderer_->InvalidateOverlay(entry.vulkan_overlay.get());
+}
+
+auto OverlayManager::Render() -> void
+{
+    PROFILE_SCOPE("Render overlays");
+
+    assert(renderer_ != nullptr);
+
+    removed_.clear();
+    setups_.clear();
+    draws_.clear();
+
+    // Only the work is picked up under the lock, so routing events on the main thread never waits for a frame.
+    // Entries are only erased here and their objects live on the heap, the pointers stay valid after unlocking.
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        for (OverlayEntry& entry : entries_) {
+            if (entry.removed)
+                removed_.push_back(std::move(entry));
+        }
+        entries_.erase(std::remove_if(entries_.begin(), entries_.end(), [](const OverlayEntry& entry) { return entry.removed; }), entries_.end());
+
+        for (OverlayEntry& entry : entries_) {
+            if (entry.setup_pending) {
+                setups_.push_back({
+                    .vulkan_overlay = entry.vulkan_overlay.get(),
+                    .width = entry.setup_width,
+                    .height = entry.setup_height,
+                    .format = entry.setup_format,
+                    .frame_count = entry.setup_frame_count,
+                });
+                entry.setup_pending = false;
+            }
+
+            if (entry.draw_data == nullptr)
+                continue;
+
+            draws_.push_back({
+                .draw_data = entry.draw_data,
+                .vulkan_overlay = entry.vulkan_overlay.get(),
+                .overlay = entry.overlay.get(),
+            });
+            entry.draw_data = nullptr;
+        }
+    }
+
+    // Removed overlays release their textures here, the deletion queue holds them until their last frames are done
+    for (OverlayEntry& entry : removed_) {
+        entry.overlay->Destroy();
+        renderer_->DestroyOverlay(entry.vulkan_overlay.get());
+    }
+    removed_.clear();
+
+    for (const OverlaySetup& setup : setups_)
+        renderer_->SetupOverlay(setup.vulkan_overlay, setup.width, setup.height, setup.format, setup.frame_count);
+
+    if (draws_.empty())
+        return;
+
+    renderer_->RenderOverlays(draws_);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.renders++;
+    stats_.draws += draws_.size();
+}
+
+auto OverlayManager::Count() -> uint32_t
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return static_cast<uint32_t>(std::count_if(entries_.begin(), entries_.end(), [](const OverlayEntry& entry) { return !entry.removed; }));
+}
+
+auto OverlayManager::Stats() -> OverlayManagerStats
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+auto OverlayManager::Destroy() -> void
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    for (OverlayEntry& entry : entries_) {
+        if (pump_ != nullptr)
+            pump_->RemoveOverlay(entry.overlay->Handle());
+        entry.overlay->Destroy();
+        if (renderer_ != nullptr)
+            renderer_->DestroyOverlay(entry.vulkan_overlay.get());
+    }
+
+    entries_.clear();
+    removed_.clear();
+    setups_.clear();
+    draws_.clear();
+}
+
+auto OverlayManager::Find(const VrOverlay* overlay) -> OverlayEntry*
+{
+    for (OverlayEntry& entry : entries_) {
+        if (!entry.removed && entry.overlay.get() == overlay)
+            return &entry;
+    }
+
+    return nullptr;
+}
@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2025. Nyabsi <nyabsi@sovellus.cc>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <imgui.h>
+#include <openvr.h>
+
+#include "VulkanRenderer.h"
+#include "VrEventPump.h"
+#include "VrOverlay.h"
+
+struct OverlayManagerStats
+{
+    uint64_t renders;   // Render calls that had something to draw
+    uint64_t draws;     // overlays handed to the renderer, summed over every render
+};
+
+// Owns every overlay of the application together with its textures. All of them are drawn by one Render call
+// on the render thread, recorded into a single command buffer and submitted once, and their events come out of
+// the one VrEventPump every overlay is registered with.
+//
+// Add, SetupTexture, Remove and ProcessEvent belong to the main thread, SetDrawData, Invalidate and Render to the
+// render thread. Textures are only created and released inside Render, the renderer's deletion queue is not
+// shared between threads. Render only holds the lock while it picks up the work, recording, submitting and
+// handing the textures to OpenVR happen without it.
+class OverlayManager {
+public:
+    static constexpr uint32_t MAX_OVERLAYS = VulkanRenderer::MAX_BATCHED_OVERLAYS;
+
+    explicit OverlayManager();
+
+    OverlayManager(const OverlayManager&) = delete;
+    OverlayManager& operator=(const OverlayManager&) = delete;
+
+    // Overlays added from here on are polled by pump, set before the first Add
+    auto SetEventPump(VrEventPump* pump) -> void { pump_ = pump; }
+    auto Initialize(VulkanRenderer* renderer) -> void { renderer_ = renderer; }
+
+    // Throws when OpenVR refuses the overlay or MAX_OVERLAYS are live already
+    auto Add(vr::VROverlayType type, const char* key, const char* name) -> VrOverlay*;
+    // The texture ring is created on the next Render, setting up again resizes it
+    auto SetupTexture(VrOverlay* overlay, uint32_t width, uint32_t height, VkSurfaceFormatKHR format, uint32_t frame_count = 3) -> void;
+    // Events stop right away, the OpenVR overlay is destroyed by the next Render and its textures once the frames using them are done
+    auto Remove(VrOverlay* overlay) -> void;
+    // Routes an event polled by the pump to the overlay it belongs to, nullptr for system events and unknown handles
+    auto ProcessEvent(const VrInputEvent& event) -> VrOverlay*;
+
+    // What overlay shows after the next Render, nullptr keeps what it shows now. Overlays sharing an ImGui context
+    // need its ImageCount from VulkanRenderer::ImGuiRenderBufferCount for that many overlays.
+    auto SetDrawData(VrOverlay* overlay, ImDrawData* draw_data) -> void;
+    // Forgets what every texture shows, the next Render draws each overlay in full
+    auto Invalidate() -> void;
+    auto Render() -> void;
+
+    [[nodiscard]] auto Count() -> uint32_t;
+    [[nodiscard]] auto Stats() -> OverlayManagerStats;
+
+    // Render thread stopped, before the renderer is destroyed
+    auto Destroy() -> void;
+
+private:
+    struct OverlayEntry
+    {
+        std::unique_ptr<VrOverlay> overlay;
+        std::unique_ptr<Vulkan_Overlay> vulkan_overlay;
+        ImDrawData* draw_data;
+        uint32_t setup_width;
+        uint32_t setup_height;
+        VkSurfaceFormatKHR setup_format;
+        uint32_t setup_frame_count;
+        bool setup_pending;
+        bool removed;
+    };
+
+    struct OverlaySetup
+    {
+        Vulkan_Overlay* vulkan_overlay;
+        uint32_t width;
+        uint32_t height;
+        VkSurfaceFormatKHR format;
+        uint32_t frame_count;
+    };
+
+    auto Find(const VrOverlay* overlay) -> OverlayEntry*;
+
+    VulkanRenderer* renderer_;
+    VrEventPump* pump_;
+
+    // Guards entries_ and stats_, never held while rendering
+    std::mutex mutex_;
+    std::vector<OverlayEntry> entries_;
+    OverlayManagerStats stats_;
+
+    // Render's work for one frame, only touched by the render thread
+    std::vector<OverlayEntry> removed_;
+    std::vector<OverlaySetup> setups_;
+    std::vector<Vulkan_OverlayDraw> draws_;
+};
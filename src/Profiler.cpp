@@ -0,0 +1,147 @@
+/*
+ * Copyright (C) 2025. Nyabsi <nyabsi@sovellus.cc>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "Profiler.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <fstream>
+
+struct ProfilerThreadBuffer
+{
+    uint32_t thread_id;
+    std::string thread_name;
+    std::atomic<uint64_t> write_index;
+    std::unique_ptr<Profiler::Zone[]> zones;
+};
+
+// Buffers are never freed so a dump can still read the zones of threads that already exited.
+static std::mutex g_profiler_mutex;
+static std::vector<std::unique_ptr<ProfilerThreadBuffer>> g_profiler_buffers;
+static std::string g_profiler_output_path;
+
+static auto GetThreadBuffer() -> ProfilerThreadBuffer*
+{
+    thread_local ProfilerThreadBuffer* buffer = nullptr;
+
+    if (buffer == nullptr) {
+        std::lock_guard<std::mutex> lock(g_profiler_mutex);
+
+        auto new_buffer = std::make_unique<ProfilerThreadBuffer>();
+        new_buffer->thread_id = static_cast<uint32_t>(g_profiler_buffers.size() + 1);
+        new_buffer->thread_name = "Thread " + std::to_string(new_buffer->thread_id);
+        new_buffer->write_index = 0;
+        new_buffer->zones = std::make_unique<Profiler::Zone[]>(Profiler::ZONE_CAPACITY);
+
+        buffer = new_buffer.get();
+        g_profiler_buffers.push_back(std::move(new_buffer));
+    }
+
+    return buffer;
+}
+
+auto Profiler::Record(const char* name, uint64_t begin_ns, uint64_t end_ns) -> void
+{
+    ProfilerThreadBuffer* buffer = GetThreadBuffer();
+
+    const uint64_t index = buffer->write_index.load(std::memory_order_relaxed);
+    buffer->zones[index % ZONE_CAPACITY] = { .name = name, .begin_ns = begin_ns, .end_ns = end_ns };
+    buffer->write_index.store(index + 1, std::memory_order_release);
+}
+
+auto Profiler::SetThreadName(const char* name) -> void
+{
+    ProfilerThreadBuffer* buffer = GetThreadBuffer();
+
+    std::lock_guard<std::mutex> lock(g_profiler_mutex);
+    buffer->thread_name = name;
+}
+
+auto Profiler::SetOutputPath(const std::string& path) -> void
+{
+    std::lock_guard<std::mutex> lock(g_profiler_mutex);
+    g_profiler_output_path = path;
+}
+
+auto Profiler::OutputPath() -> std::string
+{
+    std::lock_guard<std::mutex> lock(g_profiler_mutex);
+    return g_profiler_output_path;
+}
+
+static auto WriteJsonString(std::ostream& stream, const char* value) -> void
+{
+    stream << '"';
+    for (const char* c = value; *c != '\0'; c++) {
+        switch (*c) {
+        case '"': stream << "\\\""; break;
+        case '\\': stream << "\\\\"; break;
+        case '\n': stream << "\\n"; break;
+        default: stream << *c; break;
+        }
+    }
+    stream << '"';
+}
+
+auto Profiler::WriteChromeTrace(const std::string& path) -> bool
+{
+    if (path.empty())
+        return false;
+
+    std::ofstream file(path, std::ios::trunc);
+    if (!file)
+        return false;
+
+    std::lock_guard<std::mutex> lock(g_profiler_mutex);
+
+    uint64_t base_ns = UINT64_MAX;
+    for (const auto& buffer : g_profiler_buffers) {
+        const uint64_t count = std::min<uint64_t>(buffer->write_index.load(std::memory_order_acquire), ZONE_CAPACITY);
+        for (uint64_t i = 0; i < count; i++)
+            base_ns = std::min(base_ns, buffer->zones[i].begin_ns);
+    }
+
+    file << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+
+    bool first = true;
+    char number[64] = {};
+
+    for (const auto& buffer : g_profiler_buffers) {
+        if (!first)
+            file << ",\n";
+        first = false;
+
+        file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->thread_id << ",\"args\":{\"name\":";
+        WriteJsonString(file, buffer->thread_name.c_str());
+        file << "}}";
+
+        // Zones of a thread that is still running may be overwritten while this reads them, the
+        // oldest entries of a full ring are the only ones at risk and they are skipped.
+        const uint64_t end = buffer->write_index.load(std::memory_order_acquire);
+        const uint64_t begin = end > ZONE_CAPACITY ? end - ZONE_CAPACITY + ZONE_CAPACITY / 16 : 0;
+
+        for (uint64_t i = begin; i < end; i++) {
+            const Zone& zone = buffer->zones[i % ZONE_CAPACITY];
+
+            // Chrome trace timestamps are in microseconds, keep the nanoseconds as fraction
+            file << ",\n{\"name\":";
+            WriteJsonString(file, zone.name);
+            snprintf(number, sizeof(number), "%.3f", static_cast<double>(zone.begin_ns > base_ns ? zone.begin_ns - base_ns : 0) / 1000.0);
+            file << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->thread_id << ",\"ts\":" << number;
+            snprintf(number, sizeof(number), "%.3f", static_cast<double>(zone.end_ns - zone.begin_ns) / 1000.0);
+            file << ",\"dur\":" << number << "}";
+        }
+    }
+
+    file << "\n]}\n";
+
+    return static_cast<bool>(file);
+}
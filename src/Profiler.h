@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2025. Nyabsi <nyabsi@sovellus.cc>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <string>
+
+// Scoped CPU zones recorded into a ring buffer per thread and written out as Chrome trace JSON,
+// which both chrome://tracing and ui.perfetto.dev open. Recording a zone is two clock reads and
+// a store into thread local memory, nothing is allocated or locked after a thread's first zone.
+class Profiler {
+public:
+    static constexpr uint32_t ZONE_CAPACITY = 1 << 16;
+
+    struct Zone
+    {
+        const char* name; // must outlive the profiler, string literals only
+        uint64_t begin_ns;
+        uint64_t end_ns;
+    };
+
+    [[nodiscard]] static auto Now() -> uint64_t
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    static auto Record(const char* name, uint64_t begin_ns, uint64_t end_ns) -> void;
+    static auto SetThreadName(const char* name) -> void;
+
+    // Where WriteChromeTrace() without arguments writes to, set once at startup
+    static auto SetOutputPath(const std::string& path) -> void;
+    [[nodiscard]] static auto OutputPath() -> std::string;
+
+    // Writes the zones currently held by every thread's ring buffer, returns false if the file could not be written
+    static auto WriteChromeTrace(const std::string& path) -> bool;
+    static auto WriteChromeTrace() -> bool { return WriteChromeTrace(OutputPath()); }
+};
+
+class ProfileScope {
+public:
+    explicit ProfileScope(const char* name)
+        : name_(name),
+        begin_ns_(Profiler::Now()) {}
+
+    ~ProfileScope()
+    {
+        Profiler::Record(name_, begin_ns_, Profiler::Now());
+    }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    const char* name_;
+    uint64_t begin_ns_;
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+#ifdef ENABLE_PROFILER
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_CONCAT(profile_scope_, __LINE__)(name)
+#define PROFILE_THREAD(name) Profiler::SetThreadName(name)
+#else
+#define PROFILE_SCOPE(name) ((void)0)
+#define PROFILE_THREAD(name) ((void)0)
+#endif
@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2025. Nyabsi <nyabsi@sovellus.cc>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "RenderThread.h"
+
+#include <cassert>
+
+#include "Profiler.h"
+
+RenderThread::RenderThread()
+{
+    render_ = nullptr;
+    frames_submitted_ = 0;
+    frames_rendered_ = 0;
+    frames_replaced_ = 0;
+    input_frames_ = 0;
+    input_latency_total_ns_ = 0;
+    input_latency_max_ns_ = 0;
+}
+
+RenderThread::~RenderThread()
+{
+    this->Stop();
+}
+
+auto RenderThread::Start(RenderFunction render) -> void
+{
+    assert(!thread_.joinable());
+
+    render_ = std::move(render);
+    thread_ = std::thread(&RenderThread::Run, this);
+}
+
+auto RenderThread::Stop() -> void
+{
+    if (!thread_.joinable())
+        return;
+
+    frames_.Close();
+    thread_.join();
+}
+
+auto RenderThread::Submit() -> void
+{
+    frames_submitted_.fetch_add(1, std::memory_order_relaxed);
+
+    if (!frames_.Publish())
+        frames_replaced_.fetch_add(1, std::memory_order_relaxed);
+}
+
+auto RenderThread::Stats() const -> RenderThreadStats
+{
+    return
+    {
+        .frames_submitted = frames_submitted_.load(std::memory_order_relaxed),
+        .frames_rendered = frames_rendered_.load(std::memory_order_relaxed),
+        .frames_replaced = frames_replaced_.load(std::memory_order_relaxed),
+        .input_frames = input_frames_.load(std::memory_order_relaxed),
+        .input_latency_total_ns = input_latency_total_ns_.load(std::memory_order_relaxed),
+        .input_latency_max_ns = input_latency_max_ns_.load(std::memory_order_relaxed),
+    };
+}
+
+auto RenderThread::Run() -> void
+{
+    PROFILE_THREAD("Render");
+
+    while (frames_.Wait()) {
+        if (!frames_.Acquire())
+            continue;
+
+        PROFILE_SCOPE("Render frame");
+
+        RenderFrame& frame = frames_.Front();
+        render_(frame);
+        frames_rendered_.fetch_add(1, std::memory_order_relaxed);
+
+        if (frame.input_timestamp_ns != 0) {
+            const uint64_t now_ns = Profiler::Now();
+            const uint64_t latency_ns = now_ns > frame.input_timestamp_ns ? now_ns - frame.input_timestamp_ns : 0;
+
+            // Only this thread writes them
+            input_frames_.fetch_add(1, std::memory_order_relaxed);
+            input_latency_total_ns_.fetch_add(latency_ns, std::memory_order_relaxed);
+            if (latency_ns > input_latency_max_ns_.load(std::memory_order_relaxed))
+                input_latency_max_ns_.store(latency_ns, std::memory_order_relaxed);
+        }
+    }
+}
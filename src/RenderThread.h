@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2025. Nyabsi <nyabsi@sovellus.cc>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <thread>
+
+#include "DrawDataSnapshot.h"
+#include "TripleBuffer.h"
+
+// Everything the render thread needs to put a frame on screen, filled by the UI thread
+struct RenderFrame
+{
+    DrawDataSnapshot draw_data;
+    uint64_t texture_generation = 0;    // bumped by the UI thread whenever the renderer backend changed a texture
+    int framebuffer_width = 0;
+    int framebuffer_height = 0;
+    bool window_minimized = false;
+    uint64_t input_timestamp_ns = 0;    // when the oldest input this frame reacts to was polled, 0 without input
+};
+
+struct RenderThreadStats
+{
+    uint64_t frames_submitted;
+    uint64_t frames_rendered;
+    uint64_t frames_replaced;   // submitted but replaced by a newer frame before the render thread picked it up
+    uint64_t input_frames;      // rendered frames that carried input
+    uint64_t input_latency_total_ns;    // from the input being polled to the frame being submitted to the compositor
+    uint64_t input_latency_max_ns;
+};
+
+// Records and submits frames on a thread of its own while the UI thread builds the next one. Frames are handed
+// over through a TripleBuffer, the UI thread never waits for rendering and the render thread always picks up the
+// newest frame. The render function is the only place touching the swapchain, the overlay textures and the queue
+// on behalf of the UI, anything else that submits has to hold VulkanRenderer::QueueMutex().
+class RenderThread {
+public:
+    using RenderFunction = std::function<void(RenderFrame& frame)>;
+
+    explicit RenderThread();
+    ~RenderThread();
+
+    RenderThread(const RenderThread&) = delete;
+    RenderThread& operator=(const RenderThread&) = delete;
+
+    auto Start(RenderFunction render) -> void;
+    // Returns once the frame being rendered is done, a frame still waiting is dropped
+    auto Stop() -> void;
+
+    // UI thread side, the frame to fill before calling Submit()
+    [[nodiscard]] auto NextFrame() -> RenderFrame& { return frames_.Back(); }
+    auto Submit() -> void;
+
+    [[nodiscard]] auto Stats() const -> RenderThreadStats;
+
+private:
+    auto Run() -> void;
+
+    std::thread thread_;
+    RenderFunction render_;
+    TripleBuffer<RenderFrame> frames_;
+    std::atomic<uint64_t> frames_submitted_;
+    std::atomic<uint64_t> frames_rendered_;
+    std::atomic<uint64_t> frames_replaced_;
+    std::atomic<uint64_t> input_frames_;
+    std::atomic<uint64_t> input_latency_total_ns_;
+    std::atomic<uint64_t> input_latency_max_ns_;
+};
@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2025. Nyabsi <nyabsi@sovellus.cc>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+// Lock free single producer, single consumer slot where the latest value wins. The producer fills Back()
+// and publishes it, the consumer takes the most recently published value into Front(). Neither side ever
+// waits for the other, a value published before the consumer got to the previous one replaces it.
+template <typename T>
+class TripleBuffer {
+public:
+    explicit TripleBuffer()
+    {
+        back_ = 0;
+        front_ = 1;
+        middle_ = 2;
+        closed_ = false;
+    }
+
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+    // Producer side
+    [[nodiscard]] auto Back() -> T& { return buffers_[back_]; }
+    // Returns false if the previously published value was replaced before the consumer took it
+    auto Publish() -> bool
+    {
+        const uint32_t previous = middle_.exchange(back_ | FRESH_BIT, std::memory_order_acq_rel);
+        back_ = previous & INDEX_MASK;
+        middle_.notify_one();
+        return (previous & FRESH_BIT) == 0;
+    }
+
+    // Consumer side
+    [[nodiscard]] auto Front() -> T& { return buffers_[front_]; }
+    // Swaps the latest published value into Front(), returns false if nothing new was published
+    auto Acquire() -> bool
+    {
+        if ((middle_.load(std::memory_order_acquire) & FRESH_BIT) == 0)
+            return false;
+
+        const uint32_t previous = middle_.exchange(front_, std::memory_order_acq_rel);
+        front_ = previous & INDEX_MASK;
+        return true;
+    }
+    // Blocks until a value was published or Close() was called, returns false once closed
+    auto Wait() -> bool
+    {
+        uint32_t middle = middle_.load(std::memory_order_acquire);
+        while ((middle & FRESH_BIT) == 0 && !closed_.load(std::memory_order_acquire)) {
+            middle_.wait(middle, std::memory_order_acquire);
+            middle = middle_.load(std::memory_order_acquire);
+        }
+        return !closed_.load(std::memory_order_acquire);
+    }
+
+    // Wakes the consumer for good, called from either side
+    auto Close() -> void
+    {
+        closed_.store(true, std::memory_order_release);
+        // Any change of the value wakes a waiting consumer, the bit itself means nothing
+        middle_.fetch_xor(WAKE_BIT, std::memory_order_acq_rel);
+        middle_.notify_all();
+    }
+
+private:
+    static constexpr uint32_t INDEX_MASK = 0x3;
+    static constexpr uint32_t FRESH_BIT = 0x4;
+    static constexpr uint32_t WAKE_BIT = 0x8;
+
+    std::array<T, 3> buffers_;
+    uint32_t back_;                 // owned by the producer
+    uint32_t front_;                // owned by the consumer
+    std::atomic<uint32_t> middle_;  // index of the buffer in between, with FRESH_BIT once published
+    std::atomic<bool> closed_;
+};
@@ -0,0 +1,251 @@
+/*
+ * Copyright (C) 2025. Nyabsi <nyabsi@sovellus.cc>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "VrEventPump.h"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+
+#include "Profiler.h"
+
+VrEventPump::VrEventPump()
+{
+    wake_ = nullptr;
+    handles_.clear();
+    poll_interval_us_ = DEFAULT_POLL_INTERVAL_US;
+    overlay_poll_interval_us_ = DEFAULT_POLL_INTERVAL_US;
+    system_events_ = false;
+    handles_changed_ = false;
+    interval_changed_ = false;
+    stopping_ = false;
+    polls_ = 0;
+    overlay_polls_ = 0;
+    events_polled_ = 0;
+    queue_full_ = 0;
+    wake_pending_ = false;
+    events_drained_ = 0;
+    latency_total_ns_ = 0;
+    latency_max_ns_ = 0;
+}
+
+VrEventPump::~VrEventPump()
+{
+    this->Stop();
+}
+
+auto VrEventPump::AddOverlay(vr::VROverlayHandle_t handle) -> void
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (std::find(handles_.begin(), handles_.end(), handle) != handles_.end())
+        return;
+
+    handles_.push_back(handle);
+    handles_changed_ = true;
+}
+
+auto VrEventPump::RemoveOverlay(vr::VROverlayHandle_t handle) -> void
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    handles_.erase(std::remove(handles_.begin(), handles_.end(), handle), handles_.end());
+    handles_changed_ = true;
+}
+
+auto VrEventPump::SetSystemEvents(bool enabled) -> void
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    system_events_ = enabled;
+}
+
+auto VrEventPump::Start(WakeFunction wake) -> void
+{
+    assert(!thread_.joinable());
+
+    wake_ = std::move(wake);
+    stopping_ = false;
+    thread_ = std::thread(&VrEventPump::Run, this);
+}
+
+auto VrEventPump::Stop() -> void
+{
+    if (!thread_.joinable())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    poll_condition_.notify_all();
+    thread_.join();
+}
+
+auto VrEventPump::SetPollInterval(uint32_t interval_us) -> void
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (poll_interval_us_ == interval_us && overlay_poll_interval_us_ == interval_us)
+            return;
+
+        poll_interval_us_ = interval_us;
+        overlay_poll_interval_us_ = interval_us;
+        interval_changed_ = true;
+    }
+    poll_condition_.notify_all();
+}
+
+auto VrEventPump::SetOverlayPollInterval(uint32_t interval_us) -> void
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (overlay_poll_interval_us_ == interval_us)
+            return;
+
+        overlay_poll_interval_us_ = interval_us;
+        interval_changed_ = true;
+    }
+    poll_condition_.notify_all();
+}
+
+auto VrEventPump::Pop(VrInputEvent& event) -> bool
+{
+    if (!queue_.Pop(event)) {
+        // Drained, the next event has to wake the consumer again. An event pushed just before the flag
+        // was cleared would not have woken anyone, so look once more.
+        wake_pending_.store(false);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        if (!queue_.Pop(event))
+            return false;
+    }
+
+    const uint64_t now_ns = Profiler::Now();
+    const uint64_t latency_ns = now_ns > event.timestamp_ns ? now_ns - event.timestamp_ns : 0;
+
+    events_drained_++;
+    latency_total_ns_ += latency_ns;
+    latency_max_ns_ = std::max(latency_max_ns_, latency_ns);
+    return true;
+}
+
+auto VrEventPump::WaitForEvents(uint32_t timeout_ms) -> bool
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    return event_condition_.wait_for(lock, std::chrono::milliseconds(timeout_ms), [&] { return !queue_.Empty(); });
+}
+
+auto VrEventPump::Stats() const -> VrEventPumpStats
+{
+    return
+    {
+        .polls = polls_.load(std::memory_order_relaxed),
+        .overlay_polls = overlay_polls_.load(std::memory_order_relaxed),
+        .events_polled = events_polled_.load(std::memory_order_relaxed),
+        .queue_full = queue_full_.load(std::memory_order_relaxed),
+        .events_drained = events_drained_,
+        .latency_total_ns = latency_total_ns_,
+        .latency_max_ns = latency_max_ns_,
+    };
+}
+
+auto VrEventPump::Run() -> void
+{
+    PROFILE_THREAD("VR events");
+
+    std::vector<vr::VROverlayHandle_t> handles = {};
+    uint32_t poll_interval_us = DEFAULT_POLL_INTERVAL_US;
+    uint32_t overlay_poll_interval_us = DEFAULT_POLL_INTERVAL_US;
+    uint64_t overlay_poll_ns = 0;   // Profiler::Now() of the last pass over the overlays
+    bool system_events = false;
+    VrInputEvent input = {};
+    // Polled but not queued yet because the queue was full, it goes in before anything else is polled
+    VrInputEvent held = {};
+    bool holding = false;
+
+    for (;;) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (stopping_)
+                break;
+
+            if (handles_changed_) {
+                handles = handles_;
+                handles_changed_ = false;
+            }
+            poll_interval_us = poll_interval_us_;
+            overlay_poll_interval_us = std::max(overlay_poll_interval_us_, poll_interval_us_);
+            system_events = system_events_;
+            interval_changed_ = false;
+        }
+
+        bool pushed = false;
+        // Returns false once the queue is full, the event is held back and nothing more is polled this time
+        const auto enqueue = [&](vr::VROverlayHandle_t handle) -> bool {
+            input.handle = handle;
+            input.timestamp_ns = Profiler::Now();
+            events_polled_.fetch_add(1, std::memory_order_relaxed);
+
+            if (queue_.Push(input)) {
+                pushed = true;
+                return true;
+            }
+
+            held = input;
+            holding = true;
+            queue_full_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        };
+
+        if (holding && queue_.Push(held)) {
+            holding = false;
+            pushed = true;
+        }
+
+        // Without the system queue every pass is over the overlays. Otherwise they are due once their interval
+        // passed or would pass before the next poll.
+        const uint64_t now_ns = Profiler::Now();
+        const bool poll_overlays = !system_events || now_ns + poll_interval_us * 1000ull >= overlay_poll_ns + overlay_poll_interval_us * 1000ull;
+
+        if (!holding) {
+            PROFILE_SCOPE("Poll overlays");
+
+            bool full = false;
+            if (poll_overlays) {
+                overlay_poll_ns = now_ns;
+                overlay_polls_.fetch_add(1, std::memory_order_relaxed);
+
+                for (vr::VROverlayHandle_t handle : handles) {
+                    while (!full && vr::VROverlay()->PollNextOverlayEvent(handle, &input.event, sizeof(input.event)))
+                        full = !enqueue(handle);
+                }
+            }
+
+            if (system_events) {
+                while (!full && vr::VRSystem()->PollNextEvent(&input.event, sizeof(input.event)))
+                    full = !enqueue(vr::k_ulOverlayHandleInvalid);
+            }
+        }
+        polls_.fetch_add(1, std::memory_order_relaxed);
+
+        if (pushed) {
+            // Taking the lock orders the push before a WaitForEvents that is about to check the queue
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+            }
+            event_condition_.notify_all();
+
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (wake_ && !wake_pending_.exchange(true))
+                wake_();
+        }
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        poll_condition_.wait_for(lock, std::chrono::microseconds(system_events ? poll_interval_us : overlay_poll_interval_us), [&] { return stopping_ || interval_changed_; });
+    }
+}
@@ -0,0 +1,119 @@
+/*
+ * Copyright (C) 2025. Nyabsi <nyabsi@sovellus.cc>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <openvr.h>
+
+#include "MpscQueue.h"
+
+struct VrInputEvent
+{
+    vr::VROverlayHandle_t handle;   // overlay the event was polled from, k_ulOverlayHandleInvalid for system events
+    uint64_t timestamp_ns;          // Profiler::Now() when it was polled
+    vr::VREvent_t event;
+};
+
+struct VrEventPumpStats
+{
+    uint64_t polls;             // passes over the system queue
+    uint64_t overlay_polls;     // passes over the registered overlays, fewer than polls while the overlay interval is longer
+    uint64_t events_polled;
+    uint64_t queue_full;        // polls cut short by a full queue, the rest of the events waited in OpenVR
+    uint64_t events_drained;
+    uint64_t latency_total_ns;  // from being polled to being drained, summed over every drained event
+    uint64_t latency_max_ns;
+};
+
+// Polls the overlay events of every registered overlay on a thread of its own so input does not wait for the
+// main loop to come around. Each event is timestamped when polled and queued through a lock free MPSC queue,
+// the main loop drains it right before building the next frame. OpenVR events cannot be waited on, so the pump
+// polls the system queue every poll interval and the overlay queues every overlay poll interval: both often while the
+// UI is on screen, and the overlays as slowly as the idle scheduler allows otherwise. The system queue keeps its pace
+// so dashboard activation still wakes an idle loop within a frame.
+// Events are never dropped, while the queue is full polling stops and they stay queued in OpenVR.
+class VrEventPump {
+public:
+    static constexpr size_t QUEUE_CAPACITY = 1024;
+    // Every poll is one IPC round trip per registered overlay plus one for the system queue
+    static constexpr uint32_t DEFAULT_POLL_INTERVAL_US = 4000;
+
+    // Twice per HMD frame, 5.5 ms at 90 Hz. An event waits up to that long in OpenVR before it is queued, half of
+    // it on average, on top of the wait for the main loop to drain the queue once per frame.
+    [[nodiscard]] static constexpr auto PollIntervalUs(float refresh_rate) -> uint32_t
+    {
+        return refresh_rate > 0.0f ? static_cast<uint32_t>(500000.0f / refresh_rate) : DEFAULT_POLL_INTERVAL_US;
+    }
+
+    // Called on the pump thread when events arrive in an empty queue, the consumer may be asleep waiting for them
+    using WakeFunction = std::function<void()>;
+
+    explicit VrEventPump();
+    ~VrEventPump();
+
+    VrEventPump(const VrEventPump&) = delete;
+    VrEventPump& operator=(const VrEventPump&) = delete;
+
+    auto AddOverlay(vr::VROverlayHandle_t handle) -> void;
+    auto RemoveOverlay(vr::VROverlayHandle_t handle) -> void;
+    // Also poll IVRSystem events, device activation and property changes only show up there
+    auto SetSystemEvents(bool enabled) -> void;
+
+    auto Start(WakeFunction wake = nullptr) -> void;
+    // Events still queued stay there until drained
+    auto Stop() -> void;
+
+    // Takes effect immediately, a pump sleeping on a longer interval is woken up. Sets the overlay poll interval
+    // to the same value.
+    auto SetPollInterval(uint32_t interval_us) -> void;
+    // Overlay queues are polled this often until the next SetPollInterval, never more often than the system queue
+    auto SetOverlayPollInterval(uint32_t interval_us) -> void;
+
+    // Consumer side, a single thread
+    auto Pop(VrInputEvent& event) -> bool;
+    // Blocks until an event is queued or timeout_ms passed, returns false on timeout
+    auto WaitForEvents(uint32_t timeout_ms) -> bool;
+    // Consumer side as well, the latency figures are tracked by Pop
+    [[nodiscard]] auto Stats() const -> VrEventPumpStats;
+
+private:
+    auto Run() -> void;
+
+    std::thread thread_;
+    WakeFunction wake_;
+
+    // Guards everything the main loop hands to the pump thread, never held while polling
+    std::mutex mutex_;
+    std::condition_variable poll_condition_;
+    std::condition_variable event_condition_;
+    std::vector<vr::VROverlayHandle_t> handles_;
+    uint32_t poll_interval_us_;
+    uint32_t overlay_poll_interval_us_;
+    bool system_events_;
+    bool handles_changed_;
+    bool interval_changed_;
+    bool stopping_;
+
+    MpscQueue<VrInputEvent, QUEUE_CAPACITY> queue_;
+    std::atomic<uint64_t> polls_;
+    std::atomic<uint64_t> overlay_polls_;
+    std::atomic<uint64_t> events_polled_;
+    std::atomic<uint64_t> queue_full_;
+    std::atomic<bool> wake_pending_;    // the consumer was woken and has not drained the queue since
+    uint64_t events_drained_;
+    uint64_t latency_total_ns_;
+    uint64_t latency_max_ns_;
+};
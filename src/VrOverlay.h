@@ -10,8 +10,12 @@
 
 #define GLM_ENABLE_EXPERIMENTAL
 
-#include <stdexcept>
+#include <atomic>
+#include <cstring>
 #include <format>
+#include <map>
+#include <optional>
+#include <stdexcept>
 
 #include <openvr.h>
 
@@ -19,6 +23,8 @@
 #include <glm/gtx/quaternion.hpp>
 #include <glm/gtx/euler_angles.hpp>
 
+#include "VrPoseService.h"
+
 namespace vr {
     enum VROverlayType {
         VROverlayType_None = 0,
@@ -28,17 +34,38 @@ namespace vr {
     };
 }
 
+struct VrOverlayStats
+{
+    uint64_t ipc_calls;         // calls into the runtime made for this overlay, each one a round trip to vrserver
+    uint64_t ipc_calls_skipped; // setters and queries answered from the shadow state instead
+};
+
+// Every call on an overlay is a round trip to vrserver. VrOverlay keeps a shadow copy of what it has set, setters
+// return without a call when the value is already in place and queries are answered from the copy. Visibility is
+// the one thing the runtime changes by itself, it is tracked through ProcessEvent.
+//
+// IsVisible and SetTexture are called from the render thread, everything else belongs to the main thread.
 class VrOverlay {
 public:
     explicit VrOverlay()
         : handle(vr::k_ulOverlayHandleInvalid),
         thumbnail_handle(vr::k_ulOverlayHandleInvalid),
-        type_(vr::VROverlayType_None) {}
+        type_(vr::VROverlayType_None),
+        transform_type_(TransformType_None),
+        transform_target_(0),
+        transform_({}),
+        visible_(false),
+        ipc_calls_(0),
+        ipc_calls_skipped_(0) {}
+
+    VrOverlay(const VrOverlay&) = delete;
+    VrOverlay& operator=(const VrOverlay&) = delete;
 
     [[nodiscard]] auto Handle() const -> vr::VROverlayHandle_t { return handle; }
 
     [[maybe_unused]] auto Create(vr::VROverlayType type, const char* key, const char* name) -> void {
         type_ = type;
+        this->CountCall();
         if (type == vr::VROverlayType_World) {
             vr::EVROverlayError result = vr::VROverlay()->CreateOverlay(key, name, &handle);
             if (result > vr::VROverlayError_None)
@@ -60,6 +87,7 @@ public:
 
     [[maybe_unused]] auto SetThumbnail(const std::string& path) const -> void {
         if (type_ == vr::VROverlayType_Dashboard) {
+            this->CountCall();
             vr::EVROverlayError result = vr::VROverlay()->SetOverlayFromFile(thumbnail_handle, path.data());
             if (result > vr::VROverlayError_None)
                 throw std::runtime_error(
@@ -70,123 +98,267 @@ public:
         throw std::runtime_error(std::format("You should only call SetThumbnail when the overlay type is VROverlayType_Dashboard"));
     }
 
-    [[maybe_unused]] auto SetInputMethod(vr::VROverlayInputMethod method) const -> void {
+    [[maybe_unused]] auto SetInputMethod(vr::VROverlayInputMethod method) -> void {
+        if (input_method_ == method) {
+            this->CountSkipped();
+            return;
+        }
+
+        this->CountCall();
         vr::EVROverlayError result = vr::VROverlay()->SetOverlayInputMethod(handle, method);
         if (result > vr::VROverlayError_None)
             throw std::runtime_error(
                 std::format("Failed to set overlay input method \"{}\": {}", static_cast<int>(method), static_cast<int>(result))
             );
+        input_method_ = method;
     }
 
-    [[maybe_unused]] auto FlagEnabled(vr::VROverlayFlags flag) const -> bool {
+    [[maybe_unused]] auto FlagEnabled(vr::VROverlayFlags flag) -> bool {
+        if (auto it = flags_.find(flag); it != flags_.end()) {
+            this->CountSkipped();
+            return it->second;
+        }
+
+        this->CountCall();
         bool enabled = {};
         vr::EVROverlayError result = vr::VROverlay()->GetOverlayFlag(handle, flag, &enabled);
         if (result > vr::VROverlayError_None)
             throw std::runtime_error(
                 std::format("Failed to check if overlay flag is enabled \"{}\": {}", static_cast<int>(flag), static_cast<int>(result))
             );
+        flags_[flag] = enabled;
         return enabled;
     }
 
-    [[maybe_unused]] auto EnableFlag(vr::VROverlayFlags flag) const -> void {
+    [[maybe_unused]] auto EnableFlag(vr::VROverlayFlags flag) -> void {
+        if (auto it = flags_.find(flag); it != flags_.end() && it->second) {
+            this->CountSkipped();
+            return;
+        }
+
+        this->CountCall();
         vr::EVROverlayError result = vr::VROverlay()->SetOverlayFlag(handle, flag, true);
         if (result > vr::VROverlayError_None)
             throw std::runtime_error(
                 std::format("Failed to enable overlay flag \"{}\": {}", static_cast<int>(flag), static_cast<int>(result))
             );
+        flags_[flag] = true;
     }
 
-    [[maybe_unused]] auto DisableFlag(vr::VROverlayFlags flag) const -> void {
+    [[maybe_unused]] auto DisableFlag(vr::VROverlayFlags flag) -> void {
+        if (auto it = flags_.find(flag); it != flags_.end() && !it->second) {
+            this->CountSkipped();
+            return;
+        }
+
+        this->CountCall();
         vr::EVROverlayError result = vr::VROverlay()->SetOverlayFlag(handle, flag, false);
         if (result > vr::VROverlayError_None)
             throw std::runtime_error(
                 std::format("Failed to disable overlay flag \"{}\": {}", static_cast<int>(flag), static_cast<int>(result))
             );
+        flags_[flag] = false;
     }
 
-    [[maybe_unused]] auto SetWidth(float width) const -> void {
+    [[maybe_unused]] auto SetWidth(float width) -> void {
+        if (width_ == width) {
+            this->CountSkipped();
+            return;
+        }
+
+        this->CountCall();
         vr::EVROverlayError result = vr::VROverlay()->SetOverlayWidthInMeters(handle, width);
         if (result > vr::VROverlayError_None)
             throw std::runtime_error(std::format("Failed to set overlay width \"{}\": {}", width, static_cast<int>(result)));
+        width_ = width;
     }
 
+    // Never skipped, every call hands the compositor a new frame
     [[maybe_unused]] auto SetTexture(const vr::Texture_t& texture) const -> void {
+        this->CountCall();
         vr::EVROverlayError result = vr::VROverlay()->SetOverlayTexture(handle, &texture);
         if (result > vr::VROverlayError_None)
             throw std::runtime_error(std::format("Failed to set texture {}", static_cast<int>(result)));
     }
 
-    [[maybe_unused]] auto SetMouseScale(float x, float y) const -> void {
+    [[maybe_unused]] auto SetMouseScale(float x, float y) -> void {
+        if (mouse_scale_ && mouse_scale_->v[0] == x && mouse_scale_->v[1] == y) {
+            this->CountSkipped();
+            return;
+        }
+
+        this->CountCall();
         vr::HmdVector2_t scale = {x, y};
         vr::EVROverlayError result = vr::VROverlay()->SetOverlayMouseScale(handle, &scale);
         if (result > vr::VROverlayError_None)
             throw std::runtime_error(std::format("Failed to set mouse scale ({}, {}) {}", x, y, static_cast<int>(result)));
+        mouse_scale_ = scale;
     }
 
     [[maybe_unused]] auto ShowKeyboard(vr::EGamepadTextInputMode mode, bool multi_line = false) -> void {
+        this->CountCall();
         vr::EVROverlayError result = vr::VROverlay()->ShowKeyboardForOverlay(handle, mode, multi_line ? vr::k_EGamepadTextInputLineModeMultipleLines : vr::k_EGamepadTextInputLineModeSingleLine, vr::KeyboardFlag_Minimal | vr::KeyboardFlag_HideDoneKey, "OpenVR Overlay Provided Virtual Keyboard", 1, "", 0);
         if (result > vr::VROverlayError_None)
             throw std::runtime_error(std::format("Failed to show keyboard {}", static_cast<int>(result)));
     }
 
-    [[maybe_unused]] auto SetTransformWorldRelative(vr::ETrackingUniverseOrigin origin, const glm::vec3& position, const glm::quat& rotation) const -> void {
-        glm::mat4 transform = glm::translate(glm::mat4(1.0f), position) * glm::toMat4(rotation);
-        
-        vr::HmdMatrix34_t m = {};
-        for (int row = 0; row < 3; ++row) {
-            for (int col = 0; col < 3; ++col) {
-                m.m[row][col] = transform[col][row];
-            }
-            m.m[row][3] = transform[3][row];
+    [[maybe_unused]] auto SetTransformWorldRelative(vr::ETrackingUniverseOrigin origin, const glm::vec3& position, const glm::quat& rotation) -> void {
+        const vr::HmdMatrix34_t m = ToHmdMatrix34(position, rotation);
+
+        if (this->TransformUnchanged(TransformType_WorldRelative, static_cast<uint32_t>(origin), m)) {
+            this->CountSkipped();
+            return;
         }
 
+        this->CountCall();
         vr::VROverlay()->SetOverlayTransformAbsolute(handle, origin, &m);
+        this->StoreTransform(TransformType_WorldRelative, static_cast<uint32_t>(origin), m);
     }
 
-    [[maybe_unused]] auto SetTransformDeviceRelative(vr::ETrackedControllerRole role, const glm::vec3& position, const glm::quat& rotation) const -> void {
-        glm::mat4 transform = glm::translate(glm::mat4(1.0f), position) * glm::toMat4(rotation);
+    // The role is resolved through VrPoseService, which looks it up again only after devices came and went
+    [[maybe_unused]] auto SetTransformDeviceRelative(vr::ETrackedControllerRole role, const glm::vec3& position, const glm::quat& rotation) -> void {
+        this->SetTransformDeviceRelative(VrPoseService::DeviceForRole(role), position, rotation);
+    }
 
-        vr::HmdMatrix34_t m = {};
-        for (int row = 0; row < 3; ++row) {
-            for (int col = 0; col < 3; ++col) {
-                m.m[row][col] = transform[col][row];
-            }
-            m.m[row][3] = transform[3][row];
+    [[maybe_unused]] auto SetTransformDeviceRelative(vr::TrackedDeviceIndex_t device, const glm::vec3& position, const glm::quat& rotation) -> void {
+        const vr::HmdMatrix34_t m = ToHmdMatrix34(position, rotation);
+
+        if (this->TransformUnchanged(TransformType_DeviceRelative, device, m)) {
+            this->CountSkipped();
+            return;
         }
 
-        vr::VROverlay()->SetOverlayTransformTrackedDeviceRelative(handle, vr::VRSystem()->GetTrackedDeviceIndexForControllerRole(role), &m);
+        this->CountCall();
+        vr::VROverlay()->SetOverlayTransformTrackedDeviceRelative(handle, device, &m);
+        this->StoreTransform(TransformType_DeviceRelative, device, m);
     }
 
     // TODO: SetOverlayTransformTrackedDeviceComponent if needed
 
     [[maybe_unused]] auto TriggerLaserMouseHapticVibration(float duration, float frequency, float amplitude) const -> void {
+        this->CountCall();
         vr::EVROverlayError result = vr::VROverlay()->TriggerLaserMouseHapticVibration(handle, duration, frequency, amplitude);
         if (result > vr::VROverlayError_None)
             throw std::runtime_error(std::format("Failed to show keyboard {}", static_cast<int>(result)));
     }
 
     [[maybe_unused]] auto HideKeyboard() -> void {
+        this->CountCall();
         vr::VROverlay()->HideKeyboard();
     }
 
+    // From the shadow state, kept up to date by Show, Hide and the events passed to ProcessEvent. Not counted as
+    // a skipped call, the render thread reads it every frame where no runtime query was made before.
     [[maybe_unused]] auto IsVisible() const -> bool {
-        return vr::VROverlay()->IsOverlayVisible(handle);
+        return visible_.load(std::memory_order_acquire);
+    }
+
+    // Asks the runtime, for when the events of this overlay are not passed to ProcessEvent
+    [[maybe_unused]] auto QueryVisible() -> bool {
+        this->CountCall();
+        const bool visible = vr::VROverlay()->IsOverlayVisible(handle);
+        visible_.store(visible, std::memory_order_release);
+        return visible;
     }
 
-    [[maybe_unused]] auto Show() const -> void {
+    [[maybe_unused]] auto Show() -> void {
+        if (visible_.load(std::memory_order_acquire)) {
+            this->CountSkipped();
+            return;
+        }
+
+        this->CountCall();
         vr::VROverlay()->ShowOverlay(handle);
+        visible_.store(true, std::memory_order_release);
     }
 
-    [[maybe_unused]] auto Hide() const -> void {
+    [[maybe_unused]] auto Hide() -> void {
+        if (!visible_.load(std::memory_order_acquire)) {
+            this->CountSkipped();
+            return;
+        }
+
+        this->CountCall();
         vr::VROverlay()->HideOverlay(handle);
+        visible_.store(false, std::memory_order_release);
     }
 
-    [[maybe_unused]] auto Destroy() const -> void {
+    [[maybe_unused]] auto Destroy() -> void {
+        this->CountCall();
         vr::VROverlay()->DestroyOverlay(handle);
+
+        width_.reset();
+        mouse_scale_.reset();
+        input_method_.reset();
+        flags_.clear();
+        transform_type_ = TransformType_None;
+        visible_.store(false, std::memory_order_release);
+    }
+
+    // Feed every event polled for this overlay through here, the visibility is tracked from them
+    [[maybe_unused]] auto ProcessEvent(const vr::VREvent_t& event) -> void {
+        if (event.eventType == vr::VREvent_OverlayShown)
+            visible_.store(true, std::memory_order_release);
+        if (event.eventType == vr::VREvent_OverlayHidden)
+            visible_.store(false, std::memory_order_release);
+    }
+
+    [[nodiscard]] auto Stats() const -> VrOverlayStats {
+        return {
+            .ipc_calls = ipc_calls_.load(std::memory_order_relaxed),
+            .ipc_calls_skipped = ipc_calls_skipped_.load(std::memory_order_relaxed),
+        };
     }
 
 private:
+    enum TransformType
+    {
+        TransformType_None = 0,
+        TransformType_WorldRelative,    // target is the tracking universe origin
+        TransformType_DeviceRelative,   // target is the tracked device index
+    };
+
+    // Rotation straight from the quaternion and the translation as the last column, no 4x4 product
+    static auto ToHmdMatrix34(const glm::vec3& position, const glm::quat& rotation) -> vr::HmdMatrix34_t {
+        const glm::mat3 r = glm::mat3_cast(rotation);
+
+        vr::HmdMatrix34_t m = {};
+        for (int row = 0; row < 3; ++row) {
+            for (int col = 0; col < 3; ++col) {
+                m.m[row][col] = r[col][row];
+            }
+            m.m[row][3] = position[row];
+        }
+        return m;
+    }
+
+    auto TransformUnchanged(TransformType type, uint32_t target, const vr::HmdMatrix34_t& m) const -> bool {
+        return transform_type_ == type && transform_target_ == target && memcmp(&transform_, &m, sizeof(m)) == 0;
+    }
+
+    auto StoreTransform(TransformType type, uint32_t target, const vr::HmdMatrix34_t& m) -> void {
+        transform_type_ = type;
+        transform_target_ = target;
+        transform_ = m;
+    }
+
+    auto CountCall() const -> void { ipc_calls_.fetch_add(1, std::memory_order_relaxed); }
+    auto CountSkipped() const -> void { ipc_calls_skipped_.fetch_add(1, std::memory_order_relaxed); }
+
     vr::VROverlayHandle_t handle;
     vr::VROverlayHandle_t thumbnail_handle;
     vr::VROverlayType type_;
+
+    // Shadow state, what was last set through this object
+    std::optional<float> width_;
+    std::optional<vr::HmdVector2_t> mouse_scale_;
+    std::optional<vr::VROverlayInputMethod> input_method_;
+    std::map<vr::VROverlayFlags, bool> flags_;
+    TransformType transform_type_;
+    uint32_t transform_target_;
+    vr::HmdMatrix34_t transform_;
+    std::atomic<bool> visible_;
+
+    mutable std::atomic<uint64_t> ipc_calls_;
+    mutable std::atomic<uint64_t> ipc_calls_skipped_;
 };
\ No newline at end of file
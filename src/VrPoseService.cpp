@@ -0,0 +1,258 @@
+/*
+ * Copyright (C) 2025. Nyabsi <nyabsi@sovellus.cc>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "VrPoseService.h"
+
+#include <algorithm>
+#include <array>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include "FramePacer.h"
+#include "Profiler.h"
+#include "VrPropertyCache.h"
+
+static_assert((VrPoseService::HISTORY_SIZE & (VrPoseService::HISTORY_SIZE - 1)) == 0, "HISTORY_SIZE must be a power of two");
+static_assert(vr::k_unMaxTrackedDeviceCount <= 64, "the valid mask holds one bit per device");
+
+// One row per sampled frame, one column per device
+struct VrPoseHistory
+{
+    std::array<std::array<vr::HmdMatrix34_t, vr::k_unMaxTrackedDeviceCount>, VrPoseService::HISTORY_SIZE> device_to_absolute;
+    std::array<std::array<vr::HmdVector3_t, vr::k_unMaxTrackedDeviceCount>, VrPoseService::HISTORY_SIZE> velocity;
+    std::array<std::array<vr::HmdVector3_t, vr::k_unMaxTrackedDeviceCount>, VrPoseService::HISTORY_SIZE> angular_velocity;
+    std::array<uint64_t, VrPoseService::HISTORY_SIZE> valid;    // bit per device
+    std::array<uint64_t, VrPoseService::HISTORY_SIZE> sample_ns;
+    std::array<float, VrPoseService::HISTORY_SIZE> predicted_seconds;
+};
+
+struct VrPoseServiceState
+{
+    VrPoseServiceState()
+    {
+        history = {};
+        frame = 0;
+        samples = 0;
+        sampled_frame = UINT64_MAX;
+        pacer = nullptr;
+        origin = vr::TrackingUniverseStanding;
+        roles.fill(vr::k_unTrackedDeviceIndexInvalid);
+        roles_dirty = true;
+        stats = {};
+    }
+
+    VrPoseHistory history;
+    uint64_t frame;
+    uint64_t samples;
+    uint64_t sampled_frame;     // frame the latest sample was taken in
+    const FramePacer* pacer;
+    vr::ETrackingUniverseOrigin origin;
+    std::array<vr::TrackedDeviceIndex_t, vr::TrackedControllerRole_Max + 1> roles;
+    bool roles_dirty;
+    VrPoseServiceStats stats;
+};
+
+static auto State() -> VrPoseServiceState&
+{
+    static VrPoseServiceState state;
+    return state;
+}
+
+auto VrPoseService::SetTrackingOrigin(vr::ETrackingUniverseOrigin origin) -> void
+{
+    State().origin = origin;
+}
+
+auto VrPoseService::SetFramePacer(const FramePacer* pacer) -> void
+{
+    State().pacer = pacer;
+}
+
+auto VrPoseService::BeginFrame() -> void
+{
+    VrPoseServiceState& state = State();
+    state.frame++;
+    state.stats.frames++;
+}
+
+static auto Sample(VrPoseServiceState& state) -> void
+{
+    if (state.sampled_frame == state.frame)
+        return;
+
+    PROFILE_SCOPE("Sample poses");
+
+    constexpr uint32_t HISTORY_SIZE = VrPoseService::HISTORY_SIZE;
+
+    const float predicted_seconds = VrPoseService::PredictSecondsToPhotons();
+
+    std::array<vr::TrackedDevicePose_t, vr::k_unMaxTrackedDeviceCount> poses = {};
+    vr::VRSystem()->GetDeviceToAbsoluteTrackingPose(state.origin, predicted_seconds, poses.data(), static_cast<uint32_t>(poses.size()));
+
+    const uint32_t slot = static_cast<uint32_t>(state.samples & (HISTORY_SIZE - 1));
+    VrPoseHistory& history = state.history;
+
+    uint64_t valid = 0;
+    for (uint32_t device = 0; device < vr::k_unMaxTrackedDeviceCount; device++) {
+        const vr::TrackedDevicePose_t& pose = poses[device];
+
+        history.device_to_absolute[slot][device] = pose.mDeviceToAbsoluteTracking;
+        history.velocity[slot][device] = pose.vVelocity;
+        history.angular_velocity[slot][device] = pose.vAngularVelocity;
+        if (pose.bPoseIsValid && pose.bDeviceIsConnected)
+            valid |= uint64_t(1) << device;
+    }
+    history.valid[slot] = valid;
+    history.sample_ns[slot] = Profiler::Now();
+    history.predicted_seconds[slot] = predicted_seconds;
+
+    state.samples++;
+    state.sampled_frame = state.frame;
+    state.stats.samples++;
+    state.stats.predicted_seconds_total += predicted_seconds;
+}
+
+auto VrPoseService::ProcessEvent(const vr::VREvent_t& event) -> void
+{
+    switch (event.eventType) {
+    case vr::VREvent_TrackedDeviceActivated:
+    case vr::VREvent_TrackedDeviceDeactivated:
+    case vr::VREvent_TrackedDeviceRoleChanged:
+    case vr::VREvent_TrackedDeviceUpdated:
+        State().roles_dirty = true;
+        break;
+    default:
+        break;
+    }
+}
+
+auto VrPoseService::Frame() -> uint64_t
+{
+    return State().frame;
+}
+
+auto VrPoseService::Pose(vr::TrackedDeviceIndex_t device, uint32_t frames_ago) -> VrPose
+{
+    VrPoseServiceState& state = State();
+
+    if (device >= vr::k_unMaxTrackedDeviceCount || frames_ago >= HISTORY_SIZE)
+        return {};
+
+    Sample(state);
+    if (frames_ago >= state.samples)
+        return {};
+
+    const uint32_t slot = static_cast<uint32_t>((state.samples - 1 - frames_ago) & (HISTORY_SIZE - 1));
+    const VrPoseHistory& history = state.history;
+
+    return
+    {
+        .device_to_absolute = history.device_to_absolute[slot][device],
+        .velocity = history.velocity[slot][device],
+        .angular_velocity = history.angular_velocity[slot][device],
+        .sample_ns = history.sample_ns[slot],
+        .predicted_seconds = history.predicted_seconds[slot],
+        .valid = (history.valid[slot] & (uint64_t(1) << device)) != 0,
+    };
+}
+
+auto VrPoseService::IsPoseValid(vr::TrackedDeviceIndex_t device, uint32_t frames_ago) -> bool
+{
+    VrPoseServiceState& state = State();
+
+    if (device >= vr::k_unMaxTrackedDeviceCount || frames_ago >= HISTORY_SIZE)
+        return false;
+
+    Sample(state);
+    if (frames_ago >= state.samples)
+        return false;
+
+    const uint32_t slot = static_cast<uint32_t>((state.samples - 1 - frames_ago) & (HISTORY_SIZE - 1));
+    return (state.history.valid[slot] & (uint64_t(1) << device)) != 0;
+}
+
+auto VrPoseService::Extrapolate(vr::TrackedDeviceIndex_t device, float seconds) -> VrPose
+{
+    VrPose pose = Pose(device);
+    if (!pose.valid || seconds == 0.0f)
+        return pose;
+
+    vr::HmdMatrix34_t& m = pose.device_to_absolute;
+
+    for (int row = 0; row < 3; ++row)
+        m.m[row][3] += pose.velocity.v[row] * seconds;
+
+    const glm::vec3 angular_velocity = { pose.angular_velocity.v[0], pose.angular_velocity.v[1], pose.angular_velocity.v[2] };
+    const float angle = glm::length(angular_velocity) * seconds;
+    if (angle != 0.0f) {
+        const glm::mat3 delta = glm::mat3_cast(glm::angleAxis(angle, glm::normalize(angular_velocity)));
+
+        // glm is column major, the OpenVR matrix is row major
+        glm::mat3 rotation = {};
+        for (int row = 0; row < 3; ++row) {
+            for (int col = 0; col < 3; ++col)
+                rotation[col][row] = m.m[row][col];
+        }
+        rotation = delta * rotation;
+        for (int row = 0; row < 3; ++row) {
+            for (int col = 0; col < 3; ++col)
+                m.m[row][col] = rotation[col][row];
+        }
+    }
+
+    pose.predicted_seconds += seconds;
+    return pose;
+}
+
+auto VrPoseService::DeviceForRole(vr::ETrackedControllerRole role) -> vr::TrackedDeviceIndex_t
+{
+    VrPoseServiceState& state = State();
+
+    if (role <= vr::TrackedControllerRole_Invalid || role > vr::TrackedControllerRole_Max)
+        return vr::k_unTrackedDeviceIndexInvalid;
+
+    if (state.roles_dirty) {
+        for (uint32_t i = vr::TrackedControllerRole_Invalid + 1; i <= vr::TrackedControllerRole_Max; i++) {
+            state.roles[i] = vr::VRSystem()->GetTrackedDeviceIndexForControllerRole(static_cast<vr::ETrackedControllerRole>(i));
+            state.stats.role_lookups++;
+        }
+        state.roles_dirty = false;
+    }
+
+    return state.roles[role];
+}
+
+auto VrPoseService::PredictSecondsToPhotons() -> float
+{
+    const VrPoseServiceState& state = State();
+
+    // The pacer saw a vsync while waiting for this frame, asking the compositor again is one more round trip
+    float seconds_since_vsync = 0.0f;
+    uint64_t since_vsync_ns = 0;
+    if (state.pacer != nullptr && state.pacer->TimeSinceLastVsync(&since_vsync_ns)) {
+        seconds_since_vsync = static_cast<float>(since_vsync_ns) / 1e9f;
+    }
+    else {
+        uint64_t frame_counter = 0;
+        if (!vr::VRSystem()->GetTimeSinceLastVsync(&seconds_since_vsync, &frame_counter))
+            return 0.0f;
+    }
+
+    // Both come from the property cache, a refresh rate change invalidates them there
+    const float refresh_rate = VrPropertyCache::GetFloat(vr::k_unTrackedDeviceIndex_Hmd, vr::Prop_DisplayFrequency_Float);
+    const float vsync_to_photons = VrPropertyCache::GetFloat(vr::k_unTrackedDeviceIndex_Hmd, vr::Prop_SecondsFromVsyncToPhotons_Float);
+    const float frame_duration = refresh_rate > 0.0f ? 1.0f / refresh_rate : 0.0f;
+
+    return std::max(frame_duration - seconds_since_vsync + vsync_to_photons, 0.0f);
+}
+
+auto VrPoseService::Stats() -> VrPoseServiceStats
+{
+    return State().stats;
+}
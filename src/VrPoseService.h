@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2025. Nyabsi <nyabsi@sovellus.cc>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include <openvr.h>
+
+class FramePacer;
+
+struct VrPose
+{
+    vr::HmdMatrix34_t device_to_absolute;
+    vr::HmdVector3_t velocity;          // m/s in tracking space
+    vr::HmdVector3_t angular_velocity;  // rad/s
+    uint64_t sample_ns;                 // Profiler::Now() when the frame was sampled
+    float predicted_seconds;            // how far ahead of sample_ns the pose was predicted
+    bool valid;                         // tracked and connected
+};
+
+struct VrPoseServiceStats
+{
+    uint64_t frames;                    // BeginFrame calls
+    uint64_t samples;                   // frames something read a pose in, each one GetDeviceToAbsoluteTrackingPose call
+    uint64_t role_lookups;              // GetTrackedDeviceIndexForControllerRole calls, only after a role changed
+    double predicted_seconds_total;     // summed over every sample
+};
+
+// Samples the pose of every tracked device with a single GetDeviceToAbsoluteTrackingPose call, predicted to when
+// the compositor will put the frame on screen. The sample is taken by the first read of a frame, frames nobody
+// reads a pose in cost no IPC at all. The last HISTORY_SIZE samples are kept as a structure of arrays, one array
+// per field, so readers walking a device's history or every device of a frame touch only the fields they need.
+// Overlays and UI panels read poses and controller roles from here instead of asking vrserver themselves.
+//
+// Everything here belongs to the main thread.
+class VrPoseService {
+public:
+    static constexpr uint32_t HISTORY_SIZE = 8;
+
+    static auto SetTrackingOrigin(vr::ETrackingUniverseOrigin origin) -> void;
+    // The vsync timing is taken from pacer when it has one, the compositor is only asked without it
+    static auto SetFramePacer(const FramePacer* pacer) -> void;
+
+    // Once per frame, the next read of a pose samples them for this frame
+    static auto BeginFrame() -> void;
+    // Feed system events through here, controller roles are resolved again after devices come and go
+    static auto ProcessEvent(const vr::VREvent_t& event) -> void;
+
+    // Number of frames begun so far
+    [[nodiscard]] static auto Frame() -> uint64_t;
+    // frames_ago = 0 is this frame's sample, older ones count sampled frames only. An invalid pose is returned
+    // past the history or the device range.
+    [[nodiscard]] static auto Pose(vr::TrackedDeviceIndex_t device, uint32_t frames_ago = 0) -> VrPose;
+    [[nodiscard]] static auto IsPoseValid(vr::TrackedDeviceIndex_t device, uint32_t frames_ago = 0) -> bool;
+    // The latest pose moved forward by seconds along its velocities, for overlays that follow a device smoothly
+    [[nodiscard]] static auto Extrapolate(vr::TrackedDeviceIndex_t device, float seconds) -> VrPose;
+
+    // k_unTrackedDeviceIndexInvalid when nothing has the role
+    [[nodiscard]] static auto DeviceForRole(vr::ETrackedControllerRole role) -> vr::TrackedDeviceIndex_t;
+
+    // Seconds from now until the next frame is lit on the display
+    [[nodiscard]] static auto PredictSecondsToPhotons() -> float;
+
+    [[nodiscard]] static auto Stats() -> VrPoseServiceStats;
+};
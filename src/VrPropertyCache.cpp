@@ -0,0 +1,332 @@
+/*
+ * Copyright (C) 2025. Nyabsi <nyabsi@sovellus.cc>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "VrPropertyCache.h"
+
+#include <array>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct VrCachedProperty
+{
+    union Value
+    {
+        bool b;
+        float f;
+        int32_t i32;
+        uint64_t u64;
+        vr::HmdMatrix34_t matrix;
+    };
+
+    vr::PropertyTypeTag_t tag;  // k_unInvalidPropertyTag makes the next read go to the runtime again
+    vr::ETrackedPropertyError error;
+    Value value;
+    std::string string;
+    std::vector<uint8_t> bytes;
+};
+
+struct VrPropertyCacheState
+{
+    VrPropertyCacheState()
+    {
+        properties.clear();
+        connected.fill(-1);
+        stats = {};
+    }
+
+    std::mutex mutex;
+    std::unordered_map<uint64_t, VrCachedProperty> properties;
+    std::array<int8_t, vr::k_unMaxTrackedDeviceCount> connected;    // -1 until asked
+    VrPropertyCacheStats stats;
+};
+
+struct VrPrefetchedProperty
+{
+    vr::ETrackedDeviceProperty property;
+    vr::PropertyTypeTag_t tag;
+};
+
+// What device panels show, read for every connected device up front
+static constexpr VrPrefetchedProperty PREFETCHED_PROPERTIES[] =
+{
+    { vr::Prop_TrackingSystemName_String, vr::k_unStringPropertyTag },
+    { vr::Prop_ModelNumber_String, vr::k_unStringPropertyTag },
+    { vr::Prop_SerialNumber_String, vr::k_unStringPropertyTag },
+    { vr::Prop_ManufacturerName_String, vr::k_unStringPropertyTag },
+    { vr::Prop_RenderModelName_String, vr::k_unStringPropertyTag },
+    { vr::Prop_DeviceClass_Int32, vr::k_unInt32PropertyTag },
+    { vr::Prop_ControllerRoleHint_Int32, vr::k_unInt32PropertyTag },
+    { vr::Prop_DeviceProvidesBatteryStatus_Bool, vr::k_unBoolPropertyTag },
+    { vr::Prop_DeviceIsCharging_Bool, vr::k_unBoolPropertyTag },
+    { vr::Prop_DeviceBatteryPercentage_Float, vr::k_unFloatPropertyTag },
+    { vr::Prop_DisplayFrequency_Float, vr::k_unFloatPropertyTag },
+    { vr::Prop_SecondsFromVsyncToPhotons_Float, vr::k_unFloatPropertyTag },
+};
+
+static auto State() -> VrPropertyCacheState&
+{
+    static VrPropertyCacheState state;
+    return state;
+}
+
+static auto PropertyKey(vr::TrackedDeviceIndex_t device, vr::ETrackedDeviceProperty property) -> uint64_t
+{
+    return (static_cast<uint64_t>(device) << 32) | static_cast<uint32_t>(property);
+}
+
+static auto ReportError(vr::ETrackedPropertyError* error, vr::ETrackedPropertyError value) -> void
+{
+    if (error != nullptr)
+        *error = value;
+}
+
+// Must be called with the cache mutex held
+template <typename Fetch>
+static auto Lookup(vr::TrackedDeviceIndex_t device, vr::ETrackedDeviceProperty property, vr::PropertyTypeTag_t tag, Fetch fetch) -> const VrCachedProperty&
+{
+    VrPropertyCacheState& state = State();
+
+    VrCachedProperty& entry = state.properties[PropertyKey(device, property)];
+    if (entry.tag == tag) {
+        state.stats.hits++;
+        return entry;
+    }
+
+    entry.tag = tag;
+    entry.error = vr::TrackedProp_Success;
+    entry.value = {};
+    entry.string.clear();
+    entry.bytes.clear();
+
+    if (device >= vr::k_unMaxTrackedDeviceCount) {
+        entry.error = vr::TrackedProp_InvalidDevice;
+        return entry;
+    }
+
+    state.stats.misses++;
+    fetch(entry);
+
+    // Not there yet, but it will be without an event telling us
+    if (entry.error == vr::TrackedProp_NotYetAvailable)
+        entry.tag = vr::k_unInvalidPropertyTag;
+
+    return entry;
+}
+
+// Must be called with the cache mutex held
+static auto DropDevice(vr::TrackedDeviceIndex_t device) -> void
+{
+    VrPropertyCacheState& state = State();
+
+    for (auto it = state.properties.begin(); it != state.properties.end();) {
+        if ((it->first >> 32) == device)
+            it = state.properties.erase(it);
+        else
+            ++it;
+    }
+    state.stats.invalidations++;
+}
+
+auto VrPropertyCache::Prefetch() -> void
+{
+    for (vr::TrackedDeviceIndex_t device = 0; device < vr::k_unMaxTrackedDeviceCount; device++) {
+        if (IsConnected(device))
+            PrefetchDevice(device);
+    }
+}
+
+auto VrPropertyCache::PrefetchDevice(vr::TrackedDeviceIndex_t device) -> void
+{
+    for (const VrPrefetchedProperty& prefetched : PREFETCHED_PROPERTIES) {
+        switch (prefetched.tag) {
+        case vr::k_unStringPropertyTag:
+            GetString(device, prefetched.property);
+            break;
+        case vr::k_unInt32PropertyTag:
+            GetInt32(device, prefetched.property);
+            break;
+        case vr::k_unBoolPropertyTag:
+            GetBool(device, prefetched.property);
+            break;
+        case vr::k_unFloatPropertyTag:
+            GetFloat(device, prefetched.property);
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+auto VrPropertyCache::ProcessEvent(const vr::VREvent_t& event) -> void
+{
+    const vr::TrackedDeviceIndex_t device = event.trackedDeviceIndex;
+    if (device >= vr::k_unMaxTrackedDeviceCount)
+        return;
+
+    switch (event.eventType) {
+    case vr::VREvent_PropertyChanged:
+    {
+        std::lock_guard<std::mutex> lock(State().mutex);
+        if (State().properties.erase(PropertyKey(device, event.data.property.prop)) > 0)
+            State().stats.invalidations++;
+        break;
+    }
+    case vr::VREvent_TrackedDeviceActivated:
+    {
+        {
+            std::lock_guard<std::mutex> lock(State().mutex);
+            DropDevice(device);
+            State().connected[device] = 1;
+        }
+        // A new device is about to be shown, have it ready like the ones found at startup
+        PrefetchDevice(device);
+        break;
+    }
+    case vr::VREvent_TrackedDeviceDeactivated:
+    {
+        std::lock_guard<std::mutex> lock(State().mutex);
+        DropDevice(device);
+        State().connected[device] = 0;
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+auto VrPropertyCache::Clear() -> void
+{
+    std::lock_guard<std::mutex> lock(State().mutex);
+    State().properties.clear();
+    State().connected.fill(-1);
+}
+
+auto VrPropertyCache::IsConnected(vr::TrackedDeviceIndex_t device) -> bool
+{
+    if (device >= vr::k_unMaxTrackedDeviceCount)
+        return false;
+
+    std::lock_guard<std::mutex> lock(State().mutex);
+    VrPropertyCacheState& state = State();
+
+    if (state.connected[device] < 0) {
+        state.stats.misses++;
+        state.connected[device] = vr::VRSystem()->IsTrackedDeviceConnected(device) ? 1 : 0;
+    }
+    else {
+        state.stats.hits++;
+    }
+
+    return state.connected[device] == 1;
+}
+
+auto VrPropertyCache::GetBool(vr::TrackedDeviceIndex_t device, vr::ETrackedDeviceProperty property, vr::ETrackedPropertyError* error) -> bool
+{
+    std::lock_guard<std::mutex> lock(State().mutex);
+    const VrCachedProperty& entry = Lookup(device, property, vr::k_unBoolPropertyTag, [&](VrCachedProperty& fetched) {
+        fetched.value.b = vr::VRSystem()->GetBoolTrackedDeviceProperty(device, property, &fetched.error);
+    });
+
+    ReportError(error, entry.error);
+    return entry.value.b;
+}
+
+auto VrPropertyCache::GetFloat(vr::TrackedDeviceIndex_t device, vr::ETrackedDeviceProperty property, vr::ETrackedPropertyError* error) -> float
+{
+    std::lock_guard<std::mutex> lock(State().mutex);
+    const VrCachedProperty& entry = Lookup(device, property, vr::k_unFloatPropertyTag, [&](VrCachedProperty& fetched) {
+        fetched.value.f = vr::VRSystem()->GetFloatTrackedDeviceProperty(device, property, &fetched.error);
+    });
+
+    ReportError(error, entry.error);
+    return entry.value.f;
+}
+
+auto VrPropertyCache::GetInt32(vr::TrackedDeviceIndex_t device, vr::ETrackedDeviceProperty property, vr::ETrackedPropertyError* error) -> int32_t
+{
+    std::lock_guard<std::mutex> lock(State().mutex);
+    const VrCachedProperty& entry = Lookup(device, property, vr::k_unInt32PropertyTag, [&](VrCachedProperty& fetched) {
+        fetched.value.i32 = vr::VRSystem()->GetInt32TrackedDeviceProperty(device, property, &fetched.error);
+    });
+
+    ReportError(error, entry.error);
+    return entry.value.i32;
+}
+
+auto VrPropertyCache::GetUint64(vr::TrackedDeviceIndex_t device, vr::ETrackedDeviceProperty property, vr::ETrackedPropertyError* error) -> uint64_t
+{
+    std::lock_guard<std::mutex> lock(State().mutex);
+    const VrCachedProperty& entry = Lookup(device, property, vr::k_unUint64PropertyTag, [&](VrCachedProperty& fetched) {
+        fetched.value.u64 = vr::VRSystem()->GetUint64TrackedDeviceProperty(device, property, &fetched.error);
+    });
+
+    ReportError(error, entry.error);
+    return entry.value.u64;
+}
+
+auto VrPropertyCache::GetMatrix34(vr::TrackedDeviceIndex_t device, vr::ETrackedDeviceProperty property, vr::ETrackedPropertyError* error) -> vr::HmdMatrix34_t
+{
+    std::lock_guard<std::mutex> lock(State().mutex);
+    const VrCachedProperty& entry = Lookup(device, property, vr::k_unHmdMatrix34PropertyTag, [&](VrCachedProperty& fetched) {
+        fetched.value.matrix = vr::VRSystem()->GetMatrix34TrackedDeviceProperty(device, property, &fetched.error);
+    });
+
+    ReportError(error, entry.error);
+    return entry.value.matrix;
+}
+
+auto VrPropertyCache::GetString(vr::TrackedDeviceIndex_t device, vr::ETrackedDeviceProperty property, vr::ETrackedPropertyError* error) -> std::string_view
+{
+    std::lock_guard<std::mutex> lock(State().mutex);
+    const VrCachedProperty& entry = Lookup(device, property, vr::k_unStringPropertyTag, [&](VrCachedProperty& fetched) {
+        char buffer[INLINE_STRING_SIZE];
+        uint32_t size = vr::VRSystem()->GetStringTrackedDeviceProperty(device, property, buffer, sizeof(buffer), &fetched.error);
+
+        // The returned size includes the terminator and is what the buffer would have needed
+        if (fetched.error == vr::TrackedProp_BufferTooSmall) {
+            fetched.string.resize(size);
+            size = vr::VRSystem()->GetStringTrackedDeviceProperty(device, property, fetched.string.data(), size, &fetched.error);
+            fetched.string.resize(fetched.error == vr::TrackedProp_Success && size > 0 ? size - 1 : 0);
+        }
+        else if (fetched.error == vr::TrackedProp_Success && size > 0) {
+            fetched.string.assign(buffer, size - 1);
+        }
+    });
+
+    ReportError(error, entry.error);
+    return entry.error == vr::TrackedProp_Success ? std::string_view(entry.string) : std::string_view();
+}
+
+auto VrPropertyCache::GetArrayBytes(vr::TrackedDeviceIndex_t device, vr::ETrackedDeviceProperty property, vr::PropertyTypeTag_t tag, vr::ETrackedPropertyError* error) -> std::span<const uint8_t>
+{
+    std::lock_guard<std::mutex> lock(State().mutex);
+    const VrCachedProperty& entry = Lookup(device, property, tag, [&](VrCachedProperty& fetched) {
+        alignas(16) uint8_t buffer[INLINE_STRING_SIZE];
+        uint32_t size = vr::VRSystem()->GetArrayTrackedDeviceProperty(device, property, tag, buffer, sizeof(buffer), &fetched.error);
+
+        if (fetched.error == vr::TrackedProp_BufferTooSmall) {
+            fetched.bytes.resize(size);
+            size = vr::VRSystem()->GetArrayTrackedDeviceProperty(device, property, tag, fetched.bytes.data(), size, &fetched.error);
+            fetched.bytes.resize(fetched.error == vr::TrackedProp_Success ? size : 0);
+        }
+        else if (fetched.error == vr::TrackedProp_Success) {
+            fetched.bytes.assign(buffer, buffer + size);
+        }
+    });
+
+    ReportError(error, entry.error);
+    return entry.error == vr::TrackedProp_Success ? std::span<const uint8_t>(entry.bytes) : std::span<const uint8_t>();
+}
+
+auto VrPropertyCache::Stats() -> VrPropertyCacheStats
+{
+    std::lock_guard<std::mutex> lock(State().mutex);
+    return State().stats;
+}
@@ -0,0 +1,65 @@
+/*
+ * Copyright (C) 2025. Nyabsi <nyabsi@sovellus.cc>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+#include <openvr.h>
+
+struct VrPropertyCacheStats
+{
+    uint64_t hits;
+    uint64_t misses;        // each one a round trip to vrserver
+    uint64_t invalidations; // properties or devices dropped because of an event
+};
+
+// Process wide cache of tracked device properties. Properties rarely change and every read is a round trip to
+// vrserver, so each one is read once and kept until an event says otherwise: VREvent_PropertyChanged drops the
+// property, VREvent_TrackedDeviceActivated and VREvent_TrackedDeviceDeactivated drop the whole device. Errors
+// are cached as well, a property the device does not have is not asked for again.
+//
+// Strings and arrays are handed out as views into the cache, valid until the property is invalidated. Reading
+// and invalidating may happen on different threads, views should not outlive the frame they were taken in.
+class VrPropertyCache {
+public:
+    // Strings up to this size are read without allocating, longer ones take a second call
+    static constexpr uint32_t INLINE_STRING_SIZE = 256;
+
+    // Reads the common properties of every connected device, call once after VR_Init
+    static auto Prefetch() -> void;
+    static auto PrefetchDevice(vr::TrackedDeviceIndex_t device) -> void;
+    // Feed every system and overlay event through here
+    static auto ProcessEvent(const vr::VREvent_t& event) -> void;
+    static auto Clear() -> void;
+
+    [[nodiscard]] static auto IsConnected(vr::TrackedDeviceIndex_t device) -> bool;
+
+    static auto GetBool(vr::TrackedDeviceIndex_t device, vr::ETrackedDeviceProperty property, vr::ETrackedPropertyError* error = nullptr) -> bool;
+    static auto GetFloat(vr::TrackedDeviceIndex_t device, vr::ETrackedDeviceProperty property, vr::ETrackedPropertyError* error = nullptr) -> float;
+    static auto GetInt32(vr::TrackedDeviceIndex_t device, vr::ETrackedDeviceProperty property, vr::ETrackedPropertyError* error = nullptr) -> int32_t;
+    static auto GetUint64(vr::TrackedDeviceIndex_t device, vr::ETrackedDeviceProperty property, vr::ETrackedPropertyError* error = nullptr) -> uint64_t;
+    static auto GetMatrix34(vr::TrackedDeviceIndex_t device, vr::ETrackedDeviceProperty property, vr::ETrackedPropertyError* error = nullptr) -> vr::HmdMatrix34_t;
+    // Empty on error
+    static auto GetString(vr::TrackedDeviceIndex_t device, vr::ETrackedDeviceProperty property, vr::ETrackedPropertyError* error = nullptr) -> std::string_view;
+
+    // Elements of type T tagged with tag (vr::k_unFloatPropertyTag, vr::k_unHmdVector3PropertyTag, ...), empty on error
+    template <typename T>
+    static auto GetArray(vr::TrackedDeviceIndex_t device, vr::ETrackedDeviceProperty property, vr::PropertyTypeTag_t tag, vr::ETrackedPropertyError* error = nullptr) -> std::span<const T>
+    {
+        const std::span<const uint8_t> bytes = GetArrayBytes(device, property, tag, error);
+        return { reinterpret_cast<const T*>(bytes.data()), bytes.size() / sizeof(T) };
+    }
+
+    [[nodiscard]] static auto Stats() -> VrPropertyCacheStats;
+
+private:
+    static auto GetArrayBytes(vr::TrackedDeviceIndex_t device, vr::ETrackedDeviceProperty property, vr::PropertyTypeTag_t tag, vr::ETrackedPropertyError* error) -> std::span<const uint8_t>;
+};
@@ -12,10 +12,13 @@
 #include <span>
 #include <string>
 #include <stdexcept>
+#include <vector>
 
 #include <openvr.h>
 #include <SDL3/SDL.h>
 
+#include "VrPropertyCache.h"
+
 static auto OpenVRInit(vr::EVRApplicationType type) -> void
 {
     vr::EVRInitError result = {};
@@ -55,15 +58,14 @@ class VrTrackedDeviceProperties {
     [[nodiscard]] auto Handle() const -> vr::TrackedDeviceIndex_t { return handle; }
 
     [[maybe_unused]] auto CheckConnection() const -> void {
-        if (!vr::VRSystem()->IsTrackedDeviceConnected(handle))
+        if (!VrPropertyCache::IsConnected(handle))
             throw std::runtime_error("The device must be connected to use VrTrackedDeviceProperties!");
     }
 
     [[maybe_unused]] auto GetString(const vr::ETrackedDeviceProperty property) const -> std::string { 
         vr::ETrackedPropertyError result = {};
-        std::vector<char> buffer(vr::k_unMaxPropertyStringSize);
-        auto buffer_len = vr::VRSystem()->GetStringTrackedDeviceProperty(handle, property, buffer.data(), vr::k_unMaxPropertyStringSize, &result);
-        if (result != vr::TrackedProp_Success || buffer_len == 0) {
+        auto value = VrPropertyCache::GetString(handle, property, &result);
+        if (result != vr::TrackedProp_Success || value.empty()) {
             throw std::runtime_error(std::format(
                 "Failed to get string prop \"{}\" for {} (err={})",
                 static_cast<int>(property),
@@ -72,12 +74,12 @@ class VrTrackedDeviceProperties {
             ));
         }
 
-        return buffer.data();
+        return std::string(value);
     }
 
     [[maybe_unused]] auto GetBool(const vr::ETrackedDeviceProperty property) -> bool {
         vr::ETrackedPropertyError result = {};
-        auto value = vr::VRSystem()->GetBoolTrackedDeviceProperty(handle, property, &result);
+        auto value = VrPropertyCache::GetBool(handle, property, &result);
         if (result > vr::TrackedProp_Success)
             throw std::runtime_error(
                 std::format(
@@ -91,7 +93,7 @@ class VrTrackedDeviceProperties {
 
     [[maybe_unused]] auto GetFloat(const vr::ETrackedDeviceProperty property) -> float {
         vr::ETrackedPropertyError result = {};
-        auto value = vr::VRSystem()->GetFloatTrackedDeviceProperty(handle, property, &result);
+        auto value = VrPropertyCache::GetFloat(handle, property, &result);
         if (result > vr::TrackedProp_Success)
             throw std::runtime_error(
                 std::format(
@@ -105,7 +107,7 @@ class VrTrackedDeviceProperties {
 
     [[maybe_unused]] auto GetInt32(const vr::ETrackedDeviceProperty property) -> int32_t {
         vr::ETrackedPropertyError result = {};
-        auto value = vr::VRSystem()->GetInt32TrackedDeviceProperty(handle, property, &result);
+        auto value = VrPropertyCache::GetInt32(handle, property, &result);
         if (result > vr::TrackedProp_Success)
             throw std::runtime_error(
                 std::format(
@@ -117,8 +119,20 @@ class VrTrackedDeviceProperties {
         return value;
     }
 
-    // TODO: implement
-    // [[maybe_unused]] auto GetArray(const vr::ETrackedDeviceProperty property) -> void { }
+    template <typename T>
+    [[maybe_unused]] auto GetArray(const vr::ETrackedDeviceProperty property, const vr::PropertyTypeTag_t tag) -> std::vector<T> {
+        vr::ETrackedPropertyError result = {};
+        auto value = VrPropertyCache::GetArray<T>(handle, property, tag, &result);
+        if (result > vr::TrackedProp_Success)
+            throw std::runtime_error(
+                std::format(
+                    "Failed to get array prop \"{}\" for {} ({})",
+                    static_cast<int>(property),
+                    static_cast<int>(handle),
+                    static_cast<int>(result)
+                ));
+        return std::vector<T>(value.begin(), value.end());
+    }
 
   private:
     explicit VrTrackedDeviceProperties(const vr::TrackedDeviceIndex_t handle) : handle{handle} {}
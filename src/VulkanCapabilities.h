@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2025. Nyabsi <nyabsi@sovellus.cc>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <vector>
+#include <string>
+#include <string_view>
+#include <algorithm>
+#include <optional>
+#include <cstdlib>
+
+#include <vulkan/vulkan.h>
+
+// Extension names stored sorted so lookups are a binary search instead of a walk over VkExtensionProperties.
+class VulkanExtensionSet {
+public:
+    explicit VulkanExtensionSet() = default;
+
+    explicit VulkanExtensionSet(const std::vector<VkExtensionProperties>& properties)
+    {
+        names_.reserve(properties.size());
+        for (const VkExtensionProperties& p : properties)
+            names_.emplace_back(p.extensionName);
+
+        std::sort(names_.begin(), names_.end());
+        names_.erase(std::unique(names_.begin(), names_.end()), names_.end());
+    }
+
+    [[nodiscard]] auto Contains(std::string_view extension) const -> bool
+    {
+        return std::binary_search(names_.begin(), names_.end(), extension, [](std::string_view a, std::string_view b) { return a < b; });
+    }
+
+    [[nodiscard]] auto Names() const -> const std::vector<std::string>& { return names_; }
+    [[nodiscard]] auto Size() const -> size_t { return names_.size(); }
+
+private:
+    std::vector<std::string> names_;
+};
+
+class VulkanInstanceCapabilities {
+public:
+    // The instance extensions cannot change while the process runs, enumerate them once.
+    [[nodiscard]] static auto Get() -> const VulkanInstanceCapabilities&
+    {
+        static const VulkanInstanceCapabilities capabilities = Query();
+        return capabilities;
+    }
+
+    [[nodiscard]] auto HasExtension(std::string_view extension) const -> bool { return extensions_.Contains(extension); }
+    [[nodiscard]] auto Extensions() const -> const VulkanExtensionSet& { return extensions_; }
+
+private:
+    static auto Query() -> VulkanInstanceCapabilities
+    {
+        uint32_t extension_properties_count = {};
+        std::vector<VkExtensionProperties> extension_properties = {};
+
+        vkEnumerateInstanceExtensionProperties(nullptr, &extension_properties_count, nullptr);
+
+        if (extension_properties_count > 0) {
+            extension_properties.resize(extension_properties_count);
+            vkEnumerateInstanceExtensionProperties(nullptr, &extension_properties_count, extension_properties.data());
+        }
+        else {
+            std::exit(EXIT_FAILURE);
+        }
+
+        VulkanInstanceCapabilities capabilities;
+        capabilities.extensions_ = VulkanExtensionSet(extension_properties);
+        return capabilities;
+    }
+
+    VulkanExtensionSet extensions_;
+};
+
+// Everything the renderer asks the driver about a physical device, queried once when the device is picked.
+class VulkanDeviceCapabilities {
+public:
+    explicit VulkanDeviceCapabilities()
+        : physical_device_(VK_NULL_HANDLE),
+        properties_({}),
+        features_({}),
+        memory_properties_({}) {}
+
+    [[nodiscard]] static auto FromPhysicalDevice(VkPhysicalDevice physical_device) -> VulkanDeviceCapabilities
+    {
+        VulkanDeviceCapabilities capabilities;
+        capabilities.physical_device_ = physical_device;
+
+        vkGetPhysicalDeviceProperties(physical_device, &capabilities.properties_);
+        vkGetPhysicalDeviceFeatures(physical_device, &capabilities.features_);
+        vkGetPhysicalDeviceMemoryProperties(physical_device, &capabilities.memory_properties_);
+
+        uint32_t family_prop_count = {};
+        vkGetPhysicalDeviceQueueFamilyProperties(physical_device, &family_prop_count, nullptr);
+        capabilities.queue_families_.resize(family_prop_count);
+        vkGetPhysicalDeviceQueueFamilyProperties(physical_device, &family_prop_count, capabilities.queue_families_.data());
+
+        uint32_t extension_properties_count = {};
+        std::vector<VkExtensionProperties> extension_properties = {};
+
+        vkEnumerateDeviceExtensionProperties(physical_device, nullptr, &extension_properties_count, nullptr);
+
+        if (extension_properties_count > 0) {
+            extension_properties.resize(extension_properties_count);
+            vkEnumerateDeviceExtensionProperties(physical_device, nullptr, &extension_properties_count, extension_properties.data());
+        }
+        else {
+            std::exit(EXIT_FAILURE);
+        }
+
+        capabilities.extensions_ = VulkanExtensionSet(extension_properties);
+        return capabilities;
+    }
+
+    [[nodiscard]] auto PhysicalDevice() const -> VkPhysicalDevice { return physical_device_; }
+    [[nodiscard]] auto Properties() const -> const VkPhysicalDeviceProperties& { return properties_; }
+    [[nodiscard]] auto Limits() const -> const VkPhysicalDeviceLimits& { return properties_.limits; }
+    [[nodiscard]] auto Features() const -> const VkPhysicalDeviceFeatures& { return features_; }
+    [[nodiscard]] auto MemoryProperties() const -> const VkPhysicalDeviceMemoryProperties& { return memory_properties_; }
+    [[nodiscard]] auto QueueFamilies() const -> const std::vector<VkQueueFamilyProperties>& { return queue_families_; }
+    [[nodiscard]] auto Extensions() const -> const VulkanExtensionSet& { return extensions_; }
+
+    [[nodiscard]] auto HasExtension(std::string_view extension) const -> bool { return extensions_.Contains(extension); }
+
+    [[nodiscard]] auto FindMemoryType(uint32_t type_bits, VkMemoryPropertyFlags properties) const -> std::optional<uint32_t>
+    {
+        for (uint32_t i = 0; i < memory_properties_.memoryTypeCount; i++) {
+            if ((type_bits & (1u << i)) && (memory_properties_.memoryTypes[i].propertyFlags & properties) == properties)
+                return i;
+        }
+        return std::nullopt;
+    }
+
+private:
+    VkPhysicalDevice physical_device_;
+    VkPhysicalDeviceProperties properties_;
+    VkPhysicalDeviceFeatures features_;
+    VkPhysicalDeviceMemoryProperties memory_properties_;
+    std::vector<VkQueueFamilyProperties> queue_families_;
+    VulkanExtensionSet extensions_;
+};
@@ -0,0 +1,114 @@
+/*
+ * Copyright (C) 2025. Nyabsi <nyabsi@sovellus.cc>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "VulkanDeletionQueue.h"
+
+#include <algorithm>
+#include <cassert>
+
+VulkanDeletionQueue::VulkanDeletionQueue()
+{
+    instance_ = VK_NULL_HANDLE;
+    device_ = VK_NULL_HANDLE;
+    allocator_ = nullptr;
+    entries_.clear();
+    oldest_value_ = UINT64_MAX;
+}
+
+auto VulkanDeletionQueue::Initialize(VkInstance instance, VkDevice device, VkAllocationCallbacks* allocator) -> void
+{
+    instance_ = instance;
+    device_ = device;
+    allocator_ = allocator;
+}
+
+auto VulkanDeletionQueue::Push(uint64_t value, VkObjectType type, uint64_t handle) -> void
+{
+    if (handle == 0)
+        return;
+
+    entries_.push_back({ .value = value, .type = type, .handle = handle });
+    oldest_value_ = std::min(oldest_value_, value);
+}
+
+auto VulkanDeletionQueue::Collect(uint64_t completed_value) -> void
+{
+    // Values are not deferred in order, the ring frames of the overlay each carry their own, so
+    // the whole queue is walked. Nothing is walked until the oldest entry is due.
+    if (oldest_value_ > completed_value)
+        return;
+
+    uint64_t oldest_value = UINT64_MAX;
+
+    auto it = std::remove_if(entries_.begin(), entries_.end(), [&](const Entry& entry) {
+        if (entry.value > completed_value) {
+            oldest_value = std::min(oldest_value, entry.value);
+            return false;
+        }
+
+        this->DestroyObject(entry);
+        return true;
+    });
+
+    entries_.erase(it, entries_.end());
+    oldest_value_ = oldest_value;
+}
+
+auto VulkanDeletionQueue::Flush() -> void
+{
+    for (const Entry& entry : entries_)
+        this->DestroyObject(entry);
+
+    entries_.clear();
+    oldest_value_ = UINT64_MAX;
+}
+
+auto VulkanDeletionQueue::DestroyObject(const Entry& entry) const -> void
+{
+    switch (entry.type) {
+    case VK_OBJECT_TYPE_IMAGE:
+        vkDestroyImage(device_, (VkImage)entry.handle, allocator_);
+        break;
+    case VK_OBJECT_TYPE_IMAGE_VIEW:
+        vkDestroyImageView(device_, (VkImageView)entry.handle, allocator_);
+        break;
+    case VK_OBJECT_TYPE_BUFFER:
+        vkDestroyBuffer(device_, (VkBuffer)entry.handle, allocator_);
+        break;
+    case VK_OBJECT_TYPE_DEVICE_MEMORY:
+        vkFreeMemory(device_, (VkDeviceMemory)entry.handle, allocator_);
+        break;
+    case VK_OBJECT_TYPE_COMMAND_POOL:
+        vkDestroyCommandPool(device_, (VkCommandPool)entry.handle, allocator_);
+        break;
+    case VK_OBJECT_TYPE_SEMAPHORE:
+        vkDestroySemaphore(device_, (VkSemaphore)entry.handle, allocator_);
+        break;
+    case VK_OBJECT_TYPE_FRAMEBUFFER:
+        vkDestroyFramebuffer(device_, (VkFramebuffer)entry.handle, allocator_);
+        break;
+    case VK_OBJECT_TYPE_RENDER_PASS:
+        vkDestroyRenderPass(device_, (VkRenderPass)entry.handle, allocator_);
+        break;
+    case VK_OBJECT_TYPE_PIPELINE:
+        vkDestroyPipeline(device_, (VkPipeline)entry.handle, allocator_);
+        break;
+    case VK_OBJECT_TYPE_DESCRIPTOR_POOL:
+        vkDestroyDescriptorPool(device_, (VkDescriptorPool)entry.handle, allocator_);
+        break;
+    case VK_OBJECT_TYPE_SWAPCHAIN_KHR:
+        vkDestroySwapchainKHR(device_, (VkSwapchainKHR)entry.handle, allocator_);
+        break;
+    case VK_OBJECT_TYPE_SURFACE_KHR:
+        vkDestroySurfaceKHR(instance_, (VkSurfaceKHR)entry.handle, allocator_);
+        break;
+    default:
+        assert(false && "Unhandled object type in deletion queue");
+        break;
+    }
+}
@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2025. Nyabsi <nyabsi@sovellus.cc>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <vulkan/vulkan.h>
+
+// Vulkan objects waiting for the GPU to finish with them. Every object is tagged with the timeline value of
+// the last submission that used it and destroyed by Collect once the timeline reached that value, so releasing
+// resources at runtime never has to idle the queue. Objects tagged with the same value are destroyed in the
+// order they were deferred, a swapchain deferred before its surface goes first.
+class VulkanDeletionQueue {
+public:
+    // For objects the timeline can't tell the GPU is done with, only Flush destroys them
+    static constexpr uint64_t IDLE_VALUE = UINT64_MAX;
+
+    explicit VulkanDeletionQueue();
+
+    auto Initialize(VkInstance instance, VkDevice device, VkAllocationCallbacks* allocator) -> void;
+
+    auto Defer(uint64_t value, VkImage image) -> void { this->Push(value, VK_OBJECT_TYPE_IMAGE, (uint64_t)image); }
+    auto Defer(uint64_t value, VkImageView image_view) -> void { this->Push(value, VK_OBJECT_TYPE_IMAGE_VIEW, (uint64_t)image_view); }
+    auto Defer(uint64_t value, VkBuffer buffer) -> void { this->Push(value, VK_OBJECT_TYPE_BUFFER, (uint64_t)buffer); }
+    auto Defer(uint64_t value, VkDeviceMemory memory) -> void { this->Push(value, VK_OBJECT_TYPE_DEVICE_MEMORY, (uint64_t)memory); }
+    // Frees the command buffers allocated from it as well
+    auto Defer(uint64_t value, VkCommandPool command_pool) -> void { this->Push(value, VK_OBJECT_TYPE_COMMAND_POOL, (uint64_t)command_pool); }
+    auto Defer(uint64_t value, VkSemaphore semaphore) -> void { this->Push(value, VK_OBJECT_TYPE_SEMAPHORE, (uint64_t)semaphore); }
+    auto Defer(uint64_t value, VkFramebuffer framebuffer) -> void { this->Push(value, VK_OBJECT_TYPE_FRAMEBUFFER, (uint64_t)framebuffer); }
+    auto Defer(uint64_t value, VkRenderPass render_pass) -> void { this->Push(value, VK_OBJECT_TYPE_RENDER_PASS, (uint64_t)render_pass); }
+    auto Defer(uint64_t value, VkPipeline pipeline) -> void { this->Push(value, VK_OBJECT_TYPE_PIPELINE, (uint64_t)pipeline); }
+    auto Defer(uint64_t value, VkDescriptorPool descriptor_pool) -> void { this->Push(value, VK_OBJECT_TYPE_DESCRIPTOR_POOL, (uint64_t)descriptor_pool); }
+    auto Defer(uint64_t value, VkSwapchainKHR swapchain) -> void { this->Push(value, VK_OBJECT_TYPE_SWAPCHAIN_KHR, (uint64_t)swapchain); }
+    auto Defer(uint64_t value, VkSurfaceKHR surface) -> void { this->Push(value, VK_OBJECT_TYPE_SURFACE_KHR, (uint64_t)surface); }
+
+    // Destroys every object tagged at or below completed_value
+    auto Collect(uint64_t completed_value) -> void;
+    // Destroys everything, the caller has to know the GPU is done with all of it
+    auto Flush() -> void;
+
+    [[nodiscard]] auto Empty() const -> bool { return entries_.empty(); }
+    [[nodiscard]] auto Size() const -> size_t { return entries_.size(); }
+    // Lowest value still pending, UINT64_MAX when empty
+    [[nodiscard]] auto OldestValue() const -> uint64_t { return oldest_value_; }
+
+private:
+    struct Entry
+    {
+        uint64_t value;
+        VkObjectType type;
+        uint64_t handle;
+    };
+
+    auto Push(uint64_t value, VkObjectType type, uint64_t handle) -> void;
+    auto DestroyObject(const Entry& entry) const -> void;
+
+    VkInstance instance_;
+    VkDevice device_;
+    VkAllocationCallbacks* allocator_;
+    std::vector<Entry> entries_;
+    uint64_t oldest_value_;
+};
@@ -0,0 +1,214 @@
+/*
+ * Copyright (C) 2025. Nyabsi <nyabsi@sovellus.cc>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "VulkanGpuTimer.h"
+
+#include "VulkanUtils.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+
+static constexpr uint32_t QUERIES_PER_SLOT = Vulkan_GpuSection_COUNT * 2;
+
+static constexpr const char* GPU_SECTION_NAMES[Vulkan_GpuSection_COUNT] =
+{
+    "Window pass",
+    "Overlay pass",
+    "Mirror pass",
+};
+
+VulkanGpuTimer::VulkanGpuTimer()
+{
+    device_ = VK_NULL_HANDLE;
+    allocator_ = nullptr;
+    query_pool_ = VK_NULL_HANDLE;
+    timestamp_period_ns_ = 0.0;
+    timestamp_mask_ = 0;
+    slot_next_ = 0;
+    slots_.clear();
+    results_.clear();
+    history_ = {};
+}
+
+auto VulkanGpuTimer::Initialize(VkDevice device, VkAllocationCallbacks* allocator, const VulkanDeviceCapabilities& capabilities, uint32_t queue_family, uint32_t slot_count) -> void
+{
+    VkResult vk_result = {};
+
+    device_ = device;
+    allocator_ = allocator;
+
+    const uint32_t valid_bits = capabilities.QueueFamilies()[queue_family].timestampValidBits;
+    if (valid_bits == 0 || capabilities.Limits().timestampPeriod <= 0.0f) {
+        printf("GPU timings are not supported by this queue\n");
+        return;
+    }
+
+    timestamp_period_ns_ = static_cast<double>(capabilities.Limits().timestampPeriod);
+    timestamp_mask_ = valid_bits >= 64 ? UINT64_MAX : (uint64_t(1) << valid_bits) - 1;
+
+    VkQueryPoolCreateInfo query_pool_create_info =
+    {
+        .sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO,
+        .queryType = VK_QUERY_TYPE_TIMESTAMP,
+        .queryCount = slot_count * QUERIES_PER_SLOT,
+    };
+
+    vk_result = vkCreateQueryPool(device_, &query_pool_create_info, allocator_, &query_pool_);
+    VK_VALIDATE_RESULT(vk_result);
+
+    if (vk_result != VK_SUCCESS) {
+        query_pool_ = VK_NULL_HANDLE;
+        return;
+    }
+
+    slots_.assign(slot_count, Slot{});
+    // one value and one availability word per query
+    results_.resize(QUERIES_PER_SLOT * 2);
+    slot_next_ = 0;
+}
+
+auto VulkanGpuTimer::Destroy() -> void
+{
+    if (query_pool_ != VK_NULL_HANDLE)
+        vkDestroyQueryPool(device_, query_pool_, allocator_);
+
+    query_pool_ = VK_NULL_HANDLE;
+    slots_.clear();
+}
+
+auto VulkanGpuTimer::BeginCommandBuffer(VkCommandBuffer command_buffer) -> uint32_t
+{
+    if (!this->Enabled())
+        return INVALID_SLOT;
+
+    const uint32_t slot = slot_next_;
+    if (slots_[slot].state != SlotState_Free)
+        return INVALID_SLOT;
+
+    slot_next_ = (slot_next_ + 1) % static_cast<uint32_t>(slots_.size());
+
+    slots_[slot] = { .state = SlotState_Recording, .written = 0, .submit_value = 0 };
+    vkCmdResetQueryPool(command_buffer, query_pool_, slot * QUERIES_PER_SLOT, QUERIES_PER_SLOT);
+
+    return slot;
+}
+
+auto VulkanGpuTimer::WriteBegin(uint32_t slot, VkCommandBuffer command_buffer, Vulkan_GpuSection section, VkPipelineStageFlagBits stage) -> void
+{
+    if (slot == INVALID_SLOT)
+        return;
+
+    vkCmdWriteTimestamp(command_buffer, stage, query_pool_, slot * QUERIES_PER_SLOT + section * 2);
+}
+
+auto VulkanGpuTimer::WriteEnd(uint32_t slot, VkCommandBuffer command_buffer, Vulkan_GpuSection section) -> void
+{
+    if (slot == INVALID_SLOT)
+        return;
+
+    vkCmdWriteTimestamp(command_buffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, query_pool_, slot * QUERIES_PER_SLOT + section * 2 + 1);
+    slots_[slot].written |= 1u << section;
+}
+
+auto VulkanGpuTimer::Submitted(uint32_t slot, uint64_t submit_value) -> void
+{
+    // Released slots may already belong to another command buffer
+    if (slot == INVALID_SLOT || slots_[slot].state != SlotState_Recording)
+        return;
+
+    slots_[slot].state = SlotState_Pending;
+    slots_[slot].submit_value = submit_value;
+}
+
+auto VulkanGpuTimer::Release(uint32_t slot) -> void
+{
+    if (slot == INVALID_SLOT)
+        return;
+
+    assert(slots_[slot].state == SlotState_Recording);
+    slots_[slot] = {};
+}
+
+auto VulkanGpuTimer::Collect(uint64_t completed_value) -> void
+{
+    if (!this->Enabled())
+        return;
+
+    for (uint32_t slot = 0; slot < static_cast<uint32_t>(slots_.size()); slot++) {
+        Slot& slot_data = slots_[slot];
+
+        if (slot_data.state != SlotState_Pending || slot_data.submit_value > completed_value)
+            continue;
+
+        // The submission already retired so the results are there, no VK_QUERY_RESULT_WAIT_BIT needed.
+        // Sections that were not recorded this time stay unavailable and make this return VK_NOT_READY.
+        VkResult vk_result = vkGetQueryPoolResults(device_, query_pool_, slot * QUERIES_PER_SLOT, QUERIES_PER_SLOT,
+            results_.size() * sizeof(uint64_t), results_.data(), sizeof(uint64_t) * 2,
+            VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+
+        if (vk_result != VK_SUCCESS && vk_result != VK_NOT_READY) {
+            VK_VALIDATE_RESULT(vk_result);
+        }
+
+        for (uint32_t section = 0; section < Vulkan_GpuSection_COUNT; section++) {
+            if (!(slot_data.written & (1u << section)))
+                continue;
+
+            const uint64_t* begin = &results_[(section * 2) * 2];
+            const uint64_t* end = &results_[(section * 2 + 1) * 2];
+
+            if (begin[1] == 0 || end[1] == 0)
+                continue;
+
+            const uint64_t ticks = ((end[0] & timestamp_mask_) - (begin[0] & timestamp_mask_)) & timestamp_mask_;
+            const float milliseconds = static_cast<float>(static_cast<double>(ticks) * timestamp_period_ns_ / 1000000.0);
+
+            History& history = history_[section];
+            history.samples[history.head] = milliseconds;
+            history.head = (history.head + 1) % SAMPLE_COUNT;
+            history.count = std::min(history.count + 1, SAMPLE_COUNT);
+        }
+
+        slot_data = {};
+    }
+}
+
+auto VulkanGpuTimer::Timings() const -> std::array<Vulkan_GpuTiming, Vulkan_GpuSection_COUNT>
+{
+    std::array<Vulkan_GpuTiming, Vulkan_GpuSection_COUNT> timings = {};
+    std::array<float, SAMPLE_COUNT> sorted = {};
+
+    for (uint32_t section = 0; section < Vulkan_GpuSection_COUNT; section++) {
+        const History& history = history_[section];
+        Vulkan_GpuTiming& timing = timings[section];
+
+        timing.name = GPU_SECTION_NAMES[section];
+        timing.samples = history.count;
+
+        if (history.count == 0)
+            continue;
+
+        std::copy_n(history.samples.begin(), history.count, sorted.begin());
+        std::sort(sorted.begin(), sorted.begin() + history.count);
+
+        double sum = {};
+        for (uint32_t i = 0; i < history.count; i++)
+            sum += sorted[i];
+
+        const uint32_t p99_index = static_cast<uint32_t>(std::ceil(history.count * 0.99)) - 1;
+
+        timing.min_ms = sorted[0];
+        timing.mean_ms = sum / history.count;
+        timing.p99_ms = sorted[std::min(p99_index, history.count - 1)];
+        timing.max_ms = sorted[history.count - 1];
+    }
+
+    return timings;
+}
@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2025. Nyabsi <nyabsi@sovellus.cc>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <array>
+#include <vector>
+
+#include <vulkan/vulkan.h>
+
+#include "VulkanCapabilities.h"
+
+enum Vulkan_GpuSection : uint32_t
+{
+    Vulkan_GpuSection_WindowPass = 0,
+    Vulkan_GpuSection_OverlayPass,
+    Vulkan_GpuSection_MirrorPass,
+    Vulkan_GpuSection_COUNT,
+};
+
+struct Vulkan_GpuTiming
+{
+    const char* name;
+    uint32_t samples;
+    double min_ms;
+    double mean_ms;
+    double p99_ms;
+    double max_ms;
+};
+
+// Timestamp queries around whole renderer passes, single barriers or copies are too short to time on their own.
+// Every recorded command buffer takes one slot of the query pool, slots are read back once the timeline shows their
+// submission retired so the CPU never waits on a query result. When every slot is still in flight the command buffer
+// simply goes untimed.
+class VulkanGpuTimer {
+public:
+    static constexpr uint32_t INVALID_SLOT = UINT32_MAX;
+    static constexpr uint32_t SAMPLE_COUNT = 240;
+
+    explicit VulkanGpuTimer();
+
+    auto Initialize(VkDevice device, VkAllocationCallbacks* allocator, const VulkanDeviceCapabilities& capabilities, uint32_t queue_family, uint32_t slot_count = 32) -> void;
+    auto Destroy() -> void;
+
+    [[nodiscard]] auto Enabled() const -> bool { return query_pool_ != VK_NULL_HANDLE; }
+
+    // Claims a slot for command_buffer and resets its queries, must be recorded outside of a render pass
+    auto BeginCommandBuffer(VkCommandBuffer command_buffer) -> uint32_t;
+    // stage is the first stage of the pass a semaphore wait holds back, so the time spent waiting for it is not counted
+    auto WriteBegin(uint32_t slot, VkCommandBuffer command_buffer, Vulkan_GpuSection section, VkPipelineStageFlagBits stage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT) -> void;
+    // Written once every command before it has finished
+    auto WriteEnd(uint32_t slot, VkCommandBuffer command_buffer, Vulkan_GpuSection section) -> void;
+    // Ties the slot to the timeline value signalled by the submission of its command buffer
+    auto Submitted(uint32_t slot, uint64_t submit_value) -> void;
+    // Hands back a slot whose command buffer will not run, every slot from BeginCommandBuffer ends in Submitted or here
+    auto Release(uint32_t slot) -> void;
+    // Reads back every slot whose submission is at or below completed_value
+    auto Collect(uint64_t completed_value) -> void;
+
+    [[nodiscard]] auto Timings() const -> std::array<Vulkan_GpuTiming, Vulkan_GpuSection_COUNT>;
+    // Drops the collected samples, queries still in flight are kept and land in the fresh history
+    auto ResetHistory() -> void { history_ = {}; }
+
+private:
+    enum SlotState : uint8_t
+    {
+        SlotState_Free = 0,
+        SlotState_Recording,
+        SlotState_Pending,
+    };
+
+    struct Slot
+    {
+        SlotState state;
+        uint32_t written; // bit per section with both timestamps recorded
+        uint64_t submit_value;
+    };
+
+    struct History
+    {
+        std::array<float, SAMPLE_COUNT> samples;
+        uint32_t head;
+        uint32_t count;
+    };
+
+    VkDevice device_;
+    VkAllocationCallbacks* allocator_;
+    VkQueryPool query_pool_;
+    double timestamp_period_ns_;
+    uint64_t timestamp_mask_;
+    uint32_t slot_next_;
+    std::vector<Slot> slots_;
+    std::vector<uint64_t> results_;
+    std::array<History, Vulkan_GpuSection_COUNT> history_;
+};
@@ -9,7 +9,10 @@
 #include "VulkanRenderer.h"
 
 #include "VulkanUtils.h"
+#include "ImDrawDataUtils.h"
+#include "Profiler.h"
 
+#include <cmath>
 #include <ranges>
 
 #include <imgui.h>
@@ -27,6 +30,9 @@ VulkanRenderer::VulkanRenderer()
     vulkan_queue_ = VK_NULL_HANDLE;
     vulkan_descriptor_pool_ = VK_NULL_HANDLE;
     vulkan_pipeline_cache_ = VK_NULL_HANDLE;
+    vulkan_timeline_semaphore_ = VK_NULL_HANDLE;
+    timeline_value_ = 0;
+    timeline_completed_value_ = 0;
     minimum_concurrent_image_count_ = 0;
     should_rebuild_swapchain_ = false;
     vulkan_instance_extensions_ = {};
@@ -38,10 +44,20 @@ VulkanRenderer::VulkanRenderer()
     should_enable_dynamic_rendering_ = false;
     f_vkCmdBeginRenderingKHR = nullptr;
     f_vkCmdEndRenderingKHR = nullptr;
+    f_vkWaitSemaphoresKHR = nullptr;
+    f_vkGetSemaphoreCounterValueKHR = nullptr;
     vulkan_overlay_ = std::make_unique<Vulkan_Overlay>();
+    overlay_batches_.clear();
+    overlay_batch_index_ = 0;
+    retired_swapchain_count_ = 0;
+    should_use_present_fences_ = false;
+    present_fences_.clear();
+    free_present_fences_.clear();
+    retired_swapchains_.clear();
+    stats_ = {};
 }
 
-auto VulkanRenderer::Initialize()  -> void
+auto VulkanRenderer::Initialize(const std::string& pipeline_cache_path)  -> void
 {
     VkResult vk_result = {};
 
@@ -53,6 +69,23 @@ auto VulkanRenderer::Initialize()  -> void
     };
 
     vulkan_instance_extensions_ = GetVulkanInstanceExtensionsRequiredByOpenVR();
+
+    bool has_surface_maintenance = false;
+
+#ifdef IMGUI_SDL_PLATFORM_BACKEND
+    // Needed by VK_EXT_swapchain_maintenance1, whose present fences say when a replaced swapchain can be destroyed
+    has_surface_maintenance = IsVulkanInstanceExtensionAvailable(VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME)
+        && IsVulkanInstanceExtensionAvailable(VK_KHR_GET_SURFACE_CAPABILITIES_2_EXTENSION_NAME)
+        && IsVulkanInstanceExtensionAvailable(VK_EXT_SURFACE_MAINTENANCE_1_EXTENSION_NAME);
+
+    if (has_surface_maintenance) {
+        for (const char* extension : { VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME, VK_KHR_GET_SURFACE_CAPABILITIES_2_EXTENSION_NAME, VK_EXT_SURFACE_MAINTENANCE_1_EXTENSION_NAME }) {
+            if (std::ranges::find(vulkan_instance_extensions_, extension) == vulkan_instance_extensions_.end())
+                vulkan_instance_extensions_.push_back(extension);
+        }
+    }
+#endif
+
     auto instance_extensions = get_instance_extensions(vulkan_instance_extensions_);
 
 #ifdef ENABLE_VULKAN_VALIDATION
@@ -133,21 +166,18 @@ auto VulkanRenderer::Initialize()  -> void
         }
     }
 
-    VkPhysicalDeviceProperties properties = {};
-    vkGetPhysicalDeviceProperties(vulkan_physical_device_, &properties);
+    // Software rasterizers such as lavapipe report VK_PHYSICAL_DEVICE_TYPE_CPU, only used when there is no GPU
+    if (vulkan_physical_device_ == VK_NULL_HANDLE && !device_list_.empty())
+        vulkan_physical_device_ = device_list_.front();
 
-    printf("Using device %s, Discrete: %s\n", properties.deviceName, properties.deviceType == VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU ? "Yes" : "No");
     assert(vulkan_physical_device_ != VK_NULL_HANDLE);
 
-    uint32_t family_prop_count = {};
-    vkGetPhysicalDeviceQueueFamilyProperties(vulkan_physical_device_, &family_prop_count, nullptr);
+    vulkan_capabilities_ = VulkanDeviceCapabilities::FromPhysicalDevice(vulkan_physical_device_);
+    const VkPhysicalDeviceProperties& properties = vulkan_capabilities_.Properties();
 
-    std::vector<VkQueueFamilyProperties> queues_properties = {};
-    queues_properties.resize(family_prop_count);
-
-    vkGetPhysicalDeviceQueueFamilyProperties(vulkan_physical_device_, &family_prop_count, queues_properties.data());
+    printf("Using device %s, Discrete: %s\n", properties.deviceName, properties.deviceType == VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU ? "Yes" : "No");
 
-    for (auto [idx, property] : std::views::enumerate(queues_properties))
+    for (auto [idx, property] : std::views::enumerate(vulkan_capabilities_.QueueFamilies()))
     {
         if (property.queueFlags & VK_QUEUE_GRAPHICS_BIT) {
             vulkan_queue_family_ = static_cast<uint32_t>(idx);
@@ -155,7 +185,6 @@ auto VulkanRenderer::Initialize()  -> void
         }
     }
 
-    queues_properties.clear();
     assert(vulkan_queue_family_ != (uint32_t)-1);
 
     auto get_device_extensions = [&](const std::vector<std::string>& extensions) -> std::vector<const char*> {
@@ -165,24 +194,47 @@ auto VulkanRenderer::Initialize()  -> void
         return result;
     };
 
-    vulkan_device_extensions_ = GetVulkanDeviceExtensionsRequiredByOpenVR(vulkan_physical_device_);
+    vulkan_device_extensions_ = GetVulkanDeviceExtensionsRequiredByOpenVR(vulkan_capabilities_);
 
 #ifdef IMGUI_SDL_PLATFORM_BACKEND
-    if (!IsVulkanDeviceExtensionAvailable(vulkan_physical_device_, VK_KHR_SWAPCHAIN_EXTENSION_NAME))
+    if (!IsVulkanDeviceExtensionAvailable(vulkan_capabilities_, VK_KHR_SWAPCHAIN_EXTENSION_NAME))
         std::exit(EXIT_FAILURE);
 
     vulkan_device_extensions_.push_back(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
+
+    should_use_present_fences_ = has_surface_maintenance && IsVulkanDeviceExtensionAvailable(vulkan_capabilities_, VK_EXT_SWAPCHAIN_MAINTENANCE_1_EXTENSION_NAME);
+
+    if (should_use_present_fences_) {
+        VkPhysicalDeviceSwapchainMaintenance1FeaturesEXT supported_swapchain_maintenance_features =
+        {
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SWAPCHAIN_MAINTENANCE_1_FEATURES_EXT,
+        };
+
+        VkPhysicalDeviceFeatures2KHR supported_features =
+        {
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2_KHR,
+            .pNext = &supported_swapchain_maintenance_features,
+        };
+
+        auto f_vkGetPhysicalDeviceFeatures2KHR = (PFN_vkGetPhysicalDeviceFeatures2KHR)vkGetInstanceProcAddr(vulkan_instance_, "vkGetPhysicalDeviceFeatures2KHR");
+        f_vkGetPhysicalDeviceFeatures2KHR(vulkan_physical_device_, &supported_features);
+
+        should_use_present_fences_ = supported_swapchain_maintenance_features.swapchainMaintenance1;
+    }
+
+    if (should_use_present_fences_)
+        vulkan_device_extensions_.push_back(VK_EXT_SWAPCHAIN_MAINTENANCE_1_EXTENSION_NAME);
 #endif
 
     should_enable_dynamic_rendering_ = true;
 
-    if (!IsVulkanDeviceExtensionAvailable(vulkan_physical_device_, VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME))
+    if (!IsVulkanDeviceExtensionAvailable(vulkan_capabilities_, VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME))
         should_enable_dynamic_rendering_ = false;
 
-    if (!IsVulkanDeviceExtensionAvailable(vulkan_physical_device_, VK_KHR_DEPTH_STENCIL_RESOLVE_EXTENSION_NAME))
+    if (!IsVulkanDeviceExtensionAvailable(vulkan_capabilities_, VK_KHR_DEPTH_STENCIL_RESOLVE_EXTENSION_NAME))
         should_enable_dynamic_rendering_ = false;
 
-    if (!IsVulkanDeviceExtensionAvailable(vulkan_physical_device_, VK_KHR_CREATE_RENDERPASS_2_EXTENSION_NAME))
+    if (!IsVulkanDeviceExtensionAvailable(vulkan_capabilities_, VK_KHR_CREATE_RENDERPASS_2_EXTENSION_NAME))
         should_enable_dynamic_rendering_ = false;
 
     if (!should_enable_dynamic_rendering_)
@@ -194,6 +246,11 @@ auto VulkanRenderer::Initialize()  -> void
         VK_KHR_CREATE_RENDERPASS_2_EXTENSION_NAME 
     });
 
+    if (!IsVulkanDeviceExtensionAvailable(vulkan_capabilities_, VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME))
+        std::exit(EXIT_FAILURE);
+
+    vulkan_device_extensions_.push_back(VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME);
+
     auto device_extensions = get_device_extensions(vulkan_device_extensions_);
 
     constexpr float queue_priority = 1.0f;
@@ -205,16 +262,30 @@ auto VulkanRenderer::Initialize()  -> void
         .pQueuePriorities = &queue_priority
     };
 
+    VkPhysicalDeviceTimelineSemaphoreFeaturesKHR timeline_semaphore_features =
+    {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES_KHR,
+        .timelineSemaphore = true,
+    };
+
     VkPhysicalDeviceDynamicRenderingFeaturesKHR dynamic_rendering_features =
     {
         .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES_KHR,
+        .pNext = &timeline_semaphore_features,
         .dynamicRendering = true,
     };
 
+    VkPhysicalDeviceSwapchainMaintenance1FeaturesEXT swapchain_maintenance_features =
+    {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SWAPCHAIN_MAINTENANCE_1_FEATURES_EXT,
+        .pNext = &dynamic_rendering_features,
+        .swapchainMaintenance1 = true,
+    };
+
     VkDeviceCreateInfo device_create_info = 
     {
         .sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO,
-        .pNext = &dynamic_rendering_features,
+        .pNext = should_use_present_fences_ ? (void*)&swapchain_maintenance_features : (void*)&dynamic_rendering_features,
         .queueCreateInfoCount = 1,
         .pQueueCreateInfos = &device_queue_info,
         .enabledExtensionCount = (uint32_t)device_extensions.size(),
@@ -226,6 +297,37 @@ auto VulkanRenderer::Initialize()  -> void
 
     vkGetDeviceQueue(vulkan_device_, vulkan_queue_family_, 0, &vulkan_queue_);
 
+    // Seed the pipeline cache from the previous run so ImGui does not compile its pipelines from scratch on every launch.
+    pipeline_cache_path_ = pipeline_cache_path;
+
+    std::vector<uint8_t> pipeline_cache_data = {};
+    if (!pipeline_cache_path_.empty())
+        pipeline_cache_data = ReadVulkanPipelineCache(pipeline_cache_path_, properties);
+
+    VkPipelineCacheCreateInfo pipeline_cache_create_info =
+    {
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO,
+        .initialDataSize = pipeline_cache_data.size(),
+        .pInitialData = pipeline_cache_data.empty() ? nullptr : pipeline_cache_data.data(),
+    };
+
+    vk_result = vkCreatePipelineCache(vulkan_device_, &pipeline_cache_create_info, vulkan_allocator_, &vulkan_pipeline_cache_);
+    if (vk_result != VK_SUCCESS && !pipeline_cache_data.empty()) {
+        // the blob passed our header checks but the driver still refused it, start from an empty cache
+        pipeline_cache_create_info.initialDataSize = 0;
+        pipeline_cache_create_info.pInitialData = nullptr;
+        vk_result = vkCreatePipelineCache(vulkan_device_, &pipeline_cache_create_info, vulkan_allocator_, &vulkan_pipeline_cache_);
+    }
+    VK_VALIDATE_RESULT(vk_result);
+
+    printf("Pipeline cache: %s (%zu bytes)\n", pipeline_cache_data.empty() ? "empty" : "loaded", pipeline_cache_data.size());
+
+#ifdef ENABLE_GPU_TIMINGS
+    gpu_timer_.Initialize(vulkan_device_, vulkan_allocator_, vulkan_capabilities_, vulkan_queue_family_);
+#endif
+
+    deletion_queue_.Initialize(vulkan_instance_, vulkan_device_, vulkan_allocator_);
+
     VkDescriptorPoolSize pool_sizes[] = {
         {
             VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 
@@ -253,6 +355,30 @@ auto VulkanRenderer::Initialize()  -> void
     assert(f_vkCmdBeginRenderingKHR != nullptr);
     this->f_vkCmdEndRenderingKHR = (PFN_vkCmdEndRenderingKHR)vkGetInstanceProcAddr(vulkan_instance_, "vkCmdEndRenderingKHR");
     assert(f_vkCmdEndRenderingKHR != nullptr);
+    this->f_vkWaitSemaphoresKHR = (PFN_vkWaitSemaphoresKHR)vkGetInstanceProcAddr(vulkan_instance_, "vkWaitSemaphoresKHR");
+    assert(f_vkWaitSemaphoresKHR != nullptr);
+    this->f_vkGetSemaphoreCounterValueKHR = (PFN_vkGetSemaphoreCounterValueKHR)vkGetInstanceProcAddr(vulkan_instance_, "vkGetSemaphoreCounterValueKHR");
+    assert(f_vkGetSemaphoreCounterValueKHR != nullptr);
+
+    // The window and the overlay share the one queue, so a single timeline orders all of their work.
+    VkSemaphoreTypeCreateInfoKHR semaphore_type_create_info =
+    {
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO_KHR,
+        .semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE_KHR,
+        .initialValue = 0,
+    };
+
+    VkSemaphoreCreateInfo timeline_semaphore_create_info =
+    {
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO,
+        .pNext = &semaphore_type_create_info,
+    };
+
+    vk_result = vkCreateSemaphore(vulkan_device_, &timeline_semaphore_create_info, vulkan_allocator_, &vulkan_timeline_semaphore_);
+    VK_VALIDATE_RESULT(vk_result);
+
+    timeline_value_ = 0;
+    timeline_completed_value_ = 0;
 }
 
 auto VulkanRenderer::SetupWindow(Vulkan_Window* window, VkSurfaceKHR surface, uint32_t width, uint32_t height)  -> void
@@ -328,174 +454,124 @@ auto VulkanRenderer::SetupWindow(Vulkan_Window* window, VkSurfaceKHR surface, ui
     window->present_mode = present_mode;
     window->clear_enable = true;
 
+    // The overlay texture uses the surface format, mirroring it into the window is a blit between two images of that format.
+    VkFormatProperties format_properties = {};
+    vkGetPhysicalDeviceFormatProperties(vulkan_physical_device_, surface_format.format, &format_properties);
+
+    const VkFormatFeatureFlags blit_features = VK_FORMAT_FEATURE_BLIT_SRC_BIT | VK_FORMAT_FEATURE_BLIT_DST_BIT;
+    window->mirror_overlay = (format_properties.optimalTilingFeatures & blit_features) == blit_features;
+
 #ifdef IMGUI_SDL_PLATFORM_BACKEND
     this->SetupSwapchain(window, width, height);
 #endif
 }
 
-auto VulkanRenderer::SetupOverlay(uint32_t width, uint32_t height, VkSurfaceFormatKHR format) -> void
+auto VulkanRenderer::SetupOverlay(uint32_t width, uint32_t height, VkSurfaceFormatKHR format, uint32_t frame_count) -> void
 {
-    VkResult vk_result = {};
-
-    vulkan_overlay_->width = width;
-    vulkan_overlay_->height = height;
-    vulkan_overlay_->texture_format = format;
-    vulkan_overlay_->clear_enable = true;
-
-    VkCommandPoolCreateInfo command_pool_create_info =
-    {
-        .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
-        .flags = 0,
-        .queueFamilyIndex = vulkan_queue_family_,
-    };
-
-    vk_result = vkCreateCommandPool(vulkan_device_, &command_pool_create_info, vulkan_allocator_, &vulkan_overlay_->command_pool);
-    VK_VALIDATE_RESULT(vk_result);
-
-    VkCommandBufferAllocateInfo command_buffer_allocate_info = {
-        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
-        .commandPool = vulkan_overlay_->command_pool,
-        .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
-        .commandBufferCount = 1,
-    };
-
-    vk_result = vkAllocateCommandBuffers(vulkan_device_, &command_buffer_allocate_info, &vulkan_overlay_->command_buffer);
-    VK_VALIDATE_RESULT(vk_result);
-
-    VkFenceCreateInfo fence_create_info =
-    {
-        .sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO,
-        .flags = VK_FENCE_CREATE_SIGNALED_BIT,
-    };
-
-    vk_result = vkCreateFence(vulkan_device_, &fence_create_info, vulkan_allocator_, &vulkan_overlay_->fence);
-    VK_VALIDATE_RESULT(vk_result);
-
-    vk_result = vkWaitForFences(vulkan_device_, 1, &vulkan_overlay_->fence, VK_TRUE, UINT64_MAX);
-    VK_VALIDATE_RESULT(vk_result);
-
-    vk_result = vkResetFences(vulkan_device_, 1, &vulkan_overlay_->fence);
-    VK_VALIDATE_RESULT(vk_result);
+    this->SetupOverlay(vulkan_overlay_.get(), width, height, format, frame_count);
+}
 
-    vkGetDeviceQueue(vulkan_device_, vulkan_queue_family_, 0, &vulkan_overlay_->queue);
+auto VulkanRenderer::SetupOverlay(Vulkan_Overlay* vulkan_overlay, uint32_t width, uint32_t height, VkSurfaceFormatKHR format, uint32_t frame_count) -> void
+{
+    VkResult vk_result = {};
 
-    VkCommandBufferBeginInfo begin_info =
-    {
-        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
-        .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT
-    };
+    assert(frame_count > 0);
 
-    vk_result = vkBeginCommandBuffer(vulkan_overlay_->command_buffer, &begin_info);
-    VK_VALIDATE_RESULT(vk_result);
+    // Setting up again resizes the overlay, the old ring goes to the deletion queue while its frames finish
+    if (!vulkan_overlay->frames.empty())
+        this->DestroyOverlay(vulkan_overlay);
 
-    VkImageCreateInfo image_create_info =
-    {
-        .sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
-        .imageType = VK_IMAGE_TYPE_2D,
-        .format = vulkan_overlay_->texture_format.format,
-        .extent =
-        {
-            .width = vulkan_overlay_->width,
-            .height = vulkan_overlay_->height,
-            .depth = 1,
-        },
-        .mipLevels = 1,
-        .arrayLayers = 1,
-        .samples = VK_SAMPLE_COUNT_1_BIT,
-        .tiling = VK_IMAGE_TILING_OPTIMAL,
-        .usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
-        .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED
-    };
+    vulkan_overlay->width = width;
+    vulkan_overlay->height = height;
+    vulkan_overlay->texture_format = format;
+    vulkan_overlay->clear_enable = true;
+    vulkan_overlay->frame_index = 0;
+    vulkan_overlay->frame_count = frame_count;
+    vulkan_overlay->frames.assign(frame_count, Vulkan_OverlayFrame{});
+    vulkan_overlay->presented_hash = 0;
+    vulkan_overlay->presented_frame = UINT32_MAX;
+    vulkan_overlay->damage_tracking_enable = true;
 
-    vk_result = vkCreateImage(vulkan_device_, &image_create_info, nullptr, &vulkan_overlay_->texture);
-    VK_VALIDATE_RESULT(vk_result);
+    vkGetDeviceQueue(vulkan_device_, vulkan_queue_family_, 0, &vulkan_overlay->queue);
 
     auto find_memory_type_index = [&](uint32_t type, VkMemoryPropertyFlags properties) -> uint32_t {
-        VkPhysicalDeviceMemoryProperties memory_requirements = {};
-        vkGetPhysicalDeviceMemoryProperties(vulkan_physical_device_, &memory_requirements);
-
-        for (uint32_t i = 0; i < memory_requirements.memoryTypeCount; i++) {
-            if ((type & (1 << i)) && (memory_requirements.memoryTypes[i].propertyFlags & properties) == properties) {
-                return i;
-            }
-        }
+        if (auto index = vulkan_capabilities_.FindMemoryType(type, properties))
+            return *index;
         throw std::runtime_error("Failed to find suitable memory type!");
     };
 
-    VkMemoryRequirements memory_requirements = {};
-    vkGetImageMemoryRequirements(vulkan_device_, vulkan_overlay_->texture, &memory_requirements);
-
-    VkMemoryAllocateInfo memory_alloc_info =
-    {
-        .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
-        .allocationSize = memory_requirements.size,
-        .memoryTypeIndex = find_memory_type_index(memory_requirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT),
-    };
-
-    vk_result = vkAllocateMemory(vulkan_device_, &memory_alloc_info, nullptr, &vulkan_overlay_->texture_memory);
-    VK_VALIDATE_RESULT(vk_result);
+    // Every frame in the ring owns its texture so frame N+1 can be rendered while frame N is still
+    // being copied by the compositor. Command buffers are shared by all overlays, see RenderOverlays.
+    for (uint32_t idx = 0; idx < vulkan_overlay->frame_count; idx++) {
+        Vulkan_OverlayFrame* fd = &vulkan_overlay->frames[idx];
 
-    vk_result = vkBindImageMemory(vulkan_device_, vulkan_overlay_->texture, vulkan_overlay_->texture_memory, 0);
-    VK_VALIDATE_RESULT(vk_result);
+        fd->submit_value = 0;
 
+        VkImageCreateInfo image_create_info =
+        {
+            .sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
+            .imageType = VK_IMAGE_TYPE_2D,
+            .format = vulkan_overlay->texture_format.format,
+            .extent =
+            {
+                .width = vulkan_overlay->width,
+                .height = vulkan_overlay->height,
+                .depth = 1,
+            },
+            .mipLevels = 1,
+            .arrayLayers = 1,
+            .samples = VK_SAMPLE_COUNT_1_BIT,
+            .tiling = VK_IMAGE_TILING_OPTIMAL,
+            .usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+            .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED
+        };
 
-    VkImageViewCreateInfo image_view_info =
-    {
-        .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
-        .image = vulkan_overlay_->texture,
-        .viewType = VK_IMAGE_VIEW_TYPE_2D,
-        .format = vulkan_overlay_->texture_format.format,
-        .components = {
-            .r = VK_COMPONENT_SWIZZLE_R,
-            .g = VK_COMPONENT_SWIZZLE_G,
-            .b = VK_COMPONENT_SWIZZLE_B,
-            .a = VK_COMPONENT_SWIZZLE_A,
-        },
-        .subresourceRange = {
-            .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
-            .baseMipLevel = 0,
-            .levelCount = 1,
-            .baseArrayLayer = 0,
-            .layerCount = 1,
-        },
-    };
+        vk_result = vkCreateImage(vulkan_device_, &image_create_info, nullptr, &fd->texture);
+        VK_VALIDATE_RESULT(vk_result);
 
-    vk_result = vkCreateImageView(vulkan_device_, &image_view_info, vulkan_allocator_, &vulkan_overlay_->texture_view);
-    VK_VALIDATE_RESULT(vk_result);
+        VkMemoryRequirements memory_requirements = {};
+        vkGetImageMemoryRequirements(vulkan_device_, fd->texture, &memory_requirements);
 
-    VkImageMemoryBarrier barrier =
-    {
-        .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
-        .srcAccessMask = 0,
-        .dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
-        .oldLayout = VK_IMAGE_LAYOUT_UNDEFINED,
-        .newLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
-        .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-        .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-        .image = vulkan_overlay_->texture,
-        .subresourceRange =
+        VkMemoryAllocateInfo memory_alloc_info =
         {
-            .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
-            .baseMipLevel = 0,
-            .levelCount = 1,
-            .baseArrayLayer = 0,
-            .layerCount = 1,
-        },
-    };
+            .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+            .allocationSize = memory_requirements.size,
+            .memoryTypeIndex = find_memory_type_index(memory_requirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT),
+        };
 
-    vkCmdPipelineBarrier(vulkan_overlay_->command_buffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+        vk_result = vkAllocateMemory(vulkan_device_, &memory_alloc_info, nullptr, &fd->texture_memory);
+        VK_VALIDATE_RESULT(vk_result);
 
-    vk_result = vkEndCommandBuffer(vulkan_overlay_->command_buffer);
-    VK_VALIDATE_RESULT(vk_result);
+        vk_result = vkBindImageMemory(vulkan_device_, fd->texture, fd->texture_memory, 0);
+        VK_VALIDATE_RESULT(vk_result);
 
-    VkSubmitInfo submit_info = {
-        .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
-        .commandBufferCount = 1,
-        .pCommandBuffers = &vulkan_overlay_->command_buffer,
-    };
+        VkImageViewCreateInfo image_view_info =
+        {
+            .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
+            .image = fd->texture,
+            .viewType = VK_IMAGE_VIEW_TYPE_2D,
+            .format = vulkan_overlay->texture_format.format,
+            .components = {
+                .r = VK_COMPONENT_SWIZZLE_R,
+                .g = VK_COMPONENT_SWIZZLE_G,
+                .b = VK_COMPONENT_SWIZZLE_B,
+                .a = VK_COMPONENT_SWIZZLE_A,
+            },
+            .subresourceRange = {
+                .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                .baseMipLevel = 0,
+                .levelCount = 1,
+                .baseArrayLayer = 0,
+                .layerCount = 1,
+            },
+        };
 
-    vk_result = vkQueueSubmit(vulkan_overlay_->queue, 1, &submit_info, vulkan_overlay_->fence);
-    VK_VALIDATE_RESULT(vk_result);
+        vk_result = vkCreateImageView(vulkan_device_, &image_view_info, vulkan_allocator_, &fd->texture_view);
+        VK_VALIDATE_RESULT(vk_result);
+
+        // The first RenderOverlay on this frame transitions the image out of UNDEFINED.
+        fd->texture_layout = VK_IMAGE_LAYOUT_UNDEFINED;
+    }
 }
 
 auto VulkanRenderer::SetupSwapchain(Vulkan_Window* window, uint32_t width, uint32_t height) -> void
@@ -503,21 +579,24 @@ auto VulkanRenderer::SetupSwapchain(Vulkan_Window* window, uint32_t width, uint3
     VkResult vk_result = {};
     VkSwapchainKHR old_swapchain = window->swapchain;
 
-    vk_result = vkQueueWaitIdle(vulkan_queue_);
-    VK_VALIDATE_RESULT(vk_result);
+    PROFILE_SCOPE("SetupSwapchain");
 
-    vk_result = vkDeviceWaitIdle(vulkan_device_);
-    VK_VALIDATE_RESULT(vk_result);
+    // Frames of the old swapchain may still be in flight, and so may the overlay sharing the queue. Nothing waits
+    // for them here, the old objects are handed to the deletion queue once the new swapchain's first submission is known.
+    VkRenderPass old_render_pass = window->render_pass;
+    VkPipeline old_pipeline = window->pipeline;
+    std::vector<Vulkan_Frame> old_frames = std::move(window->frames);
+    std::vector<Vulkan_FrameSemaphore> old_semaphores = std::move(window->semaphores);
 
     window->swapchain = VK_NULL_HANDLE;
-
-    this->DestroyFrames(window);
+    window->render_pass = VK_NULL_HANDLE;
+    window->pipeline = VK_NULL_HANDLE;
+    window->frames = {};
+    window->semaphores = {};
     window->image_count = 0;
-
-    if (window->render_pass)
-        vkDestroyRenderPass(vulkan_device_, window->render_pass, vulkan_allocator_);
-    if (window->pipeline)
-        vkDestroyPipeline(vulkan_device_, window->pipeline, vulkan_allocator_);
+    window->semaphore_count = 0;
+    window->frame_index = 0;
+    window->semaphore_index = 0;
 
     VkSurfaceCapabilitiesKHR surface_capabilities = {};
     vk_result = vkGetPhysicalDeviceSurfaceCapabilitiesKHR(vulkan_physical_device_, window->surface, &surface_capabilities);
@@ -561,6 +640,13 @@ auto VulkanRenderer::SetupSwapchain(Vulkan_Window* window, uint32_t width, uint3
         window->height = surface_capabilities.currentExtent.height;
     }
 
+    VkImageUsageFlags image_usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+
+    if (surface_capabilities.supportedUsageFlags & VK_IMAGE_USAGE_TRANSFER_DST_BIT)
+        image_usage |= VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+    else
+        window->mirror_overlay = false;
+
     VkSurfaceTransformFlagBitsKHR surface_transform_flags =
         surface_capabilities.supportedTransforms & VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR ?
         VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR : surface_capabilities.currentTransform;
@@ -578,7 +664,7 @@ auto VulkanRenderer::SetupSwapchain(Vulkan_Window* window, uint32_t width, uint3
             .height = window->height
         },
         .imageArrayLayers = 1,
-        .imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+        .imageUsage = image_usage,
         .imageSharingMode = VK_SHARING_MODE_EXCLUSIVE,
         .preTransform = surface_transform_flags,
         .compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR,
@@ -608,8 +694,8 @@ auto VulkanRenderer::SetupSwapchain(Vulkan_Window* window, uint32_t width, uint3
     memset(window->semaphores.data(), 0x0, window->semaphores.size() * sizeof(Vulkan_FrameSemaphore));
     memset(window->frames.data(), 0x0, window->frames.size() * sizeof(Vulkan_Frame));
 
-    if (old_swapchain)
-        vkDestroySwapchainKHR(vulkan_device_, old_swapchain, vulkan_allocator_);
+    std::vector<VkCommandBuffer> layout_command_buffers = {};
+    layout_command_buffers.reserve(window->image_count);
 
     for (uint32_t idx = 0; idx < window->semaphore_count; idx++) {
         Vulkan_FrameSemaphore* fsd = &window->semaphores[idx];
@@ -673,15 +759,6 @@ auto VulkanRenderer::SetupSwapchain(Vulkan_Window* window, uint32_t width, uint3
         vk_result = vkAllocateCommandBuffers(vulkan_device_, &command_buffer_allocate_info, &fd->command_buffer);
         VK_VALIDATE_RESULT(vk_result);
 
-        VkFenceCreateInfo fence_create_info =
-        {
-            .sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO,
-            .flags = VK_FENCE_CREATE_SIGNALED_BIT,
-        };
-
-        vk_result = vkCreateFence(vulkan_device_, &fence_create_info, vulkan_allocator_, &fd->fence);
-        VK_VALIDATE_RESULT(vk_result);
-
         VkCommandBufferBeginInfo begin_info =
         {
             .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
@@ -716,36 +793,53 @@ auto VulkanRenderer::SetupSwapchain(Vulkan_Window* window, uint32_t width, uint3
         vk_result = vkEndCommandBuffer(fd->command_buffer);
         VK_VALIDATE_RESULT(vk_result);
 
-        VkSubmitInfo submit_info = {
-            .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
-            .commandBufferCount = 1,
-            .pCommandBuffers = &fd->command_buffer,
-        };
+        layout_command_buffers.push_back(fd->command_buffer);
+    }
 
-        vk_result = vkWaitForFences(vulkan_device_, 1, &fd->fence, VK_TRUE, UINT64_MAX);
-        VK_VALIDATE_RESULT(vk_result);
+    // All initial layout transitions go out in one submission, each frame waits for its value before reusing its command buffer.
+    VkSubmitInfo submit_info = {
+        .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+        .commandBufferCount = (uint32_t)layout_command_buffers.size(),
+        .pCommandBuffers = layout_command_buffers.data(),
+    };
 
-        vk_result = vkResetFences(vulkan_device_, 1, &fd->fence);
-        VK_VALIDATE_RESULT(vk_result);
+    const uint64_t submit_value = this->SubmitTimeline(vulkan_queue_, submit_info);
 
-        vk_result = vkQueueSubmit(vulkan_queue_, 1, &submit_info, fd->fence);
-        VK_VALIDATE_RESULT(vk_result);
-    }
+    for (uint32_t idx = 0; idx < window->image_count; idx++)
+        window->frames[idx].submit_value = submit_value;
+
+    // Submissions of the old swapchain were queued before this one, once it completed they are done with its
+    // frames. Its presents may not be, the swapchain and its semaphores go once their present fences signalled.
+    // Without VK_EXT_swapchain_maintenance1 only an idle queue tells, resizing retires a swapchain per frame and
+    // every few of them the queue is idled here.
+    this->DestroyFrames(old_frames, old_semaphores, old_swapchain, submit_value);
+    deletion_queue_.Defer(submit_value, old_pipeline);
+    deletion_queue_.Defer(submit_value, old_render_pass);
+
+    if (retired_swapchain_count_ >= MAX_RETIRED_SWAPCHAINS)
+        this->IdleQueue();
 
     should_rebuild_swapchain_ = false;
 }
 
 auto VulkanRenderer::RenderWindow(ImDrawData* draw_data, Vulkan_Window* window) -> void
 {
+    PROFILE_SCOPE("RenderWindow");
+
     if (window->is_minimized)
         return;
 
+    this->CollectDeletions();
+
     VkResult vk_result = {};
 
     VkSemaphore image_acquired_semaphore = window->semaphores[window->semaphore_index].image_acquired_semaphore;
     VkSemaphore render_complete_semaphore = window->semaphores[window->semaphore_index].render_complete_semaphore;
 
-    vk_result = vkAcquireNextImageKHR(vulkan_device_, window->swapchain, UINT64_MAX, image_acquired_semaphore, VK_NULL_HANDLE, &window->frame_index);
+    {
+        PROFILE_SCOPE("vkAcquireNextImageKHR");
+        vk_result = vkAcquireNextImageKHR(vulkan_device_, window->swapchain, UINT64_MAX, image_acquired_semaphore, VK_NULL_HANDLE, &window->frame_index);
+    }
     if (vk_result == VK_ERROR_OUT_OF_DATE_KHR || vk_result == VK_SUBOPTIMAL_KHR)
         should_rebuild_swapchain_ = true;
     if (vk_result == VK_ERROR_OUT_OF_DATE_KHR)
@@ -803,11 +897,11 @@ auto VulkanRenderer::RenderWindow(ImDrawData* draw_data, Vulkan_Window* window)
         .pStencilAttachment = nullptr,
     };
 
-    vk_result = vkWaitForFences(vulkan_device_, 1, &fd->fence, VK_TRUE, UINT64_MAX);
-    VK_VALIDATE_RESULT(vk_result);
-
-    vk_result = vkResetFences(vulkan_device_, 1, &fd->fence);
-    VK_VALIDATE_RESULT(vk_result);
+    this->WaitTimeline(fd->submit_value);
+    {
+        std::lock_guard<std::mutex> stats_lock(stats_mutex_);
+        gpu_timer_.Collect(timeline_completed_value_);
+    }
 
     vk_result = vkResetCommandPool(vulkan_device_, fd->command_pool, 0);
     VK_VALIDATE_RESULT(vk_result);
@@ -815,12 +909,23 @@ auto VulkanRenderer::RenderWindow(ImDrawData* draw_data, Vulkan_Window* window)
     vk_result = vkBeginCommandBuffer(fd->command_buffer, &buffer_begin_info);
     VK_VALIDATE_RESULT(vk_result);
 
+    const uint32_t timer_slot = gpu_timer_.BeginCommandBuffer(fd->command_buffer);
+
+    // The pass starts once the swapchain image is acquired, the submission waits for it at this stage
+    gpu_timer_.WriteBegin(timer_slot, fd->command_buffer, Vulkan_GpuSection_WindowPass, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT);
     f_vkCmdBeginRenderingKHR(fd->command_buffer, &rendering_info);
     ImGui_ImplVulkan_RenderDrawData(draw_data, fd->command_buffer);
     f_vkCmdEndRenderingKHR(fd->command_buffer);
+    gpu_timer_.WriteEnd(timer_slot, fd->command_buffer, Vulkan_GpuSection_WindowPass);
 
     vk_result = vkEndCommandBuffer(fd->command_buffer);
     VK_VALIDATE_RESULT(vk_result);
+    if (vk_result != VK_SUCCESS) {
+        // Nothing waits on the acquired image's semaphore now, a new swapchain replaces it and Present skips the frame
+        gpu_timer_.Release(timer_slot);
+        should_rebuild_swapchain_ = true;
+        return;
+    }
 
     VkPipelineStageFlags wait_stage_mask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
 
@@ -835,88 +940,217 @@ auto VulkanRenderer::RenderWindow(ImDrawData* draw_data, Vulkan_Window* window)
         .pSignalSemaphores = &render_complete_semaphore,
     };
 
-    vk_result = vkQueueSubmit(vulkan_queue_, 1, &submit_info, fd->fence);
-    VK_VALIDATE_RESULT(vk_result);
+    fd->submit_value = this->SubmitTimeline(vulkan_queue_, submit_info);
+    gpu_timer_.Submitted(timer_slot, fd->submit_value);
 }
 
 auto VulkanRenderer::RenderOverlay(ImDrawData* draw_data, VrOverlay*& overlay) -> void
 {
-    if (!overlay->IsVisible())
+    const Vulkan_OverlayDraw draw =
+    {
+        .draw_data = draw_data,
+        .vulkan_overlay = vulkan_overlay_.get(),
+        .overlay = overlay,
+    };
+
+    this->RenderOverlays(std::span<const Vulkan_OverlayDraw>(&draw, 1));
+}
+
+auto VulkanRenderer::RenderOverlays(std::span<const Vulkan_OverlayDraw> draws) -> void
+{
+    PROFILE_SCOPE("RenderOverlays");
+
+    assert(draws.size() <= MAX_BATCHED_OVERLAYS);
+
+    this->CollectDeletions();
+
+    // The compositor keeps showing the last texture we gave it, when nothing would change
+    // there is no reason to render the frame again nor send it through OpenVR.
+    overlay_pending_.clear();
+    uint64_t frames_skipped = 0;
+
+    for (const Vulkan_OverlayDraw& draw : draws) {
+        if (draw.draw_data == nullptr || draw.vulkan_overlay->frames.empty() || !draw.overlay->IsVisible())
+            continue;
+
+        const uint64_t draw_data_hash = ImDrawDataHasPendingTextures(draw.draw_data) ? 0 : HashImDrawData(draw.draw_data);
+        if (draw_data_hash != 0 && draw_data_hash == draw.vulkan_overlay->presented_hash) {
+            frames_skipped++;
+            continue;
+        }
+
+        overlay_pending_.push_back({
+            .draw = &draw,
+            .frame = &draw.vulkan_overlay->frames[draw.vulkan_overlay->frame_index],
+            .draw_data_hash = draw_data_hash,
+            .partial_redraw = false,
+        });
+    }
+
+    if (frames_skipped > 0) {
+        std::lock_guard<std::mutex> stats_lock(stats_mutex_);
+        stats_.overlay_frames_skipped += frames_skipped;
+    }
+
+    if (overlay_pending_.empty())
         return;
 
+    if (overlay_batches_.empty())
+        this->SetupOverlayBatches();
+
     VkResult vk_result = {};
 
-    const ImVec4 background_color = ImVec4(0.45f, 0.55f, 0.60f, 1.00f);
-    /// NOTE: suboptimal
-    vulkan_overlay_->clear_value.color.float32[0] = background_color.x * background_color.w;
-    vulkan_overlay_->clear_value.color.float32[1] = background_color.y * background_color.w;
-    vulkan_overlay_->clear_value.color.float32[2] = background_color.z * background_color.w;
-    vulkan_overlay_->clear_value.color.float32[3] = background_color.w;
+    Vulkan_OverlayBatch* batch = &overlay_batches_[overlay_batch_index_];
 
     VkCommandBufferBeginInfo buffer_begin_info =
     {
         .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
-        .flags = VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT,
+        .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
     };
 
-    VkRenderingAttachmentInfoKHR color_attachment =
-    {
-        .sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO_KHR,
-        .imageView = vulkan_overlay_->texture_view,
-        .imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
-        .resolveMode = VK_RESOLVE_MODE_NONE_KHR,
-        .resolveImageView = VK_NULL_HANDLE,
-        .resolveImageLayout = VK_IMAGE_LAYOUT_UNDEFINED,
-        .loadOp = vulkan_overlay_->clear_enable ? VK_ATTACHMENT_LOAD_OP_CLEAR : VK_ATTACHMENT_LOAD_OP_DONT_CARE,
-        .storeOp = VK_ATTACHMENT_STORE_OP_STORE,
-        .clearValue = vulkan_overlay_->clear_value,
-    };
+    // The batch and every texture about to be drawn into were last submitted a few frames ago, in the
+    // common case the GPU has long passed those values and none of this blocks. Values are ordered, so
+    // this is one compare per overlay.
+    this->WaitTimeline(batch->submit_value);
+    for (const Vulkan_OverlayPending& pending : overlay_pending_)
+        this->WaitTimeline(pending.frame->submit_value);
 
-    VkRenderingInfoKHR rendering_info = {
-        .sType = VK_STRUCTURE_TYPE_RENDERING_INFO_KHR,
-        .flags = 0,
-        .renderArea =
-         {
-            .extent =
-            {
-                .width = vulkan_overlay_->width,
-                .height = vulkan_overlay_->height,
-            },
-        },
-        .layerCount = 1,
-        .viewMask = 0,
-        .colorAttachmentCount = 1,
-        .pColorAttachments = &color_attachment,
-        .pDepthAttachment = nullptr,
-        .pStencilAttachment = nullptr,
-    };
+    {
+        std::lock_guard<std::mutex> stats_lock(stats_mutex_);
+        gpu_timer_.Collect(timeline_completed_value_);
+    }
 
-    vk_result = vkWaitForFences(vulkan_device_, 1, &vulkan_overlay_->fence, VK_TRUE, UINT64_MAX);
+    vk_result = vkResetCommandPool(vulkan_device_, batch->command_pool, 0);
     VK_VALIDATE_RESULT(vk_result);
 
-    vk_result = vkResetFences(vulkan_device_, 1, &vulkan_overlay_->fence);
+    vk_result = vkBeginCommandBuffer(batch->command_buffer, &buffer_begin_info);
     VK_VALIDATE_RESULT(vk_result);
 
-    vk_result = vkResetCommandPool(vulkan_device_, vulkan_overlay_->command_pool, 0);
-    VK_VALIDATE_RESULT(vk_result);
+    // The whole batch is one pass, layout changes, draws and the transfer barriers of every overlay in it
+    const uint32_t timer_slot = gpu_timer_.BeginCommandBuffer(batch->command_buffer);
 
-    vk_result = vkBeginCommandBuffer(vulkan_overlay_->command_buffer, &buffer_begin_info);
-    VK_VALIDATE_RESULT(vk_result);
+    gpu_timer_.WriteBegin(timer_slot, batch->command_buffer, Vulkan_GpuSection_OverlayPass);
+    for (Vulkan_OverlayPending& pending : overlay_pending_)
+        pending.partial_redraw = this->RecordOverlay(pending.draw->draw_data, pending.draw->vulkan_overlay, pending.frame, batch->command_buffer);
+    gpu_timer_.WriteEnd(timer_slot, batch->command_buffer, Vulkan_GpuSection_OverlayPass);
 
-    f_vkCmdBeginRenderingKHR(vulkan_overlay_->command_buffer, &rendering_info);
-    ImGui_ImplVulkan_RenderDrawData(draw_data, vulkan_overlay_->command_buffer);
-    f_vkCmdEndRenderingKHR(vulkan_overlay_->command_buffer);
+    vk_result = vkEndCommandBuffer(batch->command_buffer);
+    VK_VALIDATE_RESULT(vk_result);
+    if (vk_result != VK_SUCCESS) {
+        gpu_timer_.Release(timer_slot);
+        for (const Vulkan_OverlayPending& pending : overlay_pending_)
+            this->DiscardOverlayFrame(pending.frame);
+        return;
+    }
 
-    VkImageMemoryBarrier barrier_optimal =
+    VkSubmitInfo submit_info =
     {
-        .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
-        .srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
-        .dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT,
-        .oldLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
-        .newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+        .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+        .commandBufferCount = 1,
+        .pCommandBuffers = &batch->command_buffer,
+    };
+
+    const uint64_t submit_value = this->SubmitTimeline(vulkan_queue_, submit_info);
+    batch->submit_value = submit_value;
+    gpu_timer_.Submitted(timer_slot, submit_value);
+
+    overlay_batch_index_ = (overlay_batch_index_ + 1) % OVERLAY_BATCH_COUNT;
+
+    {
+        std::lock_guard<std::mutex> stats_lock(stats_mutex_);
+        stats_.overlay_submits++;
+    }
+
+    for (const Vulkan_OverlayPending& pending : overlay_pending_) {
+        pending.frame->submit_value = submit_value;
+        this->PresentOverlay(pending.draw->vulkan_overlay, pending.draw->overlay, pending.frame, pending.draw_data_hash, pending.partial_redraw);
+    }
+}
+
+auto VulkanRenderer::RenderMirrored(ImDrawData* draw_data, Vulkan_Window* window, VrOverlay*& overlay) -> void
+{
+    PROFILE_SCOPE("RenderMirrored");
+
+    // A resized window would get a stretched copy that mouse input no longer lines up with, it draws on its own
+    if (!this->CanMirror(window) || !overlay->IsVisible()) {
+        this->RenderWindow(draw_data, window);
+        this->RenderOverlay(draw_data, overlay);
+        return;
+    }
+
+    if (window->is_minimized) {
+        this->RenderOverlay(draw_data, overlay);
+        return;
+    }
+
+    this->CollectDeletions();
+
+    VkResult vk_result = {};
+
+    VkSemaphore image_acquired_semaphore = window->semaphores[window->semaphore_index].image_acquired_semaphore;
+    VkSemaphore render_complete_semaphore = window->semaphores[window->semaphore_index].render_complete_semaphore;
+
+    {
+        PROFILE_SCOPE("vkAcquireNextImageKHR");
+        vk_result = vkAcquireNextImageKHR(vulkan_device_, window->swapchain, UINT64_MAX, image_acquired_semaphore, VK_NULL_HANDLE, &window->frame_index);
+    }
+    if (vk_result == VK_ERROR_OUT_OF_DATE_KHR || vk_result == VK_SUBOPTIMAL_KHR)
+        should_rebuild_swapchain_ = true;
+    if (vk_result == VK_ERROR_OUT_OF_DATE_KHR) {
+        this->RenderOverlay(draw_data, overlay);
+        return;
+    }
+    if (vk_result != VK_SUBOPTIMAL_KHR)
+        VK_VALIDATE_RESULT(vk_result);
+
+    Vulkan_Frame* wfd = &window->frames[window->frame_index];
+
+    // When the overlay did not change the window gets a copy of the texture the compositor already shows.
+    const uint64_t draw_data_hash = ImDrawDataHasPendingTextures(draw_data) ? 0 : HashImDrawData(draw_data);
+    const bool overlay_unchanged = draw_data_hash != 0 && draw_data_hash == vulkan_overlay_->presented_hash && vulkan_overlay_->presented_frame != UINT32_MAX;
+
+    Vulkan_OverlayFrame* ofd = overlay_unchanged ? &vulkan_overlay_->frames[vulkan_overlay_->presented_frame] : &vulkan_overlay_->frames[vulkan_overlay_->frame_index];
+
+    VkCommandBufferBeginInfo buffer_begin_info =
+    {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+        .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+    };
+
+    this->WaitTimeline(wfd->submit_value);
+    if (!overlay_unchanged)
+        this->WaitTimeline(ofd->submit_value);
+
+    {
+        std::lock_guard<std::mutex> stats_lock(stats_mutex_);
+        gpu_timer_.Collect(timeline_completed_value_);
+    }
+
+    vk_result = vkResetCommandPool(vulkan_device_, wfd->command_pool, 0);
+    VK_VALIDATE_RESULT(vk_result);
+
+    vk_result = vkBeginCommandBuffer(wfd->command_buffer, &buffer_begin_info);
+    VK_VALIDATE_RESULT(vk_result);
+
+    const uint32_t timer_slot = gpu_timer_.BeginCommandBuffer(wfd->command_buffer);
+
+    bool partial_redraw = false;
+    if (!overlay_unchanged) {
+        gpu_timer_.WriteBegin(timer_slot, wfd->command_buffer, Vulkan_GpuSection_OverlayPass);
+        partial_redraw = this->RecordOverlay(draw_data, vulkan_overlay_.get(), ofd, wfd->command_buffer);
+        gpu_timer_.WriteEnd(timer_slot, wfd->command_buffer, Vulkan_GpuSection_OverlayPass);
+    }
+
+    VkImageMemoryBarrier barrier_transfer =
+    {
+        .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+        .srcAccessMask = 0,
+        .dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+        .oldLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+        .newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
         .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
         .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-        .image = vulkan_overlay_->texture,
+        .image = wfd->backbuffer,
         .subresourceRange =
         {
             .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
@@ -927,72 +1161,237 @@ auto VulkanRenderer::RenderOverlay(ImDrawData* draw_data, VrOverlay*& overlay) -
         },
     };
 
-    vkCmdPipelineBarrier(vulkan_overlay_->command_buffer, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier_optimal);
+    // Only the copy into the window waits for the swapchain image, the pass is timed from there
+    gpu_timer_.WriteBegin(timer_slot, wfd->command_buffer, Vulkan_GpuSection_MirrorPass, VK_PIPELINE_STAGE_TRANSFER_BIT);
+    vkCmdPipelineBarrier(wfd->command_buffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier_transfer);
 
-    vk_result = vkEndCommandBuffer(vulkan_overlay_->command_buffer);
-    VK_VALIDATE_RESULT(vk_result);
+    VkImageBlit blit_region =
+    {
+        .srcSubresource =
+        {
+            .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+            .mipLevel = 0,
+            .baseArrayLayer = 0,
+            .layerCount = 1,
+        },
+        .srcOffsets =
+        {
+            { 0, 0, 0 },
+            { static_cast<int32_t>(vulkan_overlay_->width), static_cast<int32_t>(vulkan_overlay_->height), 1 },
+        },
+        .dstSubresource =
+        {
+            .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+            .mipLevel = 0,
+            .baseArrayLayer = 0,
+            .layerCount = 1,
+        },
+        .dstOffsets =
+        {
+            { 0, 0, 0 },
+            { static_cast<int32_t>(window->width), static_cast<int32_t>(window->height), 1 },
+        },
+    };
+
+    vkCmdBlitImage(wfd->command_buffer, ofd->texture, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, wfd->backbuffer, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &blit_region, VK_FILTER_NEAREST);
 
-    VkSubmitInfo submit_info_barrier =
+    VkImageMemoryBarrier barrier_present =
     {
+        .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+        .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+        .dstAccessMask = 0,
+        .oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        .newLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
+        .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .image = wfd->backbuffer,
+        .subresourceRange =
+        {
+            .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+            .baseMipLevel = 0,
+            .levelCount = 1,
+            .baseArrayLayer = 0,
+            .layerCount = 1,
+        },
+    };
+
+    vkCmdPipelineBarrier(wfd->command_buffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier_present);
+    gpu_timer_.WriteEnd(timer_slot, wfd->command_buffer, Vulkan_GpuSection_MirrorPass);
+
+    vk_result = vkEndCommandBuffer(wfd->command_buffer);
+    VK_VALIDATE_RESULT(vk_result);
+    if (vk_result != VK_SUCCESS) {
+        // Same as in RenderWindow, the frame is dropped and the swapchain replaced
+        gpu_timer_.Release(timer_slot);
+        should_rebuild_swapchain_ = true;
+        if (!overlay_unchanged)
+            this->DiscardOverlayFrame(ofd);
+        return;
+    }
+
+    // The overlay pass does not touch the swapchain image, only the blit has to wait for it.
+    VkPipelineStageFlags wait_stage_mask = VK_PIPELINE_STAGE_TRANSFER_BIT;
+
+    VkSubmitInfo submit_info = {
         .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+        .waitSemaphoreCount = 1,
+        .pWaitSemaphores = &image_acquired_semaphore,
+        .pWaitDstStageMask = &wait_stage_mask,
         .commandBufferCount = 1,
-        .pCommandBuffers = &vulkan_overlay_->command_buffer,
+        .pCommandBuffers = &wfd->command_buffer,
+        .signalSemaphoreCount = 1,
+        .pSignalSemaphores = &render_complete_semaphore,
     };
 
-    vk_result = vkQueueSubmit(vulkan_overlay_->queue, 1, &submit_info_barrier, vulkan_overlay_->fence);
-    VK_VALIDATE_RESULT(vk_result);
+    const uint64_t submit_value = this->SubmitTimeline(vulkan_queue_, submit_info);
+    wfd->submit_value = submit_value;
+    gpu_timer_.Submitted(timer_slot, submit_value);
+    ofd->submit_value = std::max(ofd->submit_value, submit_value);
+
+    if (overlay_unchanged) {
+        std::lock_guard<std::mutex> stats_lock(stats_mutex_);
+        stats_.overlay_frames_skipped++;
+        return;
+    }
 
-    vr::VRVulkanTextureData_t vulkanTexure =
     {
-        .m_nImage = (uintptr_t)vulkan_overlay_->texture,
-        .m_pDevice = vulkan_device_,
-        .m_pPhysicalDevice = vulkan_physical_device_,
-        .m_pInstance = vulkan_instance_,
-        .m_pQueue = vulkan_queue_,
-        .m_nQueueFamilyIndex = (uint32_t)vulkan_queue_family_,
-        .m_nWidth = vulkan_overlay_->width,
-        .m_nHeight = vulkan_overlay_->height,
-        .m_nFormat = (uint32_t)vulkan_overlay_->texture_format.format,
-        .m_nSampleCount = VK_SAMPLE_COUNT_1_BIT,
-    };
+        std::lock_guard<std::mutex> stats_lock(stats_mutex_);
+        stats_.overlay_submits++;
+    }
 
-    vr::Texture_t vrTexture =
+    this->PresentOverlay(vulkan_overlay_.get(), overlay, ofd, draw_data_hash, partial_redraw);
+}
+
+auto VulkanRenderer::DiscardOverlayFrame(Vulkan_OverlayFrame* fd) -> void
+{
+    // The texture is still in whatever layout it was in, moving on from an undefined one is valid for any of them
+    fd->texture_layout = VK_IMAGE_LAYOUT_UNDEFINED;
+    fd->signatures_valid = false;
+}
+
+auto VulkanRenderer::RecordOverlay(ImDrawData* draw_data, Vulkan_Overlay* vulkan_overlay, Vulkan_OverlayFrame* fd, VkCommandBuffer command_buffer) -> bool
+{
+    const ImVec4 background_color = ImVec4(0.45f, 0.55f, 0.60f, 1.00f);
+    /// NOTE: suboptimal
+    vulkan_overlay->clear_value.color.float32[0] = background_color.x * background_color.w;
+    vulkan_overlay->clear_value.color.float32[1] = background_color.y * background_color.w;
+    vulkan_overlay->clear_value.color.float32[2] = background_color.z * background_color.w;
+    vulkan_overlay->clear_value.color.float32[3] = background_color.w;
+
+    // Work out which part of the texture is out of date. The texture of this frame still holds
+    // what was rendered into it frame_count frames ago, so diff against the commands of that frame.
+    const uint64_t display_hash = HashImDrawDataDisplay(draw_data);
+    const bool signatures_valid = !ImDrawDataHasPendingTextures(draw_data) && BuildImDrawCmdSignatures(draw_data, damage_signatures_);
+
+    bool partial_redraw = false;
+    VkRect2D render_area =
     {
-        .handle = (void*)&vulkanTexure,
-        .eType = vr::TextureType_Vulkan,
-        .eColorSpace = vr::ColorSpace_Auto,
+        .offset = { 0, 0 },
+        .extent = { vulkan_overlay->width, vulkan_overlay->height },
     };
 
-    try {
-        overlay->SetTexture(vrTexture);
-    }
-    catch (std::exception& ex) {
-        printf("Failed to set overlay texture\n%s\n\n", ex.what());
-        return;
+    damage_rects_.clear();
+    damage_clear_rects_.clear();
+
+    if (vulkan_overlay->damage_tracking_enable && vulkan_overlay->clear_enable && signatures_valid &&
+        fd->signatures_valid && fd->display_hash == display_hash && fd->texture_layout != VK_IMAGE_LAYOUT_UNDEFINED)
+    {
+        ComputeImDrawDamage(fd->signatures, damage_signatures_, damage_rects_, damage_scratch_);
+
+        const ImVec2 display_pos = draw_data->DisplayPos;
+        const ImVec2 scale = draw_data->FramebufferScale;
+        const float width = static_cast<float>(vulkan_overlay->width);
+        const float height = static_cast<float>(vulkan_overlay->height);
+
+        // Snap to whole framebuffer pixels first, the clip rects handed to ImGui are derived back
+        // from the snapped rects so rasterization never leaves the area that gets cleared.
+        for (ImVec4& rect : damage_rects_) {
+            rect.x = std::clamp(floorf((rect.x - display_pos.x) * scale.x), 0.0f, width);
+            rect.y = std::clamp(floorf((rect.y - display_pos.y) * scale.y), 0.0f, height);
+            rect.z = std::clamp(ceilf((rect.z - display_pos.x) * scale.x), 0.0f, width);
+            rect.w = std::clamp(ceilf((rect.w - display_pos.y) * scale.y), 0.0f, height);
+        }
+
+        std::erase_if(damage_rects_, [](const ImVec4& rect) { return rect.z <= rect.x || rect.w <= rect.y; });
+        MergeDamageRects(damage_rects_, 8);
+
+        uint64_t damaged_area = {};
+        for (const ImVec4& rect : damage_rects_)
+            damaged_area += static_cast<uint64_t>(rect.z - rect.x) * static_cast<uint64_t>(rect.w - rect.y);
+
+        // Past half of the texture the extra passes over the geometry cost more than the fill rate saved.
+        if (damaged_area * 2 < static_cast<uint64_t>(vulkan_overlay->width) * vulkan_overlay->height) {
+            partial_redraw = true;
+
+            ImVec4 bounds = damage_rects_.empty() ? ImVec4(0.0f, 0.0f, 0.0f, 0.0f) : damage_rects_[0];
+
+            for (ImVec4& rect : damage_rects_) {
+                bounds = ImRectUnion(bounds, rect);
+
+                damage_clear_rects_.push_back({
+                    .rect =
+                    {
+                        .offset = { static_cast<int32_t>(rect.x), static_cast<int32_t>(rect.y) },
+                        .extent = { static_cast<uint32_t>(rect.z - rect.x), static_cast<uint32_t>(rect.w - rect.y) },
+                    },
+                    .baseArrayLayer = 0,
+                    .layerCount = 1,
+                });
+
+                rect = ImVec4(rect.x / scale.x + display_pos.x, rect.y / scale.y + display_pos.y, rect.z / scale.x + display_pos.x, rect.w / scale.y + display_pos.y);
+            }
+
+            render_area =
+            {
+                .offset = { static_cast<int32_t>(bounds.x), static_cast<int32_t>(bounds.y) },
+                .extent = { static_cast<uint32_t>(bounds.z - bounds.x), static_cast<uint32_t>(bounds.w - bounds.y) },
+            };
+        }
     }
 
-    vk_result = vkWaitForFences(vulkan_device_, 1, &vulkan_overlay_->fence, VK_TRUE, UINT64_MAX);
-    VK_VALIDATE_RESULT(vk_result);
+    VkAttachmentLoadOp load_op = vulkan_overlay->clear_enable ? VK_ATTACHMENT_LOAD_OP_CLEAR : VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    if (partial_redraw)
+        load_op = VK_ATTACHMENT_LOAD_OP_LOAD;
 
-    vk_result = vkResetFences(vulkan_device_, 1, &vulkan_overlay_->fence);
-    VK_VALIDATE_RESULT(vk_result);
+    VkRenderingAttachmentInfoKHR color_attachment =
+    {
+        .sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO_KHR,
+        .imageView = fd->texture_view,
+        .imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+        .resolveMode = VK_RESOLVE_MODE_NONE_KHR,
+        .resolveImageView = VK_NULL_HANDLE,
+        .resolveImageLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+        .loadOp = load_op,
+        .storeOp = VK_ATTACHMENT_STORE_OP_STORE,
+        .clearValue = vulkan_overlay->clear_value,
+    };
 
-    vk_result = vkResetCommandPool(vulkan_device_, vulkan_overlay_->command_pool, 0);
-    VK_VALIDATE_RESULT(vk_result);
+    VkRenderingInfoKHR rendering_info = {
+        .sType = VK_STRUCTURE_TYPE_RENDERING_INFO_KHR,
+        .flags = 0,
+        .renderArea = render_area,
+        .layerCount = 1,
+        .viewMask = 0,
+        .colorAttachmentCount = 1,
+        .pColorAttachments = &color_attachment,
+        .pDepthAttachment = nullptr,
+        .pStencilAttachment = nullptr,
+    };
 
-    vk_result = vkBeginCommandBuffer(vulkan_overlay_->command_buffer, &buffer_begin_info);
-    VK_VALIDATE_RESULT(vk_result);
+    // The image is still in whatever layout the previous use of this frame left it in, usually
+    // TRANSFER_SRC after the compositor copied it, so restore it here instead of in a separate submission.
+    const bool texture_initialized = fd->texture_layout != VK_IMAGE_LAYOUT_UNDEFINED;
 
     VkImageMemoryBarrier barrier_restore =
     {
         .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
-        .srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT,
+        .srcAccessMask = texture_initialized ? VK_ACCESS_TRANSFER_READ_BIT : VkAccessFlags(0),
         .dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
-        .oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+        .oldLayout = fd->texture_layout,
         .newLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
         .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
         .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-        .image = vulkan_overlay_->texture,
+        .image = fd->texture,
         .subresourceRange =
         {
             .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
@@ -1003,13 +1402,106 @@ auto VulkanRenderer::RenderOverlay(ImDrawData* draw_data, VrOverlay*& overlay) -
         },
     };
 
-    vkCmdPipelineBarrier(vulkan_overlay_->command_buffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier_restore);
+    vkCmdPipelineBarrier(command_buffer, texture_initialized ? VK_PIPELINE_STAGE_TRANSFER_BIT : VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier_restore);
 
-    vk_result = vkEndCommandBuffer(vulkan_overlay_->command_buffer);
-    VK_VALIDATE_RESULT(vk_result);
+    if (!partial_redraw) {
+        f_vkCmdBeginRenderingKHR(command_buffer, &rendering_info);
+        ImGui_ImplVulkan_RenderDrawData(draw_data, command_buffer);
+        f_vkCmdEndRenderingKHR(command_buffer);
+    }
+    else if (!damage_clear_rects_.empty()) {
+        VkClearAttachment clear_attachment =
+        {
+            .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+            .colorAttachment = 0,
+            .clearValue = vulkan_overlay->clear_value,
+        };
 
-    vk_result = vkQueueSubmit(vulkan_overlay_->queue, 1, &submit_info_barrier, vulkan_overlay_->fence);
-    VK_VALIDATE_RESULT(vk_result);
+        f_vkCmdBeginRenderingKHR(command_buffer, &rendering_info);
+        vkCmdClearAttachments(command_buffer, 1, &clear_attachment, static_cast<uint32_t>(damage_clear_rects_.size()), damage_clear_rects_.data());
+
+        ImDrawDataClipCommands(draw_data, damage_rects_, damage_cmd_storage_);
+        ImGui_ImplVulkan_RenderDrawData(draw_data, command_buffer);
+        ImDrawDataRestoreCommands(draw_data, damage_cmd_storage_);
+
+        f_vkCmdEndRenderingKHR(command_buffer);
+    }
+
+    VkImageMemoryBarrier barrier_optimal =
+    {
+        .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+        .srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+        .dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT,
+        .oldLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+        .newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+        .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .image = fd->texture,
+        .subresourceRange =
+        {
+            .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+            .baseMipLevel = 0,
+            .levelCount = 1,
+            .baseArrayLayer = 0,
+            .layerCount = 1,
+        },
+    };
+
+    vkCmdPipelineBarrier(command_buffer, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier_optimal);
+
+    fd->texture_layout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+    fd->signatures.swap(damage_signatures_);
+    fd->signatures_valid = signatures_valid;
+    fd->display_hash = display_hash;
+
+    return partial_redraw;
+}
+
+auto VulkanRenderer::PresentOverlay(Vulkan_Overlay* vulkan_overlay, VrOverlay* overlay, Vulkan_OverlayFrame* fd, uint64_t draw_data_hash, bool partial_redraw) -> void
+{
+    {
+        std::lock_guard<std::mutex> stats_lock(stats_mutex_);
+        stats_.overlay_frames++;
+        if (partial_redraw)
+            stats_.overlay_partial_frames++;
+    }
+
+    vr::VRVulkanTextureData_t vulkanTexure =
+    {
+        .m_nImage = (uintptr_t)fd->texture,
+        .m_pDevice = vulkan_device_,
+        .m_pPhysicalDevice = vulkan_physical_device_,
+        .m_pInstance = vulkan_instance_,
+        .m_pQueue = vulkan_queue_,
+        .m_nQueueFamilyIndex = (uint32_t)vulkan_queue_family_,
+        .m_nWidth = vulkan_overlay->width,
+        .m_nHeight = vulkan_overlay->height,
+        .m_nFormat = (uint32_t)vulkan_overlay->texture_format.format,
+        .m_nSampleCount = VK_SAMPLE_COUNT_1_BIT,
+    };
+
+    vr::Texture_t vrTexture =
+    {
+        .handle = (void*)&vulkanTexure,
+        .eType = vr::TextureType_Vulkan,
+        .eColorSpace = vr::ColorSpace_Auto,
+    };
+
+    try {
+        PROFILE_SCOPE("SetOverlayTexture");
+        // The compositor may submit on m_pQueue from inside the call
+        std::lock_guard<std::mutex> queue_lock(queue_mutex_);
+        overlay->SetTexture(vrTexture);
+        vulkan_overlay->presented_hash = draw_data_hash;
+        vulkan_overlay->presented_frame = vulkan_overlay->frame_index;
+    }
+    catch (std::exception& ex) {
+        printf("Failed to set overlay texture\n%s\n\n", ex.what());
+        vulkan_overlay->presented_hash = 0;
+        vulkan_overlay->presented_frame = UINT32_MAX;
+    }
+
+    vulkan_overlay->frame_index = (vulkan_overlay->frame_index + 1) % vulkan_overlay->frame_count;
 }
 
 auto VulkanRenderer::Present(Vulkan_Window* window)  -> void
@@ -1031,7 +1523,42 @@ auto VulkanRenderer::Present(Vulkan_Window* window)  -> void
         .pImageIndices = &window->frame_index,
     };
 
-    vk_result = vkQueuePresentKHR(vulkan_queue_, &info);
+    VkFence present_fence = VK_NULL_HANDLE;
+
+    VkSwapchainPresentFenceInfoEXT present_fence_info =
+    {
+        .sType = VK_STRUCTURE_TYPE_SWAPCHAIN_PRESENT_FENCE_INFO_EXT,
+        .swapchainCount = 1,
+        .pFences = &present_fence,
+    };
+
+    if (should_use_present_fences_) {
+        if (free_present_fences_.empty()) {
+            VkFenceCreateInfo fence_create_info =
+            {
+                .sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO,
+            };
+
+            vk_result = vkCreateFence(vulkan_device_, &fence_create_info, vulkan_allocator_, &present_fence);
+            VK_VALIDATE_RESULT(vk_result);
+        }
+        else {
+            present_fence = free_present_fences_.back();
+            free_present_fences_.pop_back();
+        }
+
+        info.pNext = &present_fence_info;
+    }
+
+    {
+        PROFILE_SCOPE("vkQueuePresentKHR");
+        std::lock_guard<std::mutex> queue_lock(queue_mutex_);
+        vk_result = vkQueuePresentKHR(vulkan_queue_, &info);
+    }
+
+    // A present rejected as out of date still waits on its semaphore and signals the fence
+    if (present_fence != VK_NULL_HANDLE)
+        present_fences_.push_back({ .fence = present_fence, .swapchain = window->swapchain });
 
     if (vk_result == VK_ERROR_OUT_OF_DATE_KHR || vk_result == VK_SUBOPTIMAL_KHR)
         should_rebuild_swapchain_ = true;
@@ -1045,85 +1572,395 @@ auto VulkanRenderer::Present(Vulkan_Window* window)  -> void
     window->semaphore_index = (window->semaphore_index + 1) % window->semaphore_count;
 }
 
-auto VulkanRenderer::DestroyWindow(Vulkan_Window* window) const -> void
+auto VulkanRenderer::UpdateTextures(ImDrawData* draw_data) -> bool
 {
-    this->DestroyFrames(window);
+    if (!ImDrawDataHasPendingTextures(draw_data))
+        return false;
 
-    vkDestroyPipeline(vulkan_device_, window->pipeline, vulkan_allocator_);
-    vkDestroyRenderPass(vulkan_device_, window->render_pass, vulkan_allocator_);
-    vkDestroySwapchainKHR(vulkan_device_, window->swapchain, vulkan_allocator_);
-    vkDestroySurfaceKHR(vulkan_instance_, window->surface, vulkan_allocator_);
-    vkDestroyDescriptorPool(vulkan_device_, vulkan_descriptor_pool_, vulkan_allocator_);
+    PROFILE_SCOPE("UpdateTextures");
+
+    bool changed = false;
+
+    // Updates and destroys happen in place, on images and descriptors frames submitted so far may still sample.
+    // Keep the render thread from recording and let the GPU finish those frames first. Creating a texture
+    // touches nothing a frame uses, the first upload of the font atlas doesn't wait.
+    bool in_use = false;
+    for (ImTextureData* texture : *draw_data->Textures)
+        in_use |= texture->Status == ImTextureStatus_WantUpdates || texture->Status == ImTextureStatus_WantDestroy;
+
+    std::unique_lock<std::mutex> render_lock(render_mutex_, std::defer_lock);
+    if (in_use) {
+        render_lock.lock();
+        this->WaitTimeline(timeline_value_.load(std::memory_order_acquire));
+    }
+
+    // The backend uploads through its own command buffer on the shared queue
+    std::lock_guard<std::mutex> queue_lock(queue_mutex_);
+
+    for (ImTextureData* texture : *draw_data->Textures) {
+        if (texture->Status == ImTextureStatus_OK)
+            continue;
+
+        changed |= texture->Status == ImTextureStatus_WantCreate || texture->Status == ImTextureStatus_WantUpdates;
+        ImGui_ImplVulkan_UpdateTexture(texture);
+    }
+
+    return changed;
 }
 
-auto VulkanRenderer::DestroyFrames(Vulkan_Window* window) const -> void
+auto VulkanRenderer::InvalidateOverlay() -> void
 {
-    VkResult vk_result = {};
-    vk_result = vkQueueWaitIdle(vulkan_queue_);
-    VK_VALIDATE_RESULT(vk_result);
+    this->InvalidateOverlay(vulkan_overlay_.get());
+}
 
-    for (uint32_t idx = 0; idx < window->semaphore_count; idx++) {
-        Vulkan_FrameSemaphore* fsd = &window->semaphores[idx];
+auto VulkanRenderer::InvalidateOverlay(Vulkan_Overlay* vulkan_overlay) -> void
+{
+    vulkan_overlay->presented_hash = 0;
+
+    for (Vulkan_OverlayFrame& frame : vulkan_overlay->frames)
+        frame.signatures_valid = false;
+}
+
+auto VulkanRenderer::DestroyWindow(Vulkan_Window* window) -> void
+{
+    // The descriptor pool is shared with the overlay and the ImGui backend frees its sets into it on shutdown,
+    // it stays around until Destroy().
+    const uint64_t value = this->SubmitTimelineMarker();
+
+    this->DestroyFrames(window->frames, window->semaphores, window->swapchain, value);
+
+    deletion_queue_.Defer(value, window->pipeline);
+    deletion_queue_.Defer(value, window->render_pass);
+    deletion_queue_.Defer(VulkanDeletionQueue::IDLE_VALUE, window->surface);
 
-        vkDestroySemaphore(vulkan_device_, fsd->image_acquired_semaphore, vulkan_allocator_);
-        vkDestroySemaphore(vulkan_device_, fsd->render_complete_semaphore, vulkan_allocator_);
+    window->pipeline = VK_NULL_HANDLE;
+    window->render_pass = VK_NULL_HANDLE;
+    window->swapchain = VK_NULL_HANDLE;
+    window->surface = VK_NULL_HANDLE;
+    window->image_count = 0;
+    window->semaphore_count = 0;
+
+    // The surface has to be gone before the caller destroys the native window, and the last presents of the
+    // swapchain with it. Only an idle queue says they are done.
+    this->IdleQueue();
+}
+
+auto VulkanRenderer::DestroyFrames(std::vector<Vulkan_Frame>& frames, std::vector<Vulkan_FrameSemaphore>& semaphores, VkSwapchainKHR swapchain, uint64_t value) -> void
+{
+    std::vector<VkSemaphore> present_semaphores = {};
+
+    for (Vulkan_FrameSemaphore& semaphore : semaphores) {
+        Vulkan_FrameSemaphore* fsd = &semaphore;
 
-        fsd->image_acquired_semaphore = VK_NULL_HANDLE;
-        fsd->render_complete_semaphore = VK_NULL_HANDLE;
+        deletion_queue_.Defer(value, fsd->image_acquired_semaphore);
+        present_semaphores.push_back(fsd->render_complete_semaphore);
     }
 
-    for (uint32_t idx = 0; idx < window->image_count; idx++) {
-        Vulkan_Frame* fd = &window->frames[idx];
+    for (Vulkan_Frame& frame : frames) {
+        Vulkan_Frame* fd = &frame;
+
+        // Destroying the pool frees its command buffer
+        deletion_queue_.Defer(value, fd->command_pool);
+        deletion_queue_.Defer(value, fd->backbuffer_view);
+        deletion_queue_.Defer(value, fd->framebuffer);
+    }
+
+    frames.clear();
+    semaphores.clear();
+
+    this->RetireSwapchain(swapchain, std::move(present_semaphores));
+}
+
+auto VulkanRenderer::RetireSwapchain(VkSwapchainKHR swapchain, std::vector<VkSemaphore> semaphores) -> void
+{
+    if (should_use_present_fences_) {
+        retired_swapchains_.push_back({ .swapchain = swapchain, .semaphores = std::move(semaphores) });
+        return;
+    }
+
+    for (VkSemaphore semaphore : semaphores)
+        deletion_queue_.Defer(VulkanDeletionQueue::IDLE_VALUE, semaphore);
+
+    if (swapchain != VK_NULL_HANDLE) {
+        deletion_queue_.Defer(VulkanDeletionQueue::IDLE_VALUE, swapchain);
+        retired_swapchain_count_++;
+    }
+}
+
+auto VulkanRenderer::SetupOverlayBatches() -> void
+{
+    VkResult vk_result = {};
+
+    overlay_batches_.assign(OVERLAY_BATCH_COUNT, Vulkan_OverlayBatch{});
+    overlay_batch_index_ = 0;
+
+    for (Vulkan_OverlayBatch& batch : overlay_batches_) {
+        VkCommandPoolCreateInfo command_pool_create_info =
+        {
+            .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+            .flags = 0,
+            .queueFamilyIndex = vulkan_queue_family_,
+        };
+
+        vk_result = vkCreateCommandPool(vulkan_device_, &command_pool_create_info, vulkan_allocator_, &batch.command_pool);
+        VK_VALIDATE_RESULT(vk_result);
+
+        VkCommandBufferAllocateInfo command_buffer_allocate_info = {
+            .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+            .commandPool = batch.command_pool,
+            .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+            .commandBufferCount = 1,
+        };
+
+        vk_result = vkAllocateCommandBuffers(vulkan_device_, &command_buffer_allocate_info, &batch.command_buffer);
+        VK_VALIDATE_RESULT(vk_result);
 
-        vkDestroyFence(vulkan_device_, fd->fence, vulkan_allocator_);
-        vkFreeCommandBuffers(vulkan_device_, fd->command_pool, 1, &fd->command_buffer);
-        vkDestroyCommandPool(vulkan_device_, fd->command_pool, vulkan_allocator_);
-        vkDestroyImageView(vulkan_device_, fd->backbuffer_view, vulkan_allocator_);
-        vkDestroyFramebuffer(vulkan_device_, fd->framebuffer, vulkan_allocator_);
-
-        fd->command_pool = VK_NULL_HANDLE;
-        fd->command_buffer = VK_NULL_HANDLE;
-        fd->fence = VK_NULL_HANDLE;
-        fd->backbuffer = VK_NULL_HANDLE;
-        fd->backbuffer_view = VK_NULL_HANDLE;
-        fd->framebuffer = VK_NULL_HANDLE;
+        batch.submit_value = 0;
     }
 }
 
-auto VulkanRenderer::DestroyOverlay(Vulkan_Overlay* vulkan_overlay) const -> void
+auto VulkanRenderer::CollectDeletions() -> void
+{
+    if (!present_fences_.empty())
+        this->CollectPresents(false);
+
+    if (deletion_queue_.OldestValue() > timeline_value_)
+        return;
+
+    if (deletion_queue_.OldestValue() > timeline_completed_value_)
+        this->PollTimeline();
+
+    deletion_queue_.Collect(timeline_completed_value_);
+}
+
+auto VulkanRenderer::CollectPresents(bool wait) -> void
+{
+    VkResult vk_result = {};
+
+    // Presents are not guaranteed to finish in order, every fence is looked at
+    std::erase_if(present_fences_, [&](const Vulkan_PresentFence& present) {
+        if (wait) {
+            vk_result = vkWaitForFences(vulkan_device_, 1, &present.fence, VK_TRUE, UINT64_MAX);
+            VK_VALIDATE_RESULT(vk_result);
+        }
+        else if (vkGetFenceStatus(vulkan_device_, present.fence) != VK_SUCCESS) {
+            return false;
+        }
+
+        vk_result = vkResetFences(vulkan_device_, 1, &present.fence);
+        VK_VALIDATE_RESULT(vk_result);
+
+        free_present_fences_.push_back(present.fence);
+        return true;
+    });
+
+    std::erase_if(retired_swapchains_, [&](const Vulkan_RetiredSwapchain& retired) {
+        if (std::ranges::any_of(present_fences_, [&](const Vulkan_PresentFence& present) { return present.swapchain == retired.swapchain; }))
+            return false;
+
+        for (VkSemaphore semaphore : retired.semaphores)
+            vkDestroySemaphore(vulkan_device_, semaphore, vulkan_allocator_);
+
+        if (retired.swapchain != VK_NULL_HANDLE)
+            vkDestroySwapchainKHR(vulkan_device_, retired.swapchain, vulkan_allocator_);
+        return true;
+    });
+}
+
+auto VulkanRenderer::IdleQueue() -> void
 {
     VkResult vk_result = {};
-    vk_result = vkQueueWaitIdle(vulkan_queue_);
+
+    PROFILE_SCOPE("vkQueueWaitIdle");
+
+    {
+        std::lock_guard<std::mutex> queue_lock(queue_mutex_);
+        vk_result = vkQueueWaitIdle(vulkan_queue_);
+    }
     VK_VALIDATE_RESULT(vk_result);
 
-    vkDestroyFence(vulkan_device_, vulkan_overlay->fence, vulkan_allocator_);
-    vkFreeCommandBuffers(vulkan_device_, vulkan_overlay->command_pool, 1, &vulkan_overlay->command_buffer);
-    vkDestroyCommandPool(vulkan_device_, vulkan_overlay->command_pool, vulkan_allocator_);
+    this->PollTimeline();
+    // Swapchains go before the surfaces the deletion queue may hold for them
+    this->CollectPresents(true);
+    deletion_queue_.Flush();
+    retired_swapchain_count_ = 0;
+}
 
-    vkDestroyImage(vulkan_device_, vulkan_overlay->texture, vulkan_allocator_);
-    vkFreeMemory(vulkan_device_, vulkan_overlay->texture_memory, vulkan_allocator_);
-    vkDestroyImageView(vulkan_device_, vulkan_overlay->texture_view, vulkan_allocator_);
+auto VulkanRenderer::DestroyOverlay(Vulkan_Overlay* vulkan_overlay) -> void
+{
+    if (vulkan_overlay->frames.empty())
+        return;
 
-    vulkan_overlay->fence = VK_NULL_HANDLE;
-    vulkan_overlay->command_pool = VK_NULL_HANDLE;
-    vulkan_overlay->command_buffer = VK_NULL_HANDLE;
-    vulkan_overlay->texture = VK_NULL_HANDLE;
-    vulkan_overlay->texture_memory = VK_NULL_HANDLE;
-    vulkan_overlay->texture_view = VK_NULL_HANDLE;
+    // SetOverlayTexture lets the compositor queue its copy of the texture on our queue after our own last
+    // submission drawing into it. A marker submitted now comes after every such copy, the same as for windows.
+    const uint64_t value = this->SubmitTimelineMarker();
+
+    for (uint32_t idx = 0; idx < vulkan_overlay->frame_count; idx++) {
+        Vulkan_OverlayFrame* fd = &vulkan_overlay->frames[idx];
+
+        deletion_queue_.Defer(value, fd->texture_view);
+        deletion_queue_.Defer(value, fd->texture);
+        deletion_queue_.Defer(value, fd->texture_memory);
+    }
+
+    vulkan_overlay->frames.clear();
+    vulkan_overlay->frame_count = 0;
+    vulkan_overlay->frame_index = 0;
+    vulkan_overlay->presented_hash = 0;
+    vulkan_overlay->presented_frame = UINT32_MAX;
 }
 
 auto VulkanRenderer::Destroy() -> void
 {
     VkResult vk_result = {};
 
-    vk_result = vkQueueWaitIdle(vulkan_queue_);
-    VK_VALIDATE_RESULT(vk_result);
+    this->DestroyOverlay(vulkan_overlay_.get());
+
+    for (Vulkan_OverlayBatch& batch : overlay_batches_)
+        deletion_queue_.Defer(batch.submit_value, batch.command_pool);
+    overlay_batches_.clear();
+
+    // Tearing down the device has to wait for everything
+    this->IdleQueue();
+
+    for (VkFence fence : free_present_fences_)
+        vkDestroyFence(vulkan_device_, fence, vulkan_allocator_);
+    free_present_fences_.clear();
+
+    vkDestroyDescriptorPool(vulkan_device_, vulkan_descriptor_pool_, vulkan_allocator_);
+    vulkan_descriptor_pool_ = VK_NULL_HANDLE;
 
 #ifdef ENABLE_VULKAN_VALIDATION
     auto f_vkDestroyDebugReportCallbackEXT = (PFN_vkDestroyDebugReportCallbackEXT)vkGetInstanceProcAddr(vulkan_instance_, "vkDestroyDebugReportCallbackEXT");
     f_vkDestroyDebugReportCallbackEXT(vulkan_instance_, nullptr, vulkan_allocator_);
 #endif
 
+    gpu_timer_.Destroy();
+
+    vkDestroySemaphore(vulkan_device_, vulkan_timeline_semaphore_, vulkan_allocator_);
+    vulkan_timeline_semaphore_ = VK_NULL_HANDLE;
+
+    if (vulkan_pipeline_cache_ != VK_NULL_HANDLE) {
+        if (!pipeline_cache_path_.empty()) {
+            size_t pipeline_cache_size = {};
+            vk_result = vkGetPipelineCacheData(vulkan_device_, vulkan_pipeline_cache_, &pipeline_cache_size, nullptr);
+
+            if (vk_result == VK_SUCCESS && pipeline_cache_size > 0) {
+                std::vector<uint8_t> pipeline_cache_data(pipeline_cache_size);
+                vk_result = vkGetPipelineCacheData(vulkan_device_, vulkan_pipeline_cache_, &pipeline_cache_size, pipeline_cache_data.data());
+                pipeline_cache_data.resize(pipeline_cache_size);
+
+                if (vk_result == VK_SUCCESS && !WriteVulkanPipelineCache(pipeline_cache_path_, vulkan_capabilities_.Properties(), pipeline_cache_data))
+                    printf("Failed to write pipeline cache to %s\n", pipeline_cache_path_.c_str());
+            }
+        }
+
+        vkDestroyPipelineCache(vulkan_device_, vulkan_pipeline_cache_, vulkan_allocator_);
+        vulkan_pipeline_cache_ = VK_NULL_HANDLE;
+    }
+
     vkDestroyDevice(vulkan_device_, vulkan_allocator_);
     vkDestroyInstance(vulkan_instance_, vulkan_allocator_);
 }
+
+auto VulkanRenderer::SubmitTimeline(VkQueue queue, const VkSubmitInfo& submit_info) -> uint64_t
+{
+    VkResult vk_result = {};
+
+    // Binary semaphores of the submission keep their place, the timeline is signalled after them.
+    assert(submit_info.signalSemaphoreCount <= 1);
+
+    // Values must reach the queue in the order they are handed out, both are done under the queue lock so a
+    // submission from another thread can't take the next value and get to the queue first.
+    std::lock_guard<std::mutex> queue_lock(queue_mutex_);
+
+    const uint64_t signal_value = timeline_value_.load(std::memory_order_relaxed) + 1;
+
+    VkSemaphore signal_semaphores[2] = {};
+    uint64_t signal_values[2] = {};
+    uint32_t signal_count = {};
+
+    if (submit_info.signalSemaphoreCount == 1)
+        signal_semaphores[signal_count++] = submit_info.pSignalSemaphores[0];
+
+    signal_semaphores[signal_count] = vulkan_timeline_semaphore_;
+    signal_values[signal_count++] = signal_value;
+
+    VkTimelineSemaphoreSubmitInfoKHR timeline_submit_info =
+    {
+        .sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO_KHR,
+        .signalSemaphoreValueCount = signal_count,
+        .pSignalSemaphoreValues = signal_values,
+    };
+
+    VkSubmitInfo timeline_submit = submit_info;
+    timeline_submit.pNext = &timeline_submit_info;
+    timeline_submit.signalSemaphoreCount = signal_count;
+    timeline_submit.pSignalSemaphores = signal_semaphores;
+
+    {
+        PROFILE_SCOPE("vkQueueSubmit");
+        vk_result = vkQueueSubmit(queue, 1, &timeline_submit, VK_NULL_HANDLE);
+    }
+    VK_VALIDATE_RESULT(vk_result);
+
+    timeline_value_.store(signal_value, std::memory_order_release);
+    return signal_value;
+}
+
+auto VulkanRenderer::SubmitTimelineMarker() -> uint64_t
+{
+    VkSubmitInfo submit_info =
+    {
+        .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+    };
+
+    return this->SubmitTimeline(vulkan_queue_, submit_info);
+}
+
+auto VulkanRenderer::WaitTimeline(uint64_t value) -> void
+{
+    // Values are handed out in submission order, once one is known to be reached every older one is too.
+    if (value <= timeline_completed_value_)
+        return;
+
+    if (value <= this->PollTimeline())
+        return;
+
+    VkResult vk_result = {};
+
+    PROFILE_SCOPE("vkWaitSemaphores");
+
+    VkSemaphoreWaitInfoKHR wait_info =
+    {
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO_KHR,
+        .semaphoreCount = 1,
+        .pSemaphores = &vulkan_timeline_semaphore_,
+        .pValues = &value,
+    };
+
+    vk_result = f_vkWaitSemaphoresKHR(vulkan_device_, &wait_info, UINT64_MAX);
+    VK_VALIDATE_RESULT(vk_result);
+
+    this->StoreCompletedValue(value);
+}
+
+auto VulkanRenderer::PollTimeline() -> uint64_t
+{
+    VkResult vk_result = {};
+
+    uint64_t value = {};
+    vk_result = f_vkGetSemaphoreCounterValueKHR(vulkan_device_, vulkan_timeline_semaphore_, &value);
+    VK_VALIDATE_RESULT(vk_result);
+
+    this->StoreCompletedValue(value);
+    return timeline_completed_value_.load(std::memory_order_acquire);
+}
+
+auto VulkanRenderer::StoreCompletedValue(uint64_t value) -> void
+{
+    // Both threads poll and wait, a slower one must not move the value back
+    uint64_t completed = timeline_completed_value_.load(std::memory_order_relaxed);
+    while (completed < value && !timeline_completed_value_.compare_exchange_weak(completed, value, std::memory_order_acq_rel))
+        ;
+}
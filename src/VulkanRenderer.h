@@ -8,10 +8,14 @@
 
 #pragma once
 
+#include <algorithm>
 #include <memory>
 #include <atomic>
 #include <vector>
 #include <functional>
+#include <mutex>
+#include <span>
+#include <string>
 
 #include <vulkan/vulkan.h>
 
@@ -21,6 +25,10 @@
 #include <openvr.h>
 
 #include "VrOverlay.h"
+#include "VulkanCapabilities.h"
+#include "VulkanDeletionQueue.h"
+#include "VulkanGpuTimer.h"
+#include "ImDrawDataUtils.h"
 
 struct Vulkan_Frame;
 struct Vulkan_FrameSemaphore;
@@ -29,7 +37,7 @@ struct Vulkan_Frame
 {
     VkCommandPool command_pool;
     VkCommandBuffer command_buffer;
-    VkFence fence;
+    uint64_t submit_value; // timeline value signalled by the last submission of command_buffer
     VkImage backbuffer;
     VkImageView backbuffer_view;
     VkFramebuffer framebuffer;
@@ -60,6 +68,7 @@ struct Vulkan_Window
     std::vector<Vulkan_Frame> frames;
     std::vector<Vulkan_FrameSemaphore> semaphores;
     bool is_minimized;
+    bool mirror_overlay; // swapchain images can be filled by blitting the overlay texture
 
     Vulkan_Window()
     {
@@ -67,20 +76,32 @@ struct Vulkan_Window
     }
 };
 
+struct Vulkan_OverlayFrame
+{
+    uint64_t submit_value; // timeline value signalled by the last submission that drew into texture
+    VkImage texture;
+    VkImageView texture_view;
+    VkDeviceMemory texture_memory;
+    VkImageLayout texture_layout;
+    std::vector<ImDrawCmdSignature> signatures; // draw commands last rendered into the texture
+    uint64_t display_hash;
+    bool signatures_valid;
+};
+
 struct Vulkan_Overlay 
 {
     uint32_t width;
     uint32_t height;
     VkSurfaceFormatKHR texture_format;
-    VkCommandPool command_pool;
-    VkCommandBuffer command_buffer;
-    VkFence fence;
-    VkImage texture;
-    VkImageView texture_view;
-    VkDeviceMemory texture_memory;
+    uint32_t frame_index;
+    uint32_t frame_count;
+    std::vector<Vulkan_OverlayFrame> frames;
     VkQueue queue;
     bool clear_enable;
     VkClearValue clear_value;
+    uint64_t presented_hash; // HashImDrawData of the frame currently shown by the compositor, 0 if none
+    uint32_t presented_frame; // index of the frame currently shown by the compositor, UINT32_MAX if none
+    bool damage_tracking_enable;
 
     Vulkan_Overlay()
     {
@@ -88,13 +109,68 @@ struct Vulkan_Overlay
     }
 };
 
+// Command buffer every overlay drawn in a frame is recorded into
+struct Vulkan_OverlayBatch
+{
+    VkCommandPool command_pool;
+    VkCommandBuffer command_buffer;
+    uint64_t submit_value; // timeline value signalled by the last submission of command_buffer
+};
+
+struct Vulkan_OverlayDraw
+{
+    ImDrawData* draw_data;          // nullptr leaves the overlay showing what it shows
+    Vulkan_Overlay* vulkan_overlay;
+    VrOverlay* overlay;
+};
+
+// Fence a window present signals once it is done with its semaphores, VK_EXT_swapchain_maintenance1 only
+struct Vulkan_PresentFence
+{
+    VkFence fence;
+    VkSwapchainKHR swapchain;
+};
+
+// Swapchain SetupSwapchain replaced, destroyed with the semaphores its presents wait on once their fences signalled
+struct Vulkan_RetiredSwapchain
+{
+    VkSwapchainKHR swapchain;
+    std::vector<VkSemaphore> semaphores;
+};
+
+struct Vulkan_RenderStats
+{
+    uint64_t overlay_frames;        // overlay textures rendered and handed to the compositor
+    uint64_t overlay_submits;       // vkQueueSubmit calls that rendered them
+    uint64_t overlay_frames_skipped;
+    uint64_t overlay_partial_frames;
+};
+
 class VulkanRenderer {
 public:
+    // Overlays one RenderOverlays call can take, and batches in flight before the oldest one is waited on
+    static constexpr uint32_t MAX_BATCHED_OVERLAYS = 64;
+    static constexpr uint32_t OVERLAY_BATCH_COUNT = 3;
+    // SetupSwapchain takes fewer swapchain images than this, a window never has more frames in flight
+    static constexpr uint32_t MAX_WINDOW_FRAMES = 16;
+    // Swapchains SetupSwapchain retires before it idles the queue to destroy them, without present fences
+    static constexpr uint32_t MAX_RETIRED_SWAPCHAINS = 4;
+
+    // ImGui_ImplVulkan_RenderDrawData takes the next vertex and index buffers of a ring on every call, one ring per
+    // ImGui context. overlay_count is how many overlays draw the same context, each takes a buffer per batch, and the
+    // ring has to outlast every batch in flight as well as the window frames RenderMirrored draws the context into.
+    [[nodiscard]] static constexpr auto ImGuiRenderBufferCount(uint32_t overlay_count) -> uint32_t
+    {
+        return std::max(overlay_count * OVERLAY_BATCH_COUNT, MAX_WINDOW_FRAMES);
+    }
+
     explicit VulkanRenderer();
-    auto Initialize() -> void;
+    // pipeline_cache_path is where the pipeline cache is loaded from and written back to on Destroy(), empty disables it
+    auto Initialize(const std::string& pipeline_cache_path = {}) -> void;
 
     [[nodiscard]] auto Instance() const -> VkInstance { return vulkan_instance_; }
     [[nodiscard]] auto PhysicalDevice() const -> VkPhysicalDevice { return vulkan_physical_device_; }
+    [[nodiscard]] auto Capabilities() const -> const VulkanDeviceCapabilities& { return vulkan_capabilities_; }
     [[nodiscard]] auto QueueFamily() const -> uint32_t { return vulkan_queue_family_; }
     [[nodiscard]] auto Allocator() const -> VkAllocationCallbacks* { return vulkan_allocator_; }
     [[nodiscard]] auto Device() const -> VkDevice { return vulkan_device_; }
@@ -103,31 +179,95 @@ public:
     [[nodiscard]] auto PipelineCache() const -> VkPipelineCache { return vulkan_pipeline_cache_; }
     [[nodiscard]] auto MinimumConcurrentImageCount() const -> uint32_t { return minimum_concurrent_image_count_; }
     [[nodiscard]] auto ShouldRebuildSwapchain() const -> bool { return should_rebuild_swapchain_; }
+    // RenderMirrored copies the overlay texture into the window as it is, only while both have the same extent
+    [[nodiscard]] auto CanMirror(const Vulkan_Window* window) const -> bool { return window->mirror_overlay && window->width == vulkan_overlay_->width && window->height == vulkan_overlay_->height; }
+    // Held by the renderer around every submit and present, anyone else using Queue() from another thread takes it too
+    [[nodiscard]] auto QueueMutex() -> std::mutex& { return queue_mutex_; }
+    // Held by the render thread while it records and submits a frame, UpdateTextures takes it so textures never
+    // change under a frame being recorded. Taken before QueueMutex() when both are needed.
+    [[nodiscard]] auto RenderMutex() -> std::mutex& { return render_mutex_; }
+    // Stats and timings can be read from any thread
+    [[nodiscard]] auto Stats() const -> Vulkan_RenderStats { std::lock_guard<std::mutex> lock(stats_mutex_); return stats_; }
+    // Objects handed over here are destroyed once the timeline reached the value they are tagged with
+    [[nodiscard]] auto DeletionQueue() -> VulkanDeletionQueue& { return deletion_queue_; }
+    // Timeline value of the latest submission, the tag for objects anything submitted so far may use
+    [[nodiscard]] auto SubmittedValue() const -> uint64_t { return timeline_value_.load(std::memory_order_acquire); }
+    // Rolling GPU time of each renderer pass, read back a few frames late. Empty unless built with ENABLE_GPU_TIMINGS.
+    [[nodiscard]] auto GpuTimings() const -> std::array<Vulkan_GpuTiming, Vulkan_GpuSection_COUNT> { std::lock_guard<std::mutex> lock(stats_mutex_); return gpu_timer_.Timings(); }
+    auto ResetStats() -> void { std::lock_guard<std::mutex> lock(stats_mutex_); stats_ = {}; gpu_timer_.ResetHistory(); }
 
     auto SetupWindow(Vulkan_Window* window, VkSurfaceKHR surface, uint32_t width, uint32_t height) -> void;
-    auto SetupOverlay(uint32_t width, uint32_t height, VkSurfaceFormatKHR format) -> void;
+    // Without vulkan_overlay the renderer's own overlay, the one RenderOverlay and RenderMirrored draw into
+    auto SetupOverlay(uint32_t width, uint32_t height, VkSurfaceFormatKHR format, uint32_t frame_count = 3) -> void;
+    auto SetupOverlay(Vulkan_Overlay* vulkan_overlay, uint32_t width, uint32_t height, VkSurfaceFormatKHR format, uint32_t frame_count = 3) -> void;
     auto SetupSwapchain(Vulkan_Window* window, uint32_t width, uint32_t height) -> void;
     // ImGui renderer helpers
     auto RenderWindow(ImDrawData* draw_data, Vulkan_Window* window) -> void;
     auto RenderOverlay(ImDrawData* draw_data, VrOverlay*& overlay) -> void;
+    // Records every visible overlay whose draw data changed into one command buffer and submits it once
+    auto RenderOverlays(std::span<const Vulkan_OverlayDraw> draws) -> void;
+    // Rasterizes draw_data once into the overlay texture and blits it into the window in the same submission
+    auto RenderMirrored(ImDrawData* draw_data, Vulkan_Window* window, VrOverlay*& overlay) -> void;
 
     auto Present(Vulkan_Window* window) -> void;
 
-    auto DestroyWindow(Vulkan_Window* window) const -> void;
-    auto DestroyOverlay(Vulkan_Overlay* vulkan_overlay) const -> void;
+    // Creates, updates and destroys the textures draw_data requests through the ImGui backend, so the draw data can be
+    // rendered later or on another thread without them. Returns true if the content of any texture changed.
+    // Changing or destroying a texture waits for the render thread's frame and everything it submitted.
+    auto UpdateTextures(ImDrawData* draw_data) -> bool;
+    // Forgets what the overlay texture shows, the next RenderOverlay draws the whole frame again
+    auto InvalidateOverlay() -> void;
+    auto InvalidateOverlay(Vulkan_Overlay* vulkan_overlay) -> void;
+
+    auto DestroyWindow(Vulkan_Window* window) -> void;
+    auto DestroyOverlay(Vulkan_Overlay* vulkan_overlay) -> void;
     auto Destroy() -> void;
 private:
     
-    auto DestroyFrames(Vulkan_Window* window) const -> void;
+    // Hands the frames to the deletion queue, to be destroyed once the timeline reached value. The swapchain and the
+    // semaphores presents wait on go to RetireSwapchain.
+    auto DestroyFrames(std::vector<Vulkan_Frame>& frames, std::vector<Vulkan_FrameSemaphore>& semaphores, VkSwapchainKHR swapchain, uint64_t value) -> void;
+    // Destroys the swapchain and semaphores once the presents to it are done, which only an idle queue says
+    // without present fences
+    auto RetireSwapchain(VkSwapchainKHR swapchain, std::vector<VkSemaphore> semaphores) -> void;
+    // Destroys what the deletion queue holds for submissions the GPU finished and what finished presents released,
+    // never blocks
+    auto CollectDeletions() -> void;
+    // Recycles the fences of finished presents and destroys the retired swapchains with none left in flight, blocks
+    // on the presents only with wait
+    auto CollectPresents(bool wait) -> void;
+    // Waits until the queue is idle, presents included, and destroys everything the deletion queue holds
+    auto IdleQueue() -> void;
+    // Submits an empty batch, its value is reached once every submission queued before it is done. Presents
+    // are not submissions, a later value being reached says nothing about them.
+    auto SubmitTimelineMarker() -> uint64_t;
+    auto SetupOverlayBatches() -> void;
+    // Undoes what RecordOverlay assumed about a frame whose commands never got submitted, the next one draws it whole
+    auto DiscardOverlayFrame(Vulkan_OverlayFrame* fd) -> void;
+    auto RecordOverlay(ImDrawData* draw_data, Vulkan_Overlay* vulkan_overlay, Vulkan_OverlayFrame* fd, VkCommandBuffer command_buffer) -> bool;
+    auto PresentOverlay(Vulkan_Overlay* vulkan_overlay, VrOverlay* overlay, Vulkan_OverlayFrame* fd, uint64_t draw_data_hash, bool partial_redraw) -> void;
+    // Timeline helpers, every submission signals the next value of vulkan_timeline_semaphore_
+    auto SubmitTimeline(VkQueue queue, const VkSubmitInfo& submit_info) -> uint64_t;
+    auto WaitTimeline(uint64_t value) -> void;
+    // Refreshes timeline_completed_value_ without blocking
+    auto PollTimeline() -> uint64_t;
+    auto StoreCompletedValue(uint64_t value) -> void;
 
     VkInstance vulkan_instance_;
     VkPhysicalDevice vulkan_physical_device_;
+    VulkanDeviceCapabilities vulkan_capabilities_;
     std::atomic<uint32_t> vulkan_queue_family_;
     VkAllocationCallbacks* vulkan_allocator_;
     VkDevice vulkan_device_;
     VkQueue vulkan_queue_;
+    std::mutex queue_mutex_;
+    std::mutex render_mutex_;
     VkDescriptorPool vulkan_descriptor_pool_;
     VkPipelineCache vulkan_pipeline_cache_;
+    std::string pipeline_cache_path_;
+    VkSemaphore vulkan_timeline_semaphore_;
+    std::atomic<uint64_t> timeline_value_;              // written under queue_mutex_
+    std::atomic<uint64_t> timeline_completed_value_;    // only moves forward, see StoreCompletedValue
     std::atomic<uint32_t> minimum_concurrent_image_count_;
     std::atomic<bool> should_rebuild_swapchain_;
     std::vector<std::string> vulkan_instance_extensions_;
@@ -136,8 +276,35 @@ private:
     std::vector<VkPhysicalDevice> device_list_;
     std::atomic<bool> should_enable_dynamic_rendering_;
     std::unique_ptr<Vulkan_Overlay> vulkan_overlay_;
+    std::vector<Vulkan_OverlayBatch> overlay_batches_;
+    uint32_t overlay_batch_index_;
+    VulkanDeletionQueue deletion_queue_;
+    uint32_t retired_swapchain_count_;                  // swapchains in the deletion queue waiting for IdleQueue
+    bool should_use_present_fences_;                    // VK_EXT_swapchain_maintenance1 is enabled
+    std::vector<Vulkan_PresentFence> present_fences_;   // presents in flight
+    std::vector<VkFence> free_present_fences_;
+    std::vector<Vulkan_RetiredSwapchain> retired_swapchains_;
+    Vulkan_RenderStats stats_;
+    mutable std::mutex stats_mutex_;
+    VulkanGpuTimer gpu_timer_;
+    std::vector<ImDrawCmdSignature> damage_signatures_;
+    ImDrawDamageScratch damage_scratch_;
+    std::vector<ImVec4> damage_rects_;
+    std::vector<VkClearRect> damage_clear_rects_;
+    std::vector<ImVector<ImDrawCmd>> damage_cmd_storage_;
+
+    struct Vulkan_OverlayPending
+    {
+        const Vulkan_OverlayDraw* draw;
+        Vulkan_OverlayFrame* frame;
+        uint64_t draw_data_hash;
+        bool partial_redraw;
+    };
+    std::vector<Vulkan_OverlayPending> overlay_pending_;
 
     // Vulkan function wrappers
     PFN_vkCmdBeginRenderingKHR f_vkCmdBeginRenderingKHR;
     PFN_vkCmdEndRenderingKHR f_vkCmdEndRenderingKHR;
+    PFN_vkWaitSemaphoresKHR f_vkWaitSemaphoresKHR;
+    PFN_vkGetSemaphoreCounterValueKHR f_vkGetSemaphoreCounterValueKHR;
 };
\ No newline at end of file
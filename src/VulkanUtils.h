@@ -10,64 +10,30 @@
 
 #include <vector>
 #include <sstream>
+#include <fstream>
+#include <filesystem>
+#include <cstring>
+#include <string_view>
 
 #include <vulkan/vulkan.h>
 #include <openvr.h>
 
+#include "VulkanCapabilities.h"
+
 #define VK_VALIDATE_RESULT(e)                                  \
     if (e != VK_SUCCESS)                                       \
         fprintf(stderr, "[Vulkan] Error: VkResult = %d\n", e); \
     if (e > 0)                                                 \
         assert(e);                                             \
 
-static auto IsVulkanInstanceExtensionAvailable(std::string extension) -> bool 
+static auto IsVulkanInstanceExtensionAvailable(std::string_view extension) -> bool 
 {
-    auto IsExtensionAvailable = [](const std::vector<VkExtensionProperties>& properties, std::string extension) {
-        for (const VkExtensionProperties& p : properties)
-            if (strcmp(p.extensionName, extension.c_str()) == 0)
-                return true;
-        return false;
-        };
-
-    uint32_t extension_properties_count = {};
-    std::vector<VkExtensionProperties> extension_properties = {};
-
-    vkEnumerateInstanceExtensionProperties(nullptr, &extension_properties_count, nullptr);
-
-    if (extension_properties_count > 0) {
-        extension_properties.resize(extension_properties_count);
-        vkEnumerateInstanceExtensionProperties(nullptr, &extension_properties_count, extension_properties.data());
-    }
-    else {
-        std::exit(EXIT_FAILURE);
-    }
-
-    return IsExtensionAvailable(extension_properties, extension);
+    return VulkanInstanceCapabilities::Get().HasExtension(extension);
 }
 
-static auto IsVulkanDeviceExtensionAvailable(const VkPhysicalDevice& physical_device, std::string extension) -> bool 
+static auto IsVulkanDeviceExtensionAvailable(const VulkanDeviceCapabilities& capabilities, std::string_view extension) -> bool 
 {
-    auto IsExtensionAvailable = [](const std::vector<VkExtensionProperties>& properties, std::string extension) {
-        for (const VkExtensionProperties& p : properties)
-            if (strcmp(p.extensionName, extension.c_str()) == 0)
-                return true;
-        return false;
-    };
-
-    uint32_t extension_properties_count = {};
-    std::vector<VkExtensionProperties> extension_properties = {};
-
-    vkEnumerateDeviceExtensionProperties(physical_device, nullptr, &extension_properties_count, nullptr);
-
-    if (extension_properties_count > 0) {
-        extension_properties.resize(extension_properties_count);
-        vkEnumerateDeviceExtensionProperties(physical_device, nullptr, &extension_properties_count, extension_properties.data());
-    }
-    else {
-        std::exit(EXIT_FAILURE);
-    }
-
-    return IsExtensionAvailable(extension_properties, extension);
+    return capabilities.HasExtension(extension);
 }
 
 static auto GetVulkanInstanceExtensionsRequiredByOpenVR() -> std::vector<std::string>
@@ -103,8 +69,10 @@ static auto GetVulkanInstanceExtensionsRequiredByOpenVR() -> std::vector<std::st
     return result;
 }
 
-static auto GetVulkanDeviceExtensionsRequiredByOpenVR(const VkPhysicalDevice& device) -> std::vector<std::string> 
+static auto GetVulkanDeviceExtensionsRequiredByOpenVR(const VulkanDeviceCapabilities& capabilities) -> std::vector<std::string> 
 {
+    VkPhysicalDevice device = capabilities.PhysicalDevice();
+
     std::vector<std::string> result{};
 
     if (!vr::VRCompositor()) {
@@ -120,7 +88,7 @@ static auto GetVulkanDeviceExtensionsRequiredByOpenVR(const VkPhysicalDevice& de
         std::string token{};
         std::istringstream token_stream(buffer.data());
         while (std::getline(token_stream, token, ' ')) {
-            if (IsVulkanDeviceExtensionAvailable(device, token.data())) {
+            if (IsVulkanDeviceExtensionAvailable(capabilities, token)) {
                 result.push_back(token);
             } else {
                 printf("ERROR! %s device extension asked by OpenVR was NOT available\n", token.c_str());
@@ -132,4 +100,106 @@ static auto GetVulkanDeviceExtensionsRequiredByOpenVR(const VkPhysicalDevice& de
     }
 
     return result;
-}
\ No newline at end of file
+}
+
+// On-disk pipeline cache layout: VulkanPipelineCacheHeader followed by the data of vkGetPipelineCacheData.
+// The header pins the blob to the exact device and driver that produced it, drivers are not required
+// to survive a blob from another driver version and some of them do not.
+struct VulkanPipelineCacheHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t vendor_id;
+    uint32_t device_id;
+    uint32_t driver_version;
+    uint8_t pipeline_cache_uuid[VK_UUID_SIZE];
+    uint64_t data_size;
+    uint64_t data_hash;
+};
+
+constexpr uint32_t VULKAN_PIPELINE_CACHE_MAGIC = 0x43505653; // "SVPC"
+constexpr uint32_t VULKAN_PIPELINE_CACHE_VERSION = 1;
+
+static auto HashVulkanPipelineCacheData(const uint8_t* data, size_t size) -> uint64_t
+{
+    // FNV-1a, only guards against truncated or corrupted files
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= data[i];
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+static auto ReadVulkanPipelineCache(const std::string& path, const VkPhysicalDeviceProperties& properties) -> std::vector<uint8_t>
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+        return {};
+
+    VulkanPipelineCacheHeader header = {};
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)))
+        return {};
+
+    if (header.magic != VULKAN_PIPELINE_CACHE_MAGIC || header.version != VULKAN_PIPELINE_CACHE_VERSION)
+        return {};
+
+    if (header.vendor_id != properties.vendorID || header.device_id != properties.deviceID || header.driver_version != properties.driverVersion)
+        return {};
+
+    if (memcmp(header.pipeline_cache_uuid, properties.pipelineCacheUUID, VK_UUID_SIZE) != 0)
+        return {};
+
+    // pipeline caches of an overlay are a few hundred kilobytes, anything far past that is not ours
+    if (header.data_size == 0 || header.data_size > 64 * 1024 * 1024)
+        return {};
+
+    std::vector<uint8_t> data(static_cast<size_t>(header.data_size));
+    if (!file.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(data.size())))
+        return {};
+
+    if (HashVulkanPipelineCacheData(data.data(), data.size()) != header.data_hash)
+        return {};
+
+    return data;
+}
+
+static auto WriteVulkanPipelineCache(const std::string& path, const VkPhysicalDeviceProperties& properties, const std::vector<uint8_t>& data) -> bool
+{
+    VulkanPipelineCacheHeader header =
+    {
+        .magic = VULKAN_PIPELINE_CACHE_MAGIC,
+        .version = VULKAN_PIPELINE_CACHE_VERSION,
+        .vendor_id = properties.vendorID,
+        .device_id = properties.deviceID,
+        .driver_version = properties.driverVersion,
+        .pipeline_cache_uuid = {},
+        .data_size = data.size(),
+        .data_hash = HashVulkanPipelineCacheData(data.data(), data.size()),
+    };
+
+    memcpy(header.pipeline_cache_uuid, properties.pipelineCacheUUID, VK_UUID_SIZE);
+
+    // Write next to the destination and rename over it so a crash mid-write never leaves a torn cache behind.
+    const std::string temporary_path = path + ".tmp";
+    {
+        std::ofstream file(temporary_path, std::ios::binary | std::ios::trunc);
+        if (!file)
+            return false;
+
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+
+        if (!file)
+            return false;
+    }
+
+    std::error_code error = {};
+    std::filesystem::rename(temporary_path, path, error);
+    if (error) {
+        std::filesystem::remove(temporary_path, error);
+        return false;
+    }
+
+    return true;
+}
@@ -4,6 +4,7 @@
 // Implemented features:
 //  [X] Platform: Virtual keyboard support
 //  [X] Platform: Mouse emulation
+//  [X] Platform: Mouse moves and scrolling coalesced between button transitions
 // Missing features or Issues:
 //  [ ] Platform: Touch Emulation
 
@@ -33,6 +34,7 @@ struct ImGui_ImplOpenVR_Data {
     uint32_t width;
     uint32_t height;
     bool keyboard_active;
+    bool visible;           // tracked from VREvent_OverlayShown and VREvent_OverlayHidden, asking every frame is a round trip to vrserver
 #ifdef _WIN32
     uint64_t ticks_per_second;
 #endif
@@ -42,11 +44,47 @@ struct ImGui_ImplOpenVR_Data {
     ImGui_ImplOpenVR_Data() { memset((void*)this, 0, sizeof(*this)); }
 };
 
+// Mouse input held back until something it must not be reordered with arrives or the frame starts.
+// Kept per context and outside of the backend data since overlay events are also fed into contexts where
+// another platform backend owns io.BackendPlatformUserData, like the SDL3 window mirroring the overlay.
+struct ImGui_ImplOpenVR_PendingInput {
+    ImGuiContext* context;
+    bool mouse_pos_pending;
+    ImVec2 mouse_pos;       // as OpenVR sends it, bottom left is 0,0
+    bool mouse_wheel_pending;
+    float mouse_wheel;
+};
+
+static ImVector<ImGui_ImplOpenVR_PendingInput> g_PendingInputs;
+static ImGui_ImplOpenVR_InputStats g_InputStats = {};
+
+// The held back input of the current context, made on first use
+static ImGui_ImplOpenVR_PendingInput* ImGui_ImplOpenVR_GetPendingInput()
+{
+    ImGuiContext* context = ImGui::GetCurrentContext();
+    for (ImGui_ImplOpenVR_PendingInput& pending : g_PendingInputs)
+        if (pending.context == context)
+            return &pending;
+
+    ImGui_ImplOpenVR_PendingInput pending = {};
+    pending.context = context;
+    g_PendingInputs.push_back(pending);
+    return &g_PendingInputs.back();
+}
+
 // Backend data stored in io.BackendRendererUserData to allow support for multiple Dear ImGui contexts
 // It is STRONGLY preferred that you use docking branch with multi-viewports (== single Dear ImGui context + multiple windows) instead of multiple Dear ImGui contexts.
+// Overlay events are also fed into contexts owned by another platform backend, whose user data is not ours to touch
 static ImGui_ImplOpenVR_Data* ImGui_ImplOpenVR_GetBackendData()
 {
-    return ImGui::GetCurrentContext() ? (ImGui_ImplOpenVR_Data*)ImGui::GetIO().BackendPlatformUserData : nullptr;
+    if (!ImGui::GetCurrentContext())
+        return nullptr;
+
+    ImGuiIO& io = ImGui::GetIO();
+    if (io.BackendPlatformName == nullptr || strcmp(io.BackendPlatformName, "imgui_impl_openvr") != 0)
+        return nullptr;
+
+    return (ImGui_ImplOpenVR_Data*)io.BackendPlatformUserData;
 }
 
 bool ImGui_ImplOpenVR_Init(ImGui_ImplOpenVR_InitInfo* initInfo)
@@ -65,6 +103,7 @@ bool ImGui_ImplOpenVR_Init(ImGui_ImplOpenVR_InitInfo* initInfo)
     bd->height = initInfo->height;
 
     bd->keyboard_active = false;
+    bd->visible = vr::VROverlay()->IsOverlayVisible(bd->handle);
 
 #ifdef _WIN32
     uint64_t perf_frequency = {};
@@ -81,23 +120,51 @@ bool ImGui_ImplOpenVR_Init(ImGui_ImplOpenVR_InitInfo* initInfo)
     return true;
 }
 
+static void ImGui_ImplOpenVR_AddKeyPress(ImGuiIO& io, ImGuiKey key)
+{
+    io.AddKeyEvent(key, true);
+    io.AddKeyEvent(key, false);
+    g_InputStats.events_forwarded += 2;
+}
+
 bool ImGui_ImplOpenVR_ProcessOverlayEvent(const vr::VREvent_t& event)
 {
+    // Null when another platform backend owns the context, the input is still forwarded
     ImGui_ImplOpenVR_Data* bd = ImGui_ImplOpenVR_GetBackendData();
-    IM_ASSERT(bd != nullptr && "Context or backend not initialized! Did you call ImGui_ImplOpenVR_Init()?");
+    IM_ASSERT(ImGui::GetCurrentContext() != nullptr && "No current context. Did you call ImGui::CreateContext()?");
 
     ImGuiIO& io = ImGui::GetIO();
+    ImGui_ImplOpenVR_PendingInput* pending = ImGui_ImplOpenVR_GetPendingInput();
     switch (event.eventType)
     {
+        case vr::VREvent_OverlayShown:
+        case vr::VREvent_OverlayHidden:
+        {
+            if (bd != nullptr)
+                bd->visible = event.eventType == vr::VREvent_OverlayShown;
+            // The laser is gone with the overlay, nothing should stay hovered while it is hidden
+            if (event.eventType == vr::VREvent_OverlayHidden) {
+                pending->mouse_pos_pending = false;
+                io.AddMousePosEvent(-FLT_MAX, -FLT_MAX);
+                g_InputStats.events_forwarded++;
+            }
+            break;
+        }
         case vr::VREvent_MouseMove:
         {
-            // OpenGL uses coordinate space Bottom Left == 0,0 where as Vulkan is Top Left == 0,0
-            // So we need to flip the y-axis to get the correct mouse position data
-            io.AddMousePosEvent(event.data.mouse.x, io.DisplaySize.y - event.data.mouse.y);
+            // Only the latest position matters until a button changes, a laser pointer sends one per compositor
+            // frame and ImGui would otherwise trickle them out one per frame
+            g_InputStats.events_received++;
+            pending->mouse_pos = ImVec2(event.data.mouse.x, event.data.mouse.y);
+            pending->mouse_pos_pending = true;
             break;
         }
         case vr::VREvent_MouseButtonDown:
         {
+            g_InputStats.events_received++;
+            // The click has to land where the laser was when it happened
+            ImGui_ImplOpenVR_FlushOverlayEvents();
+
             uint64_t mask = event.data.mouse.button;
             mask &= vr::VRMouseButton_Left | vr::VRMouseButton_Right | vr::VRMouseButton_Middle;
             // Ensure that the event sends a bitmask with only a single flag
@@ -119,12 +186,17 @@ bool ImGui_ImplOpenVR_ProcessOverlayEvent(const vr::VREvent_t& event)
             else if (event.data.mouse.button & vr::VRMouseButton_Middle)
                 mouse_button = ImGuiMouseButton_Middle;
 
-            if (mouse_button < ImGuiMouseButton_COUNT)
+            if (mouse_button < ImGuiMouseButton_COUNT) {
                 io.AddMouseButtonEvent(mouse_button, true);
+                g_InputStats.events_forwarded++;
+            }
             break;
         }
         case vr::VREvent_MouseButtonUp:
         {
+            g_InputStats.events_received++;
+            ImGui_ImplOpenVR_FlushOverlayEvents();
+
             uint64_t mask = event.data.mouse.button;
             mask &= vr::VRMouseButton_Left | vr::VRMouseButton_Right | vr::VRMouseButton_Middle;
             if (mask && (mask & (mask - 1))) {
@@ -140,8 +212,10 @@ bool ImGui_ImplOpenVR_ProcessOverlayEvent(const vr::VREvent_t& event)
             else if (event.data.mouse.button & vr::VRMouseButton_Middle)
                 mouse_button = ImGuiMouseButton_Middle;
 
-            if (mouse_button < ImGuiMouseButton_COUNT)
+            if (mouse_button < ImGuiMouseButton_COUNT) {
                 io.AddMouseButtonEvent(mouse_button, false);
+                g_InputStats.events_forwarded++;
+            }
             break;
         }
         case vr::VREvent_ScrollDiscrete:
@@ -150,13 +224,20 @@ bool ImGui_ImplOpenVR_ProcessOverlayEvent(const vr::VREvent_t& event)
             // Emulate physical mouse behaviour by only sending y-axis
             // VREvent_ScrollDiscrete sends discrete values [-1.0, 1.0]
             // VREvent_ScrollSmooth sends continuous values [-1.0, 1.0]
+            // Deltas add up until a button changes, ImGui would spread them over several frames otherwise
+            g_InputStats.events_received++;
             const float y = event.data.scroll.ydelta;
-            if (y != 0.0f)
-                io.AddMouseWheelEvent(0.0f, y);
+            if (y != 0.0f) {
+                pending->mouse_wheel += y;
+                pending->mouse_wheel_pending = true;
+            }
             break;
         }
         case vr::VREvent_KeyboardCharInput:
         {
+            g_InputStats.events_received++;
+            ImGui_ImplOpenVR_FlushOverlayEvents();
+
             // Some special inputs ie. Backspace, Enter, etc...
             // are not handled by AddInputCharactersUTF8
             // because it only allows UTF-8 character input
@@ -164,14 +245,12 @@ bool ImGui_ImplOpenVR_ProcessOverlayEvent(const vr::VREvent_t& event)
             {
                 case 8: // Backspace
                 {
-                    io.AddKeyEvent(ImGuiKey_Backspace, true);
-                    io.AddKeyEvent(ImGuiKey_Backspace, false);
+                    ImGui_ImplOpenVR_AddKeyPress(io, ImGuiKey_Backspace);
                     break;
                 }
                 case 10: // Enter
                 {
-                    io.AddKeyEvent(ImGuiKey_Enter, true);
-                    io.AddKeyEvent(ImGuiKey_Enter, false);
+                    ImGui_ImplOpenVR_AddKeyPress(io, ImGuiKey_Enter);
                     vr::VROverlay()->HideKeyboard();
                     break;
                 }
@@ -182,26 +261,22 @@ bool ImGui_ImplOpenVR_ProcessOverlayEvent(const vr::VREvent_t& event)
                     {
                     case 68:
                     {
-                        io.AddKeyEvent(ImGuiKey_LeftArrow, true);
-                        io.AddKeyEvent(ImGuiKey_LeftArrow, false);
+                        ImGui_ImplOpenVR_AddKeyPress(io, ImGuiKey_LeftArrow);
                         break;
                     }
                     case 67:
                     {
-                        io.AddKeyEvent(ImGuiKey_RightArrow, true);
-                        io.AddKeyEvent(ImGuiKey_RightArrow, false);
+                        ImGui_ImplOpenVR_AddKeyPress(io, ImGuiKey_RightArrow);
                         break;
                     }
                     case 65:
                     {
-                        io.AddKeyEvent(ImGuiKey_UpArrow, true);
-                        io.AddKeyEvent(ImGuiKey_UpArrow, false);
+                        ImGui_ImplOpenVR_AddKeyPress(io, ImGuiKey_UpArrow);
                         break;
                     }
                     case 66:
                     {
-                        io.AddKeyEvent(ImGuiKey_DownArrow, true);
-                        io.AddKeyEvent(ImGuiKey_DownArrow, false);
+                        ImGui_ImplOpenVR_AddKeyPress(io, ImGuiKey_DownArrow);
                         break;
                     }
                     }
@@ -210,6 +285,7 @@ bool ImGui_ImplOpenVR_ProcessOverlayEvent(const vr::VREvent_t& event)
                 default:
                 {
                     io.AddInputCharactersUTF8(event.data.keyboard.cNewInput);
+                    g_InputStats.events_forwarded++;
                     break;
                 }
             }
@@ -222,9 +298,10 @@ bool ImGui_ImplOpenVR_ProcessOverlayEvent(const vr::VREvent_t& event)
 
             // let's check when VREvent_KeyboardClosed_Global is sent is our keyboard is still shown
             // this may happen because the dashboard or overlay was closed when the keyboard was open
-            if (event.data.keyboard.overlayHandle == bd->handle && bd->keyboard_active) {
-                io.AddKeyEvent(ImGuiKey_Enter, true);
-                io.AddKeyEvent(ImGuiKey_Enter, false);
+            if (bd != nullptr && event.data.keyboard.overlayHandle == bd->handle && bd->keyboard_active) {
+                g_InputStats.events_received++;
+                ImGui_ImplOpenVR_FlushOverlayEvents();
+                ImGui_ImplOpenVR_AddKeyPress(io, ImGuiKey_Enter);
                 vr::VROverlay()->HideKeyboard();
             }
             break;
@@ -234,14 +311,54 @@ bool ImGui_ImplOpenVR_ProcessOverlayEvent(const vr::VREvent_t& event)
     return true;
 }
 
+void ImGui_ImplOpenVR_FlushOverlayEvents()
+{
+    ImGui_ImplOpenVR_Data* bd = ImGui_ImplOpenVR_GetBackendData();
+    ImGui_ImplOpenVR_PendingInput* pending = ImGui_ImplOpenVR_GetPendingInput();
+    ImGuiIO& io = ImGui::GetIO();
+
+    // Position first so the wheel goes to what is under the laser now
+    if (pending->mouse_pos_pending) {
+        // OpenGL uses coordinate space Bottom Left == 0,0 where as Vulkan is Top Left == 0,0
+        // So we need to flip the y-axis against the overlay this context draws, our own size when we own the context
+        const float height = bd != nullptr ? (float)bd->height : io.DisplaySize.y;
+        io.AddMousePosEvent(pending->mouse_pos.x, height - pending->mouse_pos.y);
+        g_InputStats.events_forwarded++;
+    }
+
+    // Scrolling back and forth within a frame can add up to nothing
+    if (pending->mouse_wheel_pending && pending->mouse_wheel != 0.0f) {
+        io.AddMouseWheelEvent(0.0f, pending->mouse_wheel);
+        g_InputStats.events_forwarded++;
+    }
+
+    pending->mouse_pos_pending = false;
+    pending->mouse_wheel_pending = false;
+    pending->mouse_wheel = 0.0f;
+}
+
+ImGui_ImplOpenVR_InputStats ImGui_ImplOpenVR_GetInputStats()
+{
+    return g_InputStats;
+}
+
 void ImGui_ImplOpenVR_Shutdown()
 {
     ImGui_ImplOpenVR_Data* bd = ImGui_ImplOpenVR_GetBackendData();
     IM_ASSERT(bd != nullptr && "Context or backend not initialized! Did you call ImGui_ImplOpenVR_Init()?");
 
+    // Anything still held back belongs to the context going away
+    ImGuiContext* context = ImGui::GetCurrentContext();
+    for (int i = 0; i < g_PendingInputs.Size; i++) {
+        if (g_PendingInputs[i].context == context) {
+            g_PendingInputs.erase(g_PendingInputs.begin() + i);
+            break;
+        }
+    }
+
     ImGuiIO& io = ImGui::GetIO();
-    io.BackendRendererName = nullptr;
-    io.BackendRendererUserData = nullptr;
+    io.BackendPlatformName = nullptr;
+    io.BackendPlatformUserData = nullptr;
     IM_DELETE(bd);
 }
 
@@ -274,11 +391,13 @@ void ImGui_ImplOpenVR_NewFrame()
 
     ImGuiIO& io = ImGui::GetIO();
 
+    ImGui_ImplOpenVR_FlushOverlayEvents();
+
     if (!io.WantTextInput) {
         bd->keyboard_active = false;
     }
 
-    if (vr::VROverlay()->IsOverlayVisible(bd->handle) && !bd->keyboard_active && io.WantTextInput) {
+    if (bd->visible && !bd->keyboard_active && io.WantTextInput) {
         vr::VROverlay()->ShowKeyboardForOverlay(bd->handle, vr::k_EGamepadTextInputModeNormal, vr::k_EGamepadTextInputLineModeSingleLine, vr::KeyboardFlag_Minimal | vr::KeyboardFlag_HideDoneKey | vr::KeyboardFlag_ShowArrowKeys, "ImGui OpenVR Virtual Keyboard", 1, "", 0);
         bd->keyboard_active = true;
     }
@@ -286,8 +405,11 @@ void ImGui_ImplOpenVR_NewFrame()
     io.DisplaySize = ImVec2(bd->width, bd->height);
     if (bd->width > 0 && bd->height > 0) {
         io.DisplayFramebufferScale = ImVec2(1, 1);
-        bd->mouse_scale = { io.DisplaySize.x, io.DisplaySize.y };
-        vr::VROverlay()->SetOverlayMouseScale(bd->handle, &bd->mouse_scale);
+        // Only told to the compositor when it changes
+        if (bd->mouse_scale.v[0] != io.DisplaySize.x || bd->mouse_scale.v[1] != io.DisplaySize.y) {
+            bd->mouse_scale = { io.DisplaySize.x, io.DisplaySize.y };
+            vr::VROverlay()->SetOverlayMouseScale(bd->handle, &bd->mouse_scale);
+        }
     }
 
     io.DeltaTime = ImGui_ImplOpenVR_GetDeltaTime();
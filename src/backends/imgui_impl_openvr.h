@@ -4,6 +4,7 @@
 // Implemented features:
 //  [X] Platform: Virtual keyboard support
 //  [X] Platform: Mouse emulation
+//  [X] Platform: Mouse moves and scrolling coalesced between button transitions
 // Missing features or Issues:
 //  [ ] Platform: Touch Emulation
 
@@ -31,9 +32,20 @@ struct ImGui_ImplOpenVR_InitInfo
 	int height;
 };
 
+struct ImGui_ImplOpenVR_InputStats
+{
+	uint64_t events_received;	// input events passed to ImGui_ImplOpenVR_ProcessOverlayEvent
+	uint64_t events_forwarded;	// input events queued into ImGui
+};
+
 // Follow "Getting Started" link and check examples/ folder to learn about using backends!
 IMGUI_IMPL_API bool     ImGui_ImplOpenVR_Init(ImGui_ImplOpenVR_InitInfo* initInfo);
 IMGUI_IMPL_API bool		ImGui_ImplOpenVR_ProcessOverlayEvent(const vr::VREvent_t& event);
+// Queues the mouse position and wheel held back by ImGui_ImplOpenVR_ProcessOverlayEvent, called by ImGui_ImplOpenVR_NewFrame()
+// Call it yourself after the last event of a frame when feeding overlay events into a context owned by another platform backend
+IMGUI_IMPL_API void     ImGui_ImplOpenVR_FlushOverlayEvents();
+// Summed over every context
+IMGUI_IMPL_API ImGui_ImplOpenVR_InputStats ImGui_ImplOpenVR_GetInputStats();
 IMGUI_IMPL_API void     ImGui_ImplOpenVR_Shutdown();
 IMGUI_IMPL_API void     ImGui_ImplOpenVR_NewFrame();
 